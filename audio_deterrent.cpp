@@ -1,5 +1,79 @@
 #include "audio_deterrent.h"
-#include <math.h>
+#include "audio_timer.h"
+
+AudioDeterrent *AudioDeterrent::activeInstance = nullptr;
+
+// Pattern bank, indexed by AudioPattern. Being constexpr it is placed in
+// flash and needs no initialisation at startup.
+static constexpr AudioPatternConfig audioPatternBank[] = {
+    {AUDIO_OFF, "Off", {}, 0, 0, 0, 0.0, false, {}, 0},
+    {CROW_DISTRESS, "Crow Distress",
+     {{800, 0.8, 0, 500, 650, SWEEP_EXPONENTIAL}, {1200, 0.6, 0, 300, 1000, SWEEP_EXPONENTIAL}, {600, 0.9, 0, 400, 500, SWEEP_LINEAR}},
+     3, 3, 1000, 0.7, false, {15, 80, 0.7, 60}, 0},
+    {EAGLE_DISTRESS, "Eagle Distress",
+     {{1800, 0.9, 0, 800, 2400, SWEEP_EXPONENTIAL}, {1200, 0.7, 0, 600, 1600, SWEEP_EXPONENTIAL}, {2200, 0.8, 0, 500, 1700, SWEEP_EXPONENTIAL}},
+     3, 2, 2000, 0.8, false, {20, 0, 1.0, 80}, 0},
+    {HAWK_SCREECH, "Hawk Screech",
+     {{2800, 1.0, 0, 1200, 1900, SWEEP_EXPONENTIAL}, {2200, 0.6, 0, 800, 1600, SWEEP_EXPONENTIAL}},
+     2, 4, 1500, 0.75, false, {30, 150, 0.8, 200}, 0},
+    {GENERAL_ALARM, "General Alarm",
+     {{1000, 0.8, 0, 200, 0, SWEEP_NONE}, {1500, 0.8, 0, 200, 0, SWEEP_NONE}, {2000, 0.8, 0, 200, 0, SWEEP_NONE}},
+     3, 10, 500, 0.6, false, {5, 0, 1.0, 5}, 0},
+    {ULTRASONIC_SWEEP, "Ultrasonic Sweep",
+     {{17000, 0.5, 0, 1000, 20000, SWEEP_LINEAR}, {20000, 0.5, 0, 1000, 24000, SWEEP_LINEAR}, {24000, 0.5, 0, 1000, 17000, SWEEP_LINEAR}},
+     3, 5, 200, 0.4, true, {20, 0, 1.0, 20}, 30},
+    {PREDATOR_GROWL, "Predator Growl",
+     {{150, 0.9, 0, 2000, 120, SWEEP_EXPONENTIAL}, {80, 0.7, 0, 1500, 100, SWEEP_LINEAR}, {200, 0.8, 0, 1000, 140, SWEEP_EXPONENTIAL}},
+     3, 2, 3000, 0.8, false, {200, 300, 0.7, 400}, 0},
+    {EMERGENCY_SIREN, "Emergency Siren",
+     {{800, 1.0, 0, 300, 1200, SWEEP_LINEAR}, {1200, 1.0, 0, 300, 800, SWEEP_LINEAR}},
+     2, 999, 0, 0.9, false, {10, 0, 1.0, 10}, 20}};
+
+// Bank validation. Single-expression recursion keeps these valid C++11
+// constexpr for the Arduino toolchain.
+static constexpr bool frequencyValid(float frequency, bool ultrasonic)
+{
+    return frequency > 0 && frequency < AUDIO_SAMPLE_RATE_HZ / 2 && (!ultrasonic || frequency >= ULTRASONIC_BASE_FREQ);
+}
+
+static constexpr bool componentValid(const FrequencyComponent &component, bool ultrasonic)
+{
+    return frequencyValid(component.frequency, ultrasonic) && component.amplitude >= 0.0 &&
+           component.amplitude <= 1.0 && component.duration > 0 &&
+           (component.sweep == SWEEP_NONE || frequencyValid(component.endFrequency, ultrasonic));
+}
+
+static constexpr bool envelopeValid(const AudioEnvelope &envelope)
+{
+    return envelope.attackMs >= 0 && envelope.decayMs >= 0 && envelope.releaseMs >= 0 &&
+           envelope.sustainLevel >= 0.0 && envelope.sustainLevel <= 1.0;
+}
+
+static constexpr bool componentsValid(const AudioPatternConfig &config, int index)
+{
+    return index >= config.frequencyCount ||
+           (componentValid(config.frequencies[index], config.isUltrasonic) && componentsValid(config, index + 1));
+}
+
+static constexpr bool patternValid(const AudioPatternConfig &config, int index)
+{
+    return config.patternId == index && config.frequencyCount >= 0 && config.frequencyCount <= MAX_FREQUENCY_SWEEP &&
+           (config.frequencyCount == 0 || config.repeatCount > 0) &&
+           config.pauseDuration >= 0 && config.baseVolume >= 0.0 && config.baseVolume <= 1.0 &&
+           envelopeValid(config.envelope) && config.crossfadeMs >= 0 && componentsValid(config, 0);
+}
+
+static constexpr bool bankValid(int index)
+{
+    return index >= MAX_AUDIO_PATTERNS || (patternValid(audioPatternBank[index], index) && bankValid(index + 1));
+}
+
+static_assert(sizeof(audioPatternBank) / sizeof(audioPatternBank[0]) == MAX_AUDIO_PATTERNS,
+              "Audio pattern bank must have one entry per AudioPattern");
+static_assert(bankValid(0), "Audio pattern bank has an out-of-range entry");
+static_assert(MAX_FREQUENCY_SWEEP * 4 <= DDS_MAX_SEGMENTS, "Each component compiles to up to four DDS segments");
+static_assert(AUDIO_PWM_CARRIER_HZ >= 2 * AUDIO_SAMPLE_RATE_HZ,
+              "PWM carrier must sit well above the sample rate so the output filter removes it");
 
 AudioDeterrent::AudioDeterrent()
 {
@@ -10,11 +84,15 @@ AudioDeterrent::AudioDeterrent()
     currentFrequencyIndex = 0;
     systemEnabled = true;
     environmentNoise = 0.0;
+    directionalGain = 1.0;
     volumeLimiting = false;
     lastPatternRotation = 0;
     patternRotationIndex = 0;
-    bufferIndex = 0;
-    sampleRate = 8000;
+    sampleRate = AUDIO_SAMPLE_RATE_HZ;
+    sampleClockRunning = false;
+    calibrationSamples = 0;
+    calibrationTotal = 0.0;
+    audioTestActive = false;
 
     audioChannel.pwmPin = -1;
     audioChannel.enablePin = -1;
@@ -23,11 +101,6 @@ AudioDeterrent::AudioDeterrent()
     audioChannel.isActive = false;
     audioChannel.lastUpdate = 0;
     audioChannel.temperature = 25.0;
-
-    for (int i = 0; i < AUDIO_BUFFER_SIZE; i++)
-    {
-        audioBuffer[i] = 0.0;
-    }
 }
 
 bool AudioDeterrent::begin(int pwmPin, int enablePin)
@@ -40,10 +113,16 @@ bool AudioDeterrent::begin(int pwmPin, int enablePin)
     pinMode(pwmPin, OUTPUT);
     pinMode(enablePin, OUTPUT);
 
-    analogWrite(pwmPin, 0);
     digitalWrite(enablePin, LOW);
+    if (AudioPwmOutput::begin(pwmPin) > 0)
+    {
+        Serial.print("Audio PWM carrier: ");
+        Serial.print(AudioPwmOutput::getCarrierHz());
+        Serial.println(" Hz");
+    }
 
-    initializeAudioPatterns();
+    activeInstance = this;
+    synth.begin(sampleRate);
 
     calibrateEnvironmentNoise();
 
@@ -53,32 +132,17 @@ bool AudioDeterrent::begin(int pwmPin, int enablePin)
     return true;
 }
 
-void AudioDeterrent::initializeAudioPatterns()
+void AudioDeterrent::update()
 {
-    Serial.println("Initializing audio patterns...");
-
-    // Pattern 0: Off
-    patterns[0] = {AUDIO_OFF, "Off", {}, 0, 0, 0, 0.0, false};
-
-    patterns[1] = {CROW_DISTRESS, "Crow Distress", {{800, 0.8, 0, 500}, {1200, 0.6, 0, 300}, {600, 0.9, 0, 400}}, 3, 3, 1000, 0.7, false};
+    serviceCalibration();
 
-    patterns[2] = {EAGLE_DISTRESS, "Eagle Distress", {{1800, 0.9, 0, 800}, {1200, 0.7, 0, 600}, {2200, 0.8, 0, 500}}, 3, 2, 2000, 0.8, false};
-
-    patterns[3] = {HAWK_SCREECH, "Hawk Screech", {{2500, 1.0, 0, 1200}, {1800, 0.6, 0, 800}}, 2, 4, 1500, 0.75, false};
-
-    patterns[4] = {GENERAL_ALARM, "General Alarm", {{1000, 0.8, 0, 200}, {1500, 0.8, 0, 200}, {2000, 0.8, 0, 200}}, 3, 10, 500, 0.6, false};
-
-    patterns[5] = {ULTRASONIC_SWEEP, "Ultrasonic Sweep", {{17000, 0.5, 0, 1000}, {20000, 0.5, 0, 1000}, {24000, 0.5, 0, 1000}}, 3, 5, 200, 0.4, true};
-
-    patterns[6] = {PREDATOR_GROWL, "Predator Growl", {{150, 0.9, 0, 2000}, {80, 0.7, 0, 1500}, {200, 0.8, 0, 1000}}, 3, 2, 3000, 0.8, false};
-
-    patterns[7] = {EMERGENCY_SIREN, "Emergency Siren", {{800, 1.0, 0, 300}, {1200, 1.0, 0, 300}}, 2, 999, 0, 0.9, false};
-
-    Serial.println("Audio patterns initialized successfully");
-}
+    if (audioTestActive)
+    {
+        if (!synth.isFinished())
+            return;
+        finishAudioTest();
+    }
 
-void AudioDeterrent::update()
-{
     if (!systemEnabled)
         return;
 
@@ -99,9 +163,10 @@ void AudioDeterrent::update()
         lastPatternRotation = currentTime;
     }
 
-    if (currentTime % 5000 == 0)
+    if (adaptTimer.expired() && !calibrationTimer.isArmed())
     {
         adaptToEnvironment();
+        adaptTimer.advance(ENVIRONMENT_ADAPT_INTERVAL_MS);
     }
 }
 
@@ -110,66 +175,127 @@ void AudioDeterrent::generateAudioWaveform()
     if (currentPattern == AUDIO_OFF)
         return;
 
-    AudioPatternConfig *pattern = &patterns[currentPattern];
-    unsigned long currentTime = millis();
-    unsigned long elapsed = currentTime - patternStartTime;
-
-    if (currentFrequencyIndex < pattern->frequencyCount)
+    // Samples are produced by the synthesizer at the sample clock; the main
+    // loop only follows its progress through the pattern
+    if (!sampleClockRunning && audioChannel.isActive)
     {
-        FrequencyComponent *freq = &pattern->frequencies[currentFrequencyIndex];
-
-        if (elapsed < freq->duration)
-        {
-
-            synthesizeFrequency(freq->frequency, freq->amplitude, freq->duration);
-        }
-        else
-        {
+        AudioPwmOutput::write(synth.nextSample());
+    }
 
-            currentFrequencyIndex++;
-            if (currentFrequencyIndex >= pattern->frequencyCount)
-            {
+    currentFrequencyIndex = synth.getSegmentTag();
+    patternCycle = synth.getCyclesDone();
 
-                patternCycle++;
-                currentFrequencyIndex = 0;
-                patternStartTime = currentTime;
+    if (synth.isFinished())
+    {
+        stopSampleClock();
+        currentPattern = AUDIO_OFF;
+        currentMode = AUDIO_STANDBY;
+    }
+}
 
-                if (patternCycle >= pattern->repeatCount && pattern->repeatCount != 999)
-                {
+void AudioDeterrent::sampleInterrupt()
+{
+    AudioDeterrent *audio = activeInstance;
+    if (audio == nullptr)
+        return;
 
-                    delay(pattern->pauseDuration);
-                    currentPattern = AUDIO_OFF;
-                    currentMode = AUDIO_STANDBY;
-                }
-            }
-        }
+    uint8_t sample = audio->synth.nextSample();
+    if (audio->audioChannel.isActive)
+    {
+        AudioPwmOutput::write(sample);
     }
 }
 
-void AudioDeterrent::synthesizeFrequency(float frequency, float amplitude, float duration)
+void AudioDeterrent::startSampleClock()
 {
-    static unsigned long lastSampleTime = 0;
-    unsigned long currentTime = micros();
+    if (!sampleClockRunning)
+    {
+        sampleClockRunning = AudioSampleTimer::start(sampleRate, &AudioDeterrent::sampleInterrupt);
+    }
+}
 
-    if (currentTime - lastSampleTime >= (1000000 / sampleRate))
+void AudioDeterrent::stopSampleClock()
+{
+    if (sampleClockRunning)
     {
+        AudioSampleTimer::stop();
+        sampleClockRunning = false;
+    }
+}
 
-        float phase = (2.0 * PI * frequency * (currentTime / 1000000.0));
-        float sample = amplitude * sin(phase);
+float AudioDeterrent::componentFrequencyAt(const FrequencyComponent &component, float fraction)
+{
+    if (component.sweep == SWEEP_NONE || component.endFrequency <= 0.0)
+        return component.frequency;
 
-        audioBuffer[bufferIndex] = sample;
-        bufferIndex = (bufferIndex + 1) % AUDIO_BUFFER_SIZE;
+    if (component.sweep == SWEEP_EXPONENTIAL)
+        return component.frequency * pow(component.endFrequency / component.frequency, fraction);
 
-        int pwmValue = (int)((sample + 1.0) * 127.5);
-        pwmValue = constrain(pwmValue, 0, 255);
+    return component.frequency + (component.endFrequency - component.frequency) * fraction;
+}
 
-        if (audioChannel.isActive)
+void AudioDeterrent::compilePattern(AudioPattern pattern, DdsProgram &program)
+{
+    const AudioPatternConfig &config = audioPatternBank[pattern];
+    const AudioEnvelope &envelope = config.envelope;
+
+    // Each component becomes attack / decay / sustain / release segments;
+    // with a crossfade the release glides into the next component instead
+    program.segmentCount = 0;
+    for (int i = 0; i < config.frequencyCount; i++)
+    {
+        const FrequencyComponent &component = config.frequencies[i];
+        uint8_t firstSegment = program.segmentCount;
+        bool exponential = component.sweep == SWEEP_EXPONENTIAL;
+        bool glideIn = config.crossfadeMs > 0 && i > 0;
+        bool glideOut = config.crossfadeMs > 0 && i + 1 < config.frequencyCount;
+
+        uint32_t total = max(synth.millisToSamples(component.duration), (uint32_t)1);
+        uint32_t attack = glideIn ? 0 : synth.millisToSamples(envelope.attackMs);
+        uint32_t decay = synth.millisToSamples(envelope.decayMs);
+        uint32_t release = synth.millisToSamples(glideOut ? config.crossfadeMs : envelope.releaseMs);
+
+        // Components shorter than their envelope squeeze it proportionally
+        uint32_t envelopeSamples = attack + decay + release;
+        if (envelopeSamples > total)
+        {
+            attack = (uint64_t)attack * total / envelopeSamples;
+            decay = (uint64_t)decay * total / envelopeSamples;
+            release = (uint64_t)release * total / envelopeSamples;
+        }
+        uint32_t sustain = total - attack - decay - release;
+
+        float peak = component.amplitude;
+        float held = envelope.decayMs > 0 ? peak * envelope.sustainLevel : peak;
+        uint32_t t1 = attack;
+        uint32_t t2 = t1 + decay;
+        uint32_t t3 = t2 + sustain;
+        float f0 = componentFrequencyAt(component, 0.0);
+        float f1 = componentFrequencyAt(component, (float)t1 / total);
+        float f2 = componentFrequencyAt(component, (float)t2 / total);
+        float f3 = componentFrequencyAt(component, (float)t3 / total);
+
+        synth.appendSegment(program, f0, f1, exponential, 0.0, peak, attack);
+        synth.appendSegment(program, f1, f2, exponential, peak, held, decay);
+        synth.appendSegment(program, f2, f3, exponential, held, held, sustain);
+        if (glideOut)
         {
-            analogWrite(audioChannel.pwmPin, pwmValue);
+            const FrequencyComponent &next = config.frequencies[i + 1];
+            synth.appendSegment(program, f3, componentFrequencyAt(next, 0.0), false, held, next.amplitude, release);
+        }
+        else
+        {
+            synth.appendSegment(program, f3, componentFrequencyAt(component, 1.0), exponential, held, 0.0, release);
         }
 
-        lastSampleTime = currentTime;
+        for (int segment = firstSegment; segment < program.segmentCount; segment++)
+        {
+            program.segments[segment].tag = i;
+        }
     }
+
+    program.repeatCount = config.repeatCount == 999 ? DDS_REPEAT_FOREVER : config.repeatCount;
+    program.tailSamples = synth.millisToSamples(config.pauseDuration);
 }
 
 void AudioDeterrent::updateAudioOutput()
@@ -188,16 +314,20 @@ void AudioDeterrent::updateAudioOutput()
         }
     }
 
-    if (audioChannel.currentVolume > 0.01 && !audioChannel.isActive)
+    // Volume is what the pattern and environment ask for; the targeting
+    // gain decides how much of it goes out
+    float drive = audioChannel.currentVolume * directionalGain;
+
+    if (drive > 0.01 && !audioChannel.isActive)
     {
         digitalWrite(audioChannel.enablePin, HIGH);
         audioChannel.isActive = true;
         Serial.println("Audio amplifier enabled");
     }
-    else if (audioChannel.currentVolume <= 0.01 && audioChannel.isActive)
+    else if (drive <= 0.01 && audioChannel.isActive)
     {
         digitalWrite(audioChannel.enablePin, LOW);
-        analogWrite(audioChannel.pwmPin, 0);
+        AudioPwmOutput::write(0);
         audioChannel.isActive = false;
         Serial.println("Audio amplifier disabled");
     }
@@ -210,6 +340,8 @@ void AudioDeterrent::updateAudioOutput()
     {
         audioChannel.temperature = max(25.0, audioChannel.temperature - 0.05); // Cool down
     }
+
+    synth.setVolume((uint8_t)(constrain(drive, 0.0, 1.0) * 255));
 }
 
 void AudioDeterrent::playDistressCalls()
@@ -233,324 +365,434 @@ void AudioDeterrent::playDistressCalls()
         setPattern(HAWK_SCREECH);
     }
 
-    audioChannel.targetVolume = patterns[currentPattern].baseVolume;
+    audioChannel.targetVolume = audioPatternBank[currentPattern].baseVolume;
 }
 
 void AudioDeterrent::playEmergencySignals()
 {
     Serial.println("Audio Deterrent: Playing emergency signals");
     currentMode = AUDIO_EMERGENCY;
+    directionalGain = 1.0;
     setPattern(EMERGENCY_SIREN);
     audioChannel.targetVolume = 0.9;
+}
 
-    void AudioDeterrent::playUltrasonicDeterrent()
-    {
-        if (!systemEnabled)
-            return;
+void AudioDeterrent::playUltrasonicDeterrent()
+{
+    if (!systemEnabled)
+        return;
+
+    Serial.println("Audio Deterrent: Playing ultrasonic deterrent");
+    currentMode = AUDIO_ACTIVE;
+    setPattern(ULTRASONIC_SWEEP);
+    audioChannel.targetVolume = audioPatternBank[currentPattern].baseVolume;
+}
+
+void AudioDeterrent::stop()
+{
+    Serial.println("Audio Deterrent: Stopping");
+    currentMode = AUDIO_STANDBY;
+    currentPattern = AUDIO_OFF;
+    audioChannel.targetVolume = 0.0;
+    patternCycle = 0;
+    currentFrequencyIndex = 0;
+
+    synth.silence();
+    stopSampleClock();
+}
 
-        Serial.println("Audio Deterrent: Playing ultrasonic deterrent");
-        currentMode = AUDIO_ACTIVE;
-        setPattern(ULTRASONIC_SWEEP);
-        audioChannel.targetVolume = patterns[currentPattern].baseVolume;
+void AudioDeterrent::setVolume(float volume)
+{
+    float constrainedVolume = constrain(volume, 0.0, 1.0);
+
+    if (isVolumeWithinLimits())
+    {
+        audioChannel.targetVolume = constrainedVolume;
+    }
+    else
+    {
+        Serial.println("WARNING: Volume limited for safety");
+        volumeLimiting = true;
+        audioChannel.targetVolume = 0.6;
     }
+}
 
-    void AudioDeterrent::stop()
+void AudioDeterrent::setPattern(AudioPattern pattern)
+{
+    if (pattern >= 0 && pattern < MAX_AUDIO_PATTERNS)
     {
-        Serial.println("Audio Deterrent: Stopping");
-        currentMode = AUDIO_STANDBY;
-        currentPattern = AUDIO_OFF;
-        audioChannel.targetVolume = 0.0;
+        currentPattern = pattern;
+        patternStartTime = millis();
         patternCycle = 0;
         currentFrequencyIndex = 0;
-    }
 
-    void AudioDeterrent::setVolume(float volume)
-    {
-        float constrainedVolume = constrain(volume, 0.0, 1.0);
+        // A pattern request supersedes the start-up test tone
+        audioTestActive = false;
 
-        if (isVolumeWithinLimits())
+        compilePattern(pattern, *synth.editProgram());
+        synth.commitProgram();
+        if (pattern != AUDIO_OFF)
         {
-            audioChannel.targetVolume = constrainedVolume;
-        }
-        else
-        {
-            Serial.println("WARNING: Volume limited for safety");
-            volumeLimiting = true;
-            audioChannel.targetVolume = 0.6;
+            startSampleClock();
         }
+
+        Serial.print("Audio pattern changed to: ");
+        Serial.println(audioPatternBank[pattern].name);
     }
+}
 
-    void AudioDeterrent::setPattern(AudioPattern pattern)
-    {
-        if (pattern >= 0 && pattern < MAX_AUDIO_PATTERNS)
-        {
-            currentPattern = pattern;
-            patternStartTime = millis();
-            patternCycle = 0;
-            currentFrequencyIndex = 0;
+void AudioDeterrent::applyVolumeControl()
+{
 
-            Serial.println("Audio pattern changed to: " + patterns[pattern].name);
-        }
+    float noiseCompensation = environmentNoise * 0.3;
+    float adjustedVolume = audioChannel.targetVolume + noiseCompensation;
+
+    if (adjustedVolume > 0.85)
+    {
+        volumeLimiting = true;
+    }
+    else
+    {
+        volumeLimiting = false;
     }
 
-    void AudioDeterrent::applyVolumeControl()
+    if (audioChannel.temperature > 60.0)
     {
+        adjustedVolume *= 0.7;
+    }
 
-        float noiseCompensation = environmentNoise * 0.3;
-        float adjustedVolume = audioChannel.targetVolume + noiseCompensation;
+    audioChannel.currentVolume = adjustedVolume;
+}
 
-        if (adjustedVolume > 0.85)
-        {
-            volumeLimiting = true;
-        }
-        else
-        {
-            volumeLimiting = false;
-        }
+void AudioDeterrent::rotatePatterns()
+{
+    if (currentMode != AUDIO_ACTIVE)
+        return;
 
-        if (audioChannel.temperature > 60.0)
-        {
-            adjustedVolume *= 0.7;
-        }
+    AudioPattern rotationPatterns[] = {CROW_DISTRESS, EAGLE_DISTRESS, HAWK_SCREECH, GENERAL_ALARM};
+    int rotationCount = sizeof(rotationPatterns) / sizeof(AudioPattern);
 
-        audioChannel.currentVolume = adjustedVolume;
-    }
+    patternRotationIndex = (patternRotationIndex + 1) % rotationCount;
+    AudioPattern newPattern = rotationPatterns[patternRotationIndex];
 
-    void AudioDeterrent::rotatePatterns()
+    if (isPatternEffective(newPattern))
     {
-        if (currentMode != AUDIO_ACTIVE)
-            return;
+        setPattern(newPattern);
+        Serial.print("Pattern rotated to prevent habituation: ");
+        Serial.println(audioPatternBank[newPattern].name);
+    }
+}
 
-        AudioPattern rotationPatterns[] = {CROW_DISTRESS, EAGLE_DISTRESS, HAWK_SCREECH, GENERAL_ALARM};
-        int rotationCount = sizeof(rotationPatterns) / sizeof(AudioPattern);
+void AudioDeterrent::calibrateEnvironmentNoise()
+{
+    Serial.println("Calibrating environment noise baseline...");
+
+    // The first reading stands in until the averaged baseline is ready;
+    // the remaining samples are taken from update()
+    calibrationTotal = readEnvironmentNoise();
+    calibrationSamples = 1;
+    environmentNoise = calibrationTotal;
+    calibrationTimer.start(NOISE_CALIBRATION_INTERVAL_MS);
+}
 
-        patternRotationIndex = (patternRotationIndex + 1) % rotationCount;
-        AudioPattern newPattern = rotationPatterns[patternRotationIndex];
+void AudioDeterrent::serviceCalibration()
+{
+    if (!calibrationTimer.expired())
+        return;
 
-        if (isPatternEffective(newPattern))
-        {
-            setPattern(newPattern);
-            Serial.println("Pattern rotated to prevent habituation: " + patterns[newPattern].name);
-        }
-    }
+    calibrationTotal += readEnvironmentNoise();
+    calibrationSamples++;
 
-    void AudioDeterrent::calibrateEnvironmentNoise()
+    if (calibrationSamples < NOISE_CALIBRATION_SAMPLES)
     {
-        Serial.println("Calibrating environment noise baseline...");
-
-        float totalNoise = 0;
-        int samples = 50;
+        calibrationTimer.advance(NOISE_CALIBRATION_INTERVAL_MS);
+        return;
+    }
 
-        for (int i = 0; i < samples; i++)
-        {
-            float noise = readEnvironmentNoise();
-            totalNoise += noise;
-            delay(100);
-        }
+    calibrationTimer.cancel();
+    environmentNoise = calibrationTotal / calibrationSamples;
+    adaptTimer.start(ENVIRONMENT_ADAPT_INTERVAL_MS);
+    Serial.print("Environment noise baseline: ");
+    Serial.print(environmentNoise * 100);
+    Serial.println("%");
+}
 
-        environmentNoise = totalNoise / samples;
-        Serial.println("Environment noise baseline: " + String(environmentNoise * 100) + "%");
-    }
+bool AudioDeterrent::isCalibrating()
+{
+    return calibrationTimer.isArmed();
+}
 
-    float AudioDeterrent::readEnvironmentNoise()
-    {
+float AudioDeterrent::readEnvironmentNoise()
+{
 
-        int noiseReading = analogRead(A1);
-        return noiseReading / 1023.0;
-    }
+    int noiseReading = analogRead(A1);
+    return noiseReading / 1023.0;
+}
 
-    void AudioDeterrent::adaptToEnvironment()
-    {
-        float currentNoise = readEnvironmentNoise();
+void AudioDeterrent::adaptToEnvironment()
+{
+    float currentNoise = readEnvironmentNoise();
 
-        environmentNoise = (environmentNoise * 0.9) + (currentNoise * 0.1);
+    environmentNoise = (environmentNoise * 0.9) + (currentNoise * 0.1);
 
-        if (currentMode == AUDIO_ACTIVE)
+    if (currentMode == AUDIO_ACTIVE)
+    {
+        if (environmentNoise > 0.7)
         {
-            if (environmentNoise > 0.7)
-            {
 
-                if (currentPattern != HAWK_SCREECH && currentPattern != EMERGENCY_SIREN)
-                {
-                    setPattern(HAWK_SCREECH);
-                }
-            }
-            else if (environmentNoise < 0.3)
+            if (currentPattern != HAWK_SCREECH && currentPattern != EMERGENCY_SIREN)
             {
+                setPattern(HAWK_SCREECH);
+            }
+        }
+        else if (environmentNoise < 0.3)
+        {
 
-                if (currentPattern != CROW_DISTRESS)
-                {
-                    setPattern(CROW_DISTRESS);
-                }
+            if (currentPattern != CROW_DISTRESS)
+            {
+                setPattern(CROW_DISTRESS);
             }
         }
     }
+}
 
-    bool AudioDeterrent::isVolumeWithinLimits()
-    {
+bool AudioDeterrent::isVolumeWithinLimits()
+{
 
-        float estimatedDB = audioChannel.targetVolume * MAX_VOLUME_DB;
-        return estimatedDB <= MAX_VOLUME_DB;
-    }
+    float estimatedDB = audioChannel.targetVolume * MAX_VOLUME_DB;
+    return estimatedDB <= MAX_VOLUME_DB;
+}
+
+bool AudioDeterrent::isPatternEffective(AudioPattern pattern)
+{
 
-    bool AudioDeterrent::isPatternEffective(AudioPattern pattern)
+    if (audioPatternBank[pattern].isUltrasonic && environmentNoise > 0.8)
     {
+        return false;
+    }
 
-        if (patterns[pattern].isUltrasonic && environmentNoise > 0.8)
-        {
-            return false;
-        }
+    return true;
+}
 
-        return true;
+void AudioDeterrent::setEnabled(bool enabled)
+{
+    systemEnabled = enabled;
+    if (!enabled)
+    {
+        stop();
     }
+}
+
+bool AudioDeterrent::isEnabled()
+{
+    return systemEnabled;
+}
 
-    void AudioDeterrent::setEnabled(bool enabled)
+bool AudioDeterrent::selfTest()
+{
+    Serial.println("Performing audio deterrent self-test...");
+
+    bool testPassed = true;
+
+    Serial.print("Testing amplifier enable... ");
+    digitalWrite(audioChannel.enablePin, HIGH);
+    delay(100);
+    if (digitalRead(audioChannel.enablePin) == HIGH)
     {
-        systemEnabled = enabled;
-        if (!enabled)
-        {
-            stop();
-        }
+        Serial.println("PASS");
     }
-
-    bool AudioDeterrent::isEnabled()
+    else
     {
-        return systemEnabled;
+        Serial.println("FAIL");
+        testPassed = false;
     }
 
-    bool AudioDeterrent::selfTest()
+    Serial.print("Testing PWM output... ");
+    AudioPwmOutput::write(128);
+    delay(500);
+    AudioPwmOutput::write(0);
+    Serial.println("COMPLETE");
+
+    Serial.print("Testing audio patterns... ");
+    for (int i = 1; i < 4; i++)
     {
-        Serial.println("Performing audio deterrent self-test...");
+        setPattern((AudioPattern)i);
+        audioChannel.targetVolume = 0.3;
+        delay(1000);
+        stop();
+        delay(200);
+    }
+    Serial.println("COMPLETE");
 
-        bool testPassed = true;
+    digitalWrite(audioChannel.enablePin, LOW);
 
-        Serial.print("Testing amplifier enable... ");
-        digitalWrite(audioChannel.enablePin, HIGH);
-        delay(100);
-        if (digitalRead(audioChannel.enablePin) == HIGH)
-        {
-            Serial.println("PASS");
-        }
-        else
-        {
-            Serial.println("FAIL");
-            testPassed = false;
-        }
+    if (testPassed)
+    {
+        Serial.println("Audio deterrent self-test PASSED");
+    }
+    else
+    {
+        Serial.println("Audio deterrent self-test FAILED");
+    }
 
-        Serial.print("Testing PWM output... ");
-        analogWrite(audioChannel.pwmPin, 128);
-        delay(500);
-        analogWrite(audioChannel.pwmPin, 0);
-        Serial.println("COMPLETE");
+    return testPassed;
+}
 
-        Serial.print("Testing audio patterns... ");
-        for (int i = 1; i < 4; i++)
-        {
-            setPattern((AudioPattern)i);
-            audioChannel.targetVolume = 0.3;
-            delay(1000);
-            stop();
-            delay(200);
-        }
-        Serial.println("COMPLETE");
+void AudioDeterrent::performAudioTest()
+{
+    Serial.println("Performing audio initialization test...");
 
-        digitalWrite(audioChannel.enablePin, LOW);
+    // Brief test tone: 800, 1000 and 1200 Hz for 200 ms each
+    DdsProgram *program = synth.editProgram();
+    program->segmentCount = 0;
+    for (int i = 0; i < 3; i++)
+    {
+        float frequency = 800 + i * 200;
+        synth.appendSegment(*program, frequency, frequency, false, 1.0, 1.0, synth.millisToSamples(200));
+    }
+    program->repeatCount = 1;
+    program->tailSamples = 0;
+    synth.commitProgram();
+    synth.setVolume(255);
 
-        if (testPassed)
-        {
-            Serial.println("Audio deterrent self-test PASSED");
-        }
-        else
-        {
-            Serial.println("Audio deterrent self-test FAILED");
-        }
+    digitalWrite(audioChannel.enablePin, HIGH);
+    audioChannel.isActive = true;
+    audioTestActive = true;
+    startSampleClock();
 
-        return testPassed;
+    // The synthesizer ends the program by itself and update() tidies up;
+    // without a sample clock there is nothing to wait for
+    if (!sampleClockRunning)
+    {
+        finishAudioTest();
     }
+}
 
-    void AudioDeterrent::performAudioTest()
-    {
-        Serial.println("Performing audio initialization test...");
+void AudioDeterrent::finishAudioTest()
+{
+    audioTestActive = false;
 
-        // Brief test tone
-        digitalWrite(audioChannel.enablePin, HIGH);
+    stopSampleClock();
+    synth.silence();
+    audioChannel.isActive = false;
+    AudioPwmOutput::write(0);
+    digitalWrite(audioChannel.enablePin, LOW);
 
-        for (int freq = 800; freq <= 1200; freq += 200)
-        {
-            for (int i = 0; i < 20; i++)
-            {
-                float sample = sin(2.0 * PI * freq * i / 20.0);
-                int pwmValue = (int)((sample + 1.0) * 127.5);
-                analogWrite(audioChannel.pwmPin, pwmValue);
-                delay(10);
-            }
-        }
+    Serial.println("Audio test completed");
+}
 
-        analogWrite(audioChannel.pwmPin, 0);
-        digitalWrite(audioChannel.enablePin, LOW);
+AudioMode AudioDeterrent::getCurrentMode()
+{
+    return currentMode;
+}
 
-        Serial.println("Audio test completed");
-    }
+const AudioPatternConfig *AudioDeterrent::getPatternConfig(AudioPattern pattern)
+{
+    if (pattern < 0 || pattern >= MAX_AUDIO_PATTERNS)
+        return nullptr;
 
-    AudioMode AudioDeterrent::getCurrentMode()
-    {
-        return currentMode;
-    }
+    return &audioPatternBank[pattern];
+}
 
-    String AudioDeterrent::getModeString()
-    {
-        switch (currentMode)
-        {
-        case AUDIO_DISABLED:
-            return "DISABLED";
-        case AUDIO_STANDBY:
-            return "STANDBY";
-        case AUDIO_ACTIVE:
-            return "ACTIVE";
-        case AUDIO_EMERGENCY:
-            return "EMERGENCY";
-        default:
-            return "UNKNOWN";
-        }
-    }
+unsigned long AudioDeterrent::getSampleRate()
+{
+    return sampleRate;
+}
 
-    float AudioDeterrent::getCurrentVolume()
-    {
-        return audioChannel.currentVolume;
+const char *AudioDeterrent::getModeString()
+{
+    switch (currentMode)
+    {
+    case AUDIO_DISABLED:
+        return "DISABLED";
+    case AUDIO_STANDBY:
+        return "STANDBY";
+    case AUDIO_ACTIVE:
+        return "ACTIVE";
+    case AUDIO_EMERGENCY:
+        return "EMERGENCY";
+    default:
+        return "UNKNOWN";
     }
+}
 
-    float AudioDeterrent::getAmplifierTemperature()
-    {
-        return audioChannel.temperature;
-    }
+float AudioDeterrent::getCurrentVolume()
+{
+    return audioChannel.currentVolume;
+}
 
-    bool AudioDeterrent::isVolumeLimited()
-    {
-        return volumeLimiting;
-    }
+// Scales output for the speaker's share of the current threat. Ignored in
+// emergency, which always runs at full output.
+void AudioDeterrent::setDirectionalGain(float gain)
+{
+    if (currentMode == AUDIO_EMERGENCY)
+        return;
+    directionalGain = constrain(gain, 0.0, 1.0);
+}
 
-    void AudioDeterrent::emergencyStop()
+// What actually reaches the amplifier, 0 to 1
+float AudioDeterrent::getOutputLevel()
+{
+    return audioChannel.isActive ? constrain(audioChannel.currentVolume * directionalGain, 0.0, 1.0) : 0.0;
+}
+
+float AudioDeterrent::getAmplifierTemperature()
+{
+    return audioChannel.temperature;
+}
+
+bool AudioDeterrent::isVolumeLimited()
+{
+    return volumeLimiting;
+}
+
+void AudioDeterrent::emergencyStop()
+{
+    Serial.println("Audio Deterrent: EMERGENCY STOP");
+    stop();
+    systemEnabled = false;
+    digitalWrite(audioChannel.enablePin, LOW);
+    AudioPwmOutput::write(0);
+}
+
+void AudioDeterrent::printStatusReport(Print &out)
+{
+    out.println("=== AUDIO DETERRENT STATUS ===");
+    out.print("Mode: ");
+    out.println(getModeString());
+    out.print("Pattern: ");
+    out.println(audioPatternBank[currentPattern].name);
+    out.print("Volume: ");
+    out.print(audioChannel.currentVolume * 100);
+    out.println("%");
+    out.print("PWM Carrier: ");
+    if (AudioPwmOutput::getCarrierHz() > 0)
+    {
+        out.print(AudioPwmOutput::getCarrierHz());
+        out.println(" Hz");
+    }
+    else
     {
-        Serial.println("Audio Deterrent: EMERGENCY STOP");
-        stop();
-        systemEnabled = false;
-        digitalWrite(audioChannel.enablePin, LOW);
-        analogWrite(audioChannel.pwmPin, 0);
-    }
-
-    String AudioDeterrent::getStatusReport()
-    {
-        String report = "=== AUDIO DETERRENT STATUS ===\n";
-        report += "Mode: " + getModeString() + "\n";
-        report += "Pattern: " + patterns[currentPattern].name + "\n";
-        report += "Volume: " + String(audioChannel.currentVolume * 100) + "%\n";
-        report += "System Enabled: " + String(systemEnabled ? "YES" : "NO") + "\n";
-        report += "Volume Limited: " + String(volumeLimiting ? "YES" : "NO") + "\n";
-        report += "Amplifier Active: " + String(audioChannel.isActive ? "YES" : "NO") + "\n";
-        report += "Amplifier Temp: " + String(audioChannel.temperature) + "°C\n";
-        report += "Environment Noise: " + String(environmentNoise * 100) + "%\n";
-        report += "Pattern Cycle: " + String(patternCycle) + "\n";
-        report += "Frequency Index: " + String(currentFrequencyIndex) + "\n";
-        report += "===============================\n";
-        return report;
-    }
\ No newline at end of file
+        out.println("analogWrite");
+    }
+    out.print("Directional Gain: ");
+    out.print(directionalGain * 100);
+    out.println("%");
+    out.print("System Enabled: ");
+    out.println(systemEnabled ? "YES" : "NO");
+    out.print("Volume Limited: ");
+    out.println(volumeLimiting ? "YES" : "NO");
+    out.print("Amplifier Active: ");
+    out.println(audioChannel.isActive ? "YES" : "NO");
+    out.print("Amplifier Temp: ");
+    out.print(audioChannel.temperature);
+    out.println("°C");
+    out.print("Environment Noise: ");
+    out.print(environmentNoise * 100);
+    out.println("%");
+    out.print("Pattern Cycle: ");
+    out.println(patternCycle);
+    out.print("Frequency Index: ");
+    out.println(currentFrequencyIndex);
+    out.println("===============================");
+}
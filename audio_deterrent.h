@@ -3,6 +3,8 @@
 #define AUDIO_DETERRENT_H
 
 #include <Arduino.h>
+#include "dds_synth.h"
+#include "deadline_timer.h"
 
 #define MAX_AUDIO_PATTERNS 8
 #define MAX_FREQUENCY_SWEEP 5
@@ -11,6 +13,13 @@
 #define ULTRASONIC_BASE_FREQ 17000
 #define AUDIBLE_BASE_FREQ 1000
 #define PATTERN_ROTATION_TIME 30000
+#define NOISE_CALIBRATION_SAMPLES 50
+#define NOISE_CALIBRATION_INTERVAL_MS 100
+#define ENVIRONMENT_ADAPT_INTERVAL_MS 5000
+
+#ifndef AUDIO_SAMPLE_RATE_HZ
+#define AUDIO_SAMPLE_RATE_HZ 62500 // Nyquist above the 24 kHz sweep; 48 MHz / 768
+#endif
 
 enum AudioPattern
 {
@@ -32,24 +41,45 @@ enum AudioMode
   AUDIO_EMERGENCY = 3
 };
 
+enum FrequencySweep
+{
+  SWEEP_NONE = 0,
+  SWEEP_LINEAR = 1,
+  SWEEP_EXPONENTIAL = 2
+};
+
 struct FrequencyComponent
 {
   float frequency;
   float amplitude;
   float phase;
   unsigned long duration;
+  float endFrequency; // Chirp target; 0 holds frequency for the whole component
+  FrequencySweep sweep;
+};
+
+// Applied to every component of a pattern. With decayMs 0 the level holds
+// at the component amplitude after the attack.
+struct AudioEnvelope
+{
+  int attackMs;
+  int decayMs;
+  float sustainLevel; // Fraction of the component amplitude
+  int releaseMs;
 };
 
 struct AudioPatternConfig
 {
   AudioPattern patternId;
-  String name;
+  const char *name;
   FrequencyComponent frequencies[MAX_FREQUENCY_SWEEP];
   int frequencyCount;
   int repeatCount;
   int pauseDuration;
   float baseVolume;
   bool isUltrasonic;
+  AudioEnvelope envelope;
+  int crossfadeMs; // Glide into the next component instead of releasing to silence
 };
 
 struct AudioChannel
@@ -69,24 +99,33 @@ private:
   AudioChannel audioChannel;
   AudioMode currentMode;
   AudioPattern currentPattern;
-  AudioPatternConfig patterns[MAX_AUDIO_PATTERNS];
   unsigned long patternStartTime;
   int patternCycle;
   int currentFrequencyIndex;
   bool systemEnabled;
   float environmentNoise;
+  float directionalGain; // From the targeting stage; 0 keeps the amplifier off
   bool volumeLimiting;
   unsigned long lastPatternRotation;
   int patternRotationIndex;
 
-  float audioBuffer[AUDIO_BUFFER_SIZE];
-  int bufferIndex;
+  DdsSynthesizer synth;
   unsigned long sampleRate;
+  bool sampleClockRunning;
+
+  DeadlineTimer calibrationTimer;
+  int calibrationSamples;
+  float calibrationTotal;
+  DeadlineTimer adaptTimer;
+  bool audioTestActive;
+
+  static AudioDeterrent *activeInstance;
+  static void sampleInterrupt();
 
-  void initializeAudioPatterns();
   void generateAudioWaveform();
   void updateAudioOutput();
-  void synthesizeFrequency(float frequency, float amplitude, float duration);
+  void startSampleClock();
+  void stopSampleClock();
   void synthesizeDistressCall(AudioPattern pattern);
   void synthesizeUltrasonicSweep();
   void synthesizePredatorSound();
@@ -94,7 +133,12 @@ private:
   void applyVolumeControl();
   void rotatePatterns();
   bool isVolumeWithinLimits();
+  bool isPatternEffective(AudioPattern pattern);
+  void calibrateEnvironmentNoise();
+  void serviceCalibration();
+  void adaptToEnvironment();
   void performAudioTest();
+  void finishAudioTest();
 
 public:
   AudioDeterrent();
@@ -106,13 +150,23 @@ public:
   void stop();
   void setVolume(float volume);
   void setPattern(AudioPattern pattern);
+  void compilePattern(AudioPattern pattern, DdsProgram &program);
+  static float componentFrequencyAt(const FrequencyComponent &component, float fraction);
+  const AudioPatternConfig *getPatternConfig(AudioPattern pattern);
+  unsigned long getSampleRate();
   void setEnabled(bool enabled);
   bool isEnabled();
   bool selfTest();
   AudioMode getCurrentMode();
-  String getModeString();
+  const char *getModeString();
   float getCurrentVolume();
+  void setDirectionalGain(float gain);
+  float getOutputLevel();
   float getAmplifierTemperature();
   bool isVolumeLimited();
-  String getStatusReport();
-  void emergencyStop();
\ No newline at end of file
+  bool isCalibrating();
+  void printStatusReport(Print &out);
+  void emergencyStop();
+};
+
+#endif
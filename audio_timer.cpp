@@ -0,0 +1,155 @@
+#include "audio_timer.h"
+
+#ifdef SIM_HAL
+#include "SimHal.h"
+#endif
+
+#if defined(ARDUINO_ARCH_SAMD)
+#include "wiring_private.h"
+#endif
+
+void (*volatile AudioSampleTimer::callback)() = nullptr;
+bool AudioSampleTimer::running = false;
+
+bool AudioSampleTimer::start(uint32_t rateHz, void (*isr)())
+{
+    if (rateHz == 0 || isr == nullptr)
+        return false;
+
+    callback = isr;
+
+#if defined(ARDUINO_ARCH_SAMD)
+    GCLK->CLKCTRL.reg = (uint16_t)(GCLK_CLKCTRL_CLKEN | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_ID(GCM_TC4_TC5));
+    while (GCLK->STATUS.bit.SYNCBUSY)
+        ;
+
+    TC5->COUNT16.CTRLA.reg = TC_CTRLA_SWRST;
+    while (TC5->COUNT16.STATUS.reg & TC_STATUS_SYNCBUSY)
+        ;
+    while (TC5->COUNT16.CTRLA.bit.SWRST)
+        ;
+
+    TC5->COUNT16.CTRLA.reg = TC_CTRLA_MODE_COUNT16 | TC_CTRLA_WAVEGEN_MFRQ | TC_CTRLA_PRESCALER_DIV1;
+    TC5->COUNT16.CC[0].reg = (uint16_t)(SystemCoreClock / rateHz - 1);
+    while (TC5->COUNT16.STATUS.reg & TC_STATUS_SYNCBUSY)
+        ;
+
+    NVIC_DisableIRQ(TC5_IRQn);
+    NVIC_ClearPendingIRQ(TC5_IRQn);
+    NVIC_SetPriority(TC5_IRQn, 0);
+    NVIC_EnableIRQ(TC5_IRQn);
+
+    TC5->COUNT16.INTENSET.bit.MC0 = 1;
+    TC5->COUNT16.CTRLA.reg |= TC_CTRLA_ENABLE;
+    while (TC5->COUNT16.STATUS.reg & TC_STATUS_SYNCBUSY)
+        ;
+    running = true;
+#elif defined(SIM_HAL)
+    SimHal::attachTimer(rateHz, &AudioSampleTimer::handleInterrupt, SimHal::TIMER_AUDIO);
+    running = true;
+#else
+    running = false;
+#endif
+
+    return running;
+}
+
+void AudioSampleTimer::stop()
+{
+#if defined(ARDUINO_ARCH_SAMD)
+    TC5->COUNT16.CTRLA.reg &= ~TC_CTRLA_ENABLE;
+    while (TC5->COUNT16.STATUS.reg & TC_STATUS_SYNCBUSY)
+        ;
+    NVIC_DisableIRQ(TC5_IRQn);
+#elif defined(SIM_HAL)
+    SimHal::detachTimer(SimHal::TIMER_AUDIO);
+#endif
+    running = false;
+}
+
+bool AudioSampleTimer::isRunning()
+{
+    return running;
+}
+
+void AudioSampleTimer::handleInterrupt()
+{
+    void (*isr)() = callback;
+    if (isr != nullptr)
+    {
+        isr();
+    }
+}
+
+volatile uint32_t *AudioPwmOutput::compare = nullptr;
+int AudioPwmOutput::outputPin = -1;
+uint32_t AudioPwmOutput::carrierHz = 0;
+
+// Returns the carrier frequency, or 0 if samples go through analogWrite()
+uint32_t AudioPwmOutput::begin(int pin)
+{
+    outputPin = pin;
+    compare = nullptr;
+    carrierHz = 0;
+
+#if defined(ARDUINO_ARCH_SAMD)
+    const PinDescription &desc = g_APinDescription[pin];
+    uint32_t tcNum = GetTCNumber(desc.ulPWMChannel);
+    if ((desc.ulPinAttribute & PIN_ATTR_PWM) != PIN_ATTR_PWM || tcNum >= TCC_INST_NUM)
+    {
+        analogWrite(pin, 0);
+        return 0;
+    }
+
+    Tcc *tcc = (Tcc *)GetTC(desc.ulPWMChannel);
+    uint8_t channel = GetTCChannelNumber(desc.ulPWMChannel);
+    uint16_t clockId = tcNum < 2 ? GCM_TCC0_TCC1 : GCM_TCC2_TC3;
+
+    GCLK->CLKCTRL.reg = (uint16_t)(GCLK_CLKCTRL_CLKEN | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_ID(clockId));
+    while (GCLK->STATUS.bit.SYNCBUSY)
+        ;
+
+    tcc->CTRLA.reg = TCC_CTRLA_SWRST;
+    while (tcc->SYNCBUSY.bit.SWRST)
+        ;
+
+    tcc->CTRLA.reg = TCC_CTRLA_PRESCALER_DIV1;
+    tcc->WAVE.reg = TCC_WAVE_WAVEGEN_NPWM;
+    while (tcc->SYNCBUSY.bit.WAVE)
+        ;
+    tcc->PER.reg = AUDIO_PWM_TOP;
+    while (tcc->SYNCBUSY.bit.PER)
+        ;
+    tcc->CC[channel].reg = 0;
+    while (tcc->SYNCBUSY.reg & (TCC_SYNCBUSY_CC0 << channel))
+        ;
+    tcc->CTRLA.reg |= TCC_CTRLA_ENABLE;
+    while (tcc->SYNCBUSY.bit.ENABLE)
+        ;
+
+    pinPeripheral(pin, (desc.ulPinAttribute & PIN_ATTR_TIMER_ALT) ? PIO_TIMER_ALT : PIO_TIMER);
+
+    // The buffered register takes effect at the next period boundary, so a
+    // sample never cuts a PWM cycle short. A sample period is three carrier
+    // periods, long after the previous write has synchronised.
+    compare = &tcc->CCB[channel].reg;
+    carrierHz = SystemCoreClock / (AUDIO_PWM_TOP + 1);
+#else
+    analogWrite(pin, 0);
+#endif
+
+    return carrierHz;
+}
+
+uint32_t AudioPwmOutput::getCarrierHz()
+{
+    return carrierHz;
+}
+
+#if defined(ARDUINO_ARCH_SAMD)
+void TC5_Handler()
+{
+    AudioSampleTimer::handleInterrupt();
+    TC5->COUNT16.INTFLAG.bit.MC0 = 1;
+}
+#endif
@@ -0,0 +1,58 @@
+#ifndef AUDIO_TIMER_H
+#define AUDIO_TIMER_H
+
+#include <Arduino.h>
+
+#define AUDIO_PWM_CLOCK_HZ 48000000 // GCLK0
+#define AUDIO_PWM_TOP 255           // 8-bit samples: 48 MHz / 256 = 187.5 kHz carrier
+#define AUDIO_PWM_CARRIER_HZ (AUDIO_PWM_CLOCK_HZ / (AUDIO_PWM_TOP + 1))
+
+// Sample-rate interrupt for audio output. On SAMD boards this is TC5 in
+// match-frequency mode; the host simulation uses the SimHal virtual timer.
+// start() returns false where no timer backend exists, in which case the
+// caller has to emit samples from the main loop instead.
+class AudioSampleTimer
+{
+private:
+    static void (*volatile callback)();
+    static bool running;
+
+public:
+    static bool start(uint32_t rateHz, void (*isr)());
+    static void stop();
+    static bool isRunning();
+    static void handleInterrupt();
+};
+
+// Sample output for the sample-clock interrupt. On SAMD boards begin()
+// takes over the TCC behind the pin and runs it as 8-bit single-slope PWM
+// at AUDIO_PWM_CARRIER_HZ, well above twice the highest tone, and write()
+// is one store to the buffered compare register. No other pin on that TCC
+// may be used with analogWrite(), which would reconfigure it. Elsewhere,
+// and on pins without a TCC, write() falls back to analogWrite().
+class AudioPwmOutput
+{
+private:
+    static volatile uint32_t *compare;
+    static int outputPin;
+    static uint32_t carrierHz;
+
+public:
+    static uint32_t begin(int pin);
+    static uint32_t getCarrierHz();
+
+    static inline void write(uint8_t sample)
+    {
+        volatile uint32_t *cc = compare;
+        if (cc != nullptr)
+        {
+            *cc = sample;
+        }
+        else
+        {
+            analogWrite(outputPin, sample);
+        }
+    }
+};
+
+#endif
@@ -2,58 +2,83 @@
 
 #include "bird_detection.h"
 
-BirdDetection::BirdDetection()
+BirdDetection::BirdDetection() : tracker(detectedBirds, MAX_BIRDS)
 {
+    sensorCount = 0;
+    ambientTemperature = 20.0;
+    ringReportMask = 0;
+    ringRefreshCount = 0;
     activeBirdCount = 0;
     closestBirdDistance = 9999.0;
     systemEnabled = true;
     lastUpdate = 0;
-
-    for (int i = 0; i < MAX_BIRDS; i++)
-    {
-        detectedBirds[i].distance = 9999.0;
-        detectedBirds[i].azimuth = 0.0;
-        detectedBirds[i].lastDistance = 9999.0;
-        detectedBirds[i].lastSeen = 0;
-        detectedBirds[i].velocity = 0.0;
-        detectedBirds[i].confirmed = false;
-        detectedBirds[i].confidenceLevel = 0;
-    }
+    lastUpdateCallUs = 0;
+    maxUpdateGapUs = 0;
+    updateGapArmed = false;
 }
 
 bool BirdDetection::begin(int trig1, int echo1, int trig2, int echo2, int trig3, int echo3)
+{
+    const SensorMount mounts[DEFAULT_SENSOR_COUNT] = {
+        {trig1, echo1, 0.0, SENSOR_DEFAULT_BEAM_WIDTH_DEG, 0.0},   // Front
+        {trig2, echo2, 270.0, SENSOR_DEFAULT_BEAM_WIDTH_DEG, 0.0}, // Left
+        {trig3, echo3, 90.0, SENSOR_DEFAULT_BEAM_WIDTH_DEG, 0.0}}; // Right
+
+    return begin(mounts, DEFAULT_SENSOR_COUNT);
+}
+
+bool BirdDetection::begin(const SensorMount *mounts, int count)
 {
     Serial.println("Initializing Bird Detection System...");
 
-    sensors[0].trigPin = trig1;
-    sensors[0].echoPin = echo1;
-    sensors[0].sensorActive = true;
-    pinMode(trig1, OUTPUT);
-    pinMode(echo1, INPUT);
-
-    sensors[1].trigPin = trig2;
-    sensors[1].echoPin = echo2;
-    sensors[1].sensorActive = true;
-    pinMode(trig2, OUTPUT);
-    pinMode(echo2, INPUT);
-
-    sensors[2].trigPin = trig3;
-    sensors[2].echoPin = echo3;
-    sensors[2].sensorActive = true;
-    pinMode(trig3, OUTPUT);
-    pinMode(echo3, INPUT);
-
-    for (int i = 0; i < SENSOR_COUNT; i++)
+    if (count <= 0 || count > MAX_SENSORS)
+    {
+        Serial.print("ERROR: Unsupported sensor count: ");
+        Serial.println(count);
+        return false;
+    }
+
+    sensorCount = count;
+    int trigPins[MAX_SENSORS];
+    int echoPins[MAX_SENSORS];
+
+    for (int i = 0; i < sensorCount; i++)
     {
+        trigPins[i] = mounts[i].trigPin;
+        echoPins[i] = mounts[i].echoPin;
+
+        sensors[i].trigPin = mounts[i].trigPin;
+        sensors[i].echoPin = mounts[i].echoPin;
+        sensors[i].azimuth = mounts[i].azimuth;
+        sensors[i].beamWidth = mounts[i].beamWidth;
+        sensors[i].rangeOffset = mounts[i].rangeOffset;
+        sensors[i].sensorActive = true;
         sensors[i].lastDistance = 9999.0;
         sensors[i].historyIndex = 0;
         sensors[i].lastReading = 0;
+        sensors[i].medianFilter.reset();
         for (int j = 0; j < DETECTION_HISTORY_SIZE; j++)
         {
             sensors[i].distanceHistory[j] = 9999.0;
         }
     }
 
+    if (!ranging.begin(trigPins, echoPins, sensorCount))
+    {
+        Serial.println("ERROR: Ultrasonic ranging engine failed to initialize");
+        return false;
+    }
+
+    firingScheduler.build(mounts, sensorCount);
+    applyRangingTiming();
+    Serial.print("Sensor array: ");
+    Serial.print(sensorCount);
+    Serial.print(" sensors in ");
+    Serial.print(firingScheduler.getGroupCount());
+    Serial.print(" firing groups, ");
+    Serial.print(firingScheduler.getSlotUs());
+    Serial.println("us slots");
+
     calibrateSensors();
 
     Serial.println("Bird Detection System initialized successfully");
@@ -62,33 +87,147 @@ bool BirdDetection::begin(int trig1, int echo1, int trig2, int echo2, int trig3,
 
 void BirdDetection::update()
 {
+    // Watchdog-style probe: anything that blocks the caller between polls
+    // shows up here as a long gap
+    unsigned long callUs = micros();
+    if (updateGapArmed && callUs - lastUpdateCallUs > maxUpdateGapUs)
+    {
+        maxUpdateGapUs = callUs - lastUpdateCallUs;
+    }
+    lastUpdateCallUs = callUs;
+    updateGapArmed = true;
+
     if (!systemEnabled)
         return;
 
     unsigned long currentTime = millis();
 
-    for (int i = 0; i < SENSOR_COUNT; i++)
+    // Only drain what the echo interrupts have already measured; never wait on a ping
+    ranging.serviceTimeouts();
+
+    unsigned long nowUs = micros();
+    TrackMeasurement pending[RANGING_QUEUE_SIZE];
+    int pendingCount = 0;
+
+    RangingMeasurement measurement;
+    while (ranging.popMeasurement(measurement))
     {
-        if (currentTime - sensors[i].lastReading > (50 + i * 20))
+        float distance = convertEchoToDistance(measurement.echoWidthUs);
+        noteSensorReported(measurement.sensorIndex);
+
+        if (distance > 0)
         {
-            float distance = readUltrasonicDistance(i);
+            int sensorIndex = measurement.sensorIndex;
+            filterNoise(sensorIndex, distance + sensors[sensorIndex].rangeOffset);
 
-            if (distance > 0)
+            if (isValidBirdSignature(sensors[sensorIndex].lastDistance) && pendingCount < RANGING_QUEUE_SIZE)
             {
-                filterNoise(i, distance);
-                sensors[i].lastReading = currentTime;
+                pending[pendingCount].range = sensors[sensorIndex].lastDistance;
+                pending[pendingCount].azimuth = calculateAzimuth(sensorIndex);
+                pending[pendingCount].sensorIndex = sensorIndex;
+                long ageUs = (long)(nowUs - measurement.timestampUs);
+                pending[pendingCount].timestamp = currentTime - (ageUs > 0 ? ageUs / 1000 : 0);
+                pendingCount++;
             }
         }
     }
 
+    tracker.update(pending, pendingCount, currentTime);
+
+    scheduleRanging(currentTime);
+
     if (currentTime - lastUpdate > 100)
     {
+        tracker.removeStaleTracks(currentTime);
         updateBirdTracking();
-        removeStaleDetections();
         lastUpdate = currentTime;
     }
 }
 
+void BirdDetection::scheduleRanging(unsigned long currentTime)
+{
+    // One firing group per TDMA slot. Groups are outside each other's
+    // crosstalk cone, and a slot lasts until the furthest audible echo of the
+    // previous ping has died out, so no ghost can land in the next window.
+    unsigned long nowUs = micros();
+    if (!firingScheduler.isSlotDue(nowUs) || ranging.isAnyBusy())
+        return;
+
+    int group = firingScheduler.beginSlot(nowUs);
+    int fired = 0;
+    for (int m = 0; m < firingScheduler.getGroupSize(group); m++)
+    {
+        int sensorIndex = firingScheduler.getGroupMember(group, m);
+        if (sensors[sensorIndex].sensorActive && ranging.trigger(sensorIndex))
+        {
+            sensors[sensorIndex].lastReading = currentTime;
+            fired++;
+        }
+    }
+    firingScheduler.recordPings(fired, nowUs);
+}
+
+void BirdDetection::applyRangingTiming()
+{
+    firingScheduler.configureTiming(RANGING_MAX_RANGE_CM, ambientTemperature);
+    ranging.setEchoTimeout(firingScheduler.getListenUs());
+}
+
+void BirdDetection::setAmbientTemperature(float temperatureC)
+{
+    // Speed of sound moves ~0.18% per degree; only retime on a real change
+    if (abs(temperatureC - ambientTemperature) < 1.0)
+        return;
+
+    ambientTemperature = temperatureC;
+    applyRangingTiming();
+}
+
+float BirdDetection::getPingRate()
+{
+    return firingScheduler.getAchievedPingRate();
+}
+
+unsigned long BirdDetection::getScanFrameUs()
+{
+    return firingScheduler.getFrameUs();
+}
+
+void BirdDetection::noteSensorReported(int sensorIndex)
+{
+    ringReportMask |= (1U << sensorIndex);
+
+    uint16_t activeMask = 0;
+    for (int i = 0; i < sensorCount; i++)
+    {
+        if (sensors[i].sensorActive)
+        {
+            activeMask |= (1U << i);
+        }
+    }
+
+    if ((ringReportMask & activeMask) == activeMask)
+    {
+        ringRefreshCount++;
+        ringReportMask = 0;
+    }
+}
+
+float BirdDetection::convertEchoToDistance(unsigned long echoWidthUs)
+{
+    if (echoWidthUs == 0)
+        return -1;
+
+    // Speed of sound in cm/us, halved for the round trip
+    float distance = echoWidthUs * (firingScheduler.getSpeedOfSound() / 10000.0) / 2.0;
+
+    if (distance < 2 || distance > RANGING_MAX_RANGE_CM)
+        return -1;
+
+    return distance;
+}
+
+// Blocking read, only used by selfTest() and calibrateSensors() outside the main loop
 float BirdDetection::readUltrasonicDistance(int sensorIndex)
 {
     if (!sensors[sensorIndex].sensorActive)
@@ -103,187 +242,247 @@ float BirdDetection::readUltrasonicDistance(int sensorIndex)
     delayMicroseconds(10);
     digitalWrite(trigPin, LOW);
 
-    unsigned long duration = pulseIn(echoPin, HIGH, 30000);
-
-    if (duration == 0)
-        return -1;
-
-    float distance = duration * 0.034 / 2.0;
+    unsigned long duration = pulseIn(echoPin, HIGH, firingScheduler.getListenUs());
 
-    if (distance < 2 || distance > 400)
-        return -1;
-
-    return distance;
+    return convertEchoToDistance(duration);
 }
 
 void BirdDetection::filterNoise(int sensorIndex, float rawDistance)
 {
+    SensorData *sensor = &sensors[sensorIndex];
 
-    sensors[sensorIndex].distanceHistory[sensors[sensorIndex].historyIndex] = rawDistance;
-    sensors[sensorIndex].historyIndex = (sensors[sensorIndex].historyIndex + 1) % DETECTION_HISTORY_SIZE;
+    sensor->distanceHistory[sensor->historyIndex] = rawDistance;
+    sensor->historyIndex = (sensor->historyIndex + 1) % DETECTION_HISTORY_SIZE;
 
-    float sortedDistances[NOISE_FILTER_SAMPLES];
-    int startIndex = (sensors[sensorIndex].historyIndex + DETECTION_HISTORY_SIZE - NOISE_FILTER_SAMPLES) % DETECTION_HISTORY_SIZE;
+    sensor->medianFilter.push(rawDistance);
+    sensor->lastDistance = sensor->medianFilter.median();
+}
 
-    for (int i = 0; i < NOISE_FILTER_SAMPLES; i++)
-    {
-        int index = (startIndex + i) % DETECTION_HISTORY_SIZE;
-        sortedDistances[i] = sensors[sensorIndex].distanceHistory[index];
-    }
+void BirdDetection::updateBirdTracking()
+{
+    closestBirdDistance = 9999.0;
+    activeBirdCount = 0;
 
-    for (int i = 0; i < NOISE_FILTER_SAMPLES - 1; i++)
+    for (int i = 0; i < tracker.getTrackCount(); i++)
     {
-        for (int j = 0; j < NOISE_FILTER_SAMPLES - i - 1; j++)
+        BirdObject *bird = tracker.getTrack(i);
+        if (bird->confirmed && bird->confidenceLevel > 30)
         {
-            if (sortedDistances[j] > sortedDistances[j + 1])
+            activeBirdCount++;
+            if (bird->distance < closestBirdDistance)
             {
-                float temp = sortedDistances[j];
-                sortedDistances[j] = sortedDistances[j + 1];
-                sortedDistances[j + 1] = temp;
+                closestBirdDistance = bird->distance;
             }
         }
     }
+}
 
-    float filteredDistance = sortedDistances[NOISE_FILTER_SAMPLES / 2];
-    sensors[sensorIndex].lastDistance = filteredDistance;
+bool BirdDetection::isValidBirdSignature(float distance)
+{
+    return distance >= MIN_BIRD_SIZE_CM && distance <= 500;
 }
 
-void BirdDetection::updateBirdTracking()
+float BirdDetection::calculateAzimuth(int sensorIndex)
 {
-    closestBirdDistance = 9999.0;
-    activeBirdCount = 0;
+    if (sensorIndex < 0 || sensorIndex >= sensorCount)
+        return 0.0;
 
-    for (int sensorIndex = 0; sensorIndex < SENSOR_COUNT; sensorIndex++)
-    {
-        float distance = sensors[sensorIndex].lastDistance;
+    return sensors[sensorIndex].azimuth;
+}
 
-        if (isValidBirdSignature(distance, sensors[sensorIndex].distanceHistory[0]))
-        {
-            float azimuth = calculateAzimuth(sensorIndex);
+bool BirdDetection::detectBirdMovement(int birdIndex)
+{
+    BirdObject *bird = tracker.getTrack(birdIndex);
+    if (bird == nullptr || !bird->confirmed)
+        return false;
 
-            bool matched = false;
+    return abs(bird->velocity) > BIRD_SPEED_THRESHOLD_MPS;
+}
 
-            for (int birdIndex = 0; birdIndex < MAX_BIRDS; birdIndex++)
-            {
-                if (detectedBirds[birdIndex].confirmed)
-                {
-
-                    float azimuthDiff = abs(detectedBirds[birdIndex].azimuth - azimuth);
-                    float distanceDiff = abs(detectedBirds[birdIndex].distance - distance);
-
-                    if (azimuthDiff < 30.0 && distanceDiff < distance * 0.2)
-                    { // 20% distance tolerance
-
-                        detectedBirds[birdIndex].lastDistance = detectedBirds[birdIndex].distance;
-                        detectedBirds[birdIndex].distance = distance;
-                        detectedBirds[birdIndex].azimuth = azimuth;
-                        detectedBirds[birdIndex].lastSeen = millis();
-
-                        unsigned long timeDiff = millis() - detectedBirds[birdIndex].lastSeen;
-                        if (timeDiff > 0)
-                        {
-                            float distanceChange = abs(detectedBirds[birdIndex].distance - detectedBirds[birdIndex].lastDistance);
-                            detectedBirds[birdIndex].velocity = (distanceChange / 100.0) / (timeDiff / 1000.0); // m/s
-                        }
-
-                        detectedBirds[birdIndex].confidenceLevel = min(100, detectedBirds[birdIndex].confidenceLevel + 10);
-                        matched = true;
-                        break;
-                    }
-                }
-            }
+bool BirdDetection::isBirdDetected(float maxRange)
+{
+    return systemEnabled && activeBirdCount > 0 && closestBirdDistance <= maxRange;
+}
 
-            if (!matched)
-            {
-                int newBirdIndex = findClosestFreeBirdSlot();
-                if (newBirdIndex != -1)
-                {
-                    detectedBirds[newBirdIndex].distance = distance;
-                    detectedBirds[newBirdIndex].azimuth = azimuth;
-                    detectedBirds[newBirdIndex].lastDistance = distance;
-                    detectedBirds[newBirdIndex].lastSeen = millis();
-                    detectedBirds[newBirdIndex].velocity = 0.0;
-                    detectedBirds[newBirdIndex].confirmed = true;
-                    detectedBirds[newBirdIndex].confidenceLevel = 20;
-                }
-            }
+int BirdDetection::getBirdCount()
+{
+    return activeBirdCount;
+}
+
+float BirdDetection::getClosestDistance()
+{
+    return closestBirdDistance;
+}
+
+BirdObject *BirdDetection::getBirdData(int index)
+{
+    return tracker.getTrack(index);
+}
+
+int BirdDetection::getTrackCount()
+{
+    return tracker.getTrackCount();
+}
+
+bool BirdDetection::selfTest()
+{
+    Serial.println("Performing bird detection self-test...");
+
+    bool testPassed = true;
+
+    for (int i = 0; i < sensorCount; i++)
+    {
+        Serial.print("Testing ultrasonic sensor ");
+        Serial.print(i + 1);
+        Serial.print("... ");
+
+        float distance = readUltrasonicDistance(i);
+        if (distance > 0)
+        {
+            Serial.print("PASS (");
+            Serial.print(distance);
+            Serial.println("cm)");
         }
+        else
+        {
+            Serial.println("NO ECHO");
+            testPassed = false;
+        }
+        delay(60);
+    }
+
+    if (testPassed)
+    {
+        Serial.println("Bird detection self-test PASSED");
     }
-    for (int i = 0; i < MAX_BIRDS; i++)
+    else
     {
-        if (detectedBirds[i].confirmed && detectedBirds[i].confidenceLevel > 30)
+        Serial.println("Bird detection self-test FAILED");
+    }
+
+    return testPassed;
+}
+
+void BirdDetection::calibrateSensors()
+{
+    Serial.println("Calibrating ultrasonic sensors...");
+
+    for (int i = 0; i < sensorCount; i++)
+    {
+        for (int sample = 0; sample < NOISE_FILTER_SAMPLES; sample++)
         {
-            activeBirdCount++;
-            if (detectedBirds[i].distance < closestBirdDistance)
+            float distance = readUltrasonicDistance(i);
+            if (distance > 0)
             {
-                closestBirdDistance = detectedBirds[i].distance;
+                filterNoise(i, distance + sensors[i].rangeOffset);
             }
+            delay(60);
         }
     }
+
+    Serial.println("Sensor calibration complete");
 }
 
-bool BirdDetection::isValidBirdSignature(float distance, float previousDistance)
+void BirdDetection::setEnabled(bool enabled)
 {
+    systemEnabled = enabled;
+    if (!enabled)
+    {
+        resetDetection();
+    }
+}
 
-    if (distance < MIN_BIRD_SIZE_CM || distance > 500)
-        return false;
-
-    float distanceChange = abs(distance - previousDistance);
+bool BirdDetection::isEnabled()
+{
+    return systemEnabled;
+}
 
-    if (distanceChange < 2.0)
-        return false;
+void BirdDetection::resetDetection()
+{
+    activeBirdCount = 0;
+    closestBirdDistance = 9999.0;
+    tracker.reset();
+}
 
-    if (distanceChange > 100.0)
-        return false;
+float BirdDetection::getBirdVelocity(int birdIndex)
+{
+    BirdObject *bird = tracker.getTrack(birdIndex);
+    if (bird == nullptr)
+        return 0.0;
 
-    return true;
+    return bird->velocity;
 }
 
-float BirdDetection::calculateAzimuth(int sensorIndex)
+int BirdDetection::getSensorCount()
 {
-
-    switch (sensorIndex)
-    {
-    case 0:
-        return 0.0; // Front
-    case 1:
-        return 270.0; // Left
-    case 2:
-        return 90.0; // Right
-    default:
-        return 0.0;
-    }
+    return sensorCount;
 }
 
-void BirdDetection::removeStaleDetections()
+int BirdDetection::getFiringGroupCount()
 {
-    unsigned long currentTime = millis();
+    return firingScheduler.getGroupCount();
+}
 
-    for (int i = 0; i < MAX_BIRDS; i++)
-    {
-        if (detectedBirds[i].confirmed)
-        {
+unsigned long BirdDetection::getMaxUpdateGapUs()
+{
+    return maxUpdateGapUs;
+}
 
-            if (currentTime - detectedBirds[i].lastSeen > 2000)
-            {
-                detectedBirds[i].confirmed = false;
-                detectedBirds[i].confidenceLevel = 0;
-            }
+void BirdDetection::resetUpdateGap()
+{
+    maxUpdateGapUs = 0;
+    updateGapArmed = false;
+}
 
-            else if (currentTime - detectedBirds[i].lastSeen > 500)
-            {
-                detectedBirds[i].confidenceLevel = max(0, detectedBirds[i].confidenceLevel - 5);
-                if (detectedBirds[i].confidenceLevel < 10)
-                {
-                    detectedBirds[i].confirmed = false;
-                }
-            }
-        }
-    }
+unsigned long BirdDetection::getRingRefreshCount()
+{
+    return ringRefreshCount;
 }
 
-int BirdDetection::findClosestFreeBirdSlot()
+void BirdDetection::printDetectionReport(Print &out)
 {
-    for (int i = 0; i < MAX_BIRDS; i++)
+    out.println("=== BIRD DETECTION STATUS ===");
+    out.print("System Enabled: ");
+    out.println(systemEnabled ? "YES" : "NO");
+    out.print("Active Birds: ");
+    out.println(activeBirdCount);
+    out.print("Closest Bird: ");
+    out.print(closestBirdDistance);
+    out.println("cm");
+    out.print("Ping Rate: ");
+    out.print(firingScheduler.getAchievedPingRate());
+    out.print("/s (max ");
+    out.print(firingScheduler.getTheoreticalPingRate());
+    out.println("/s)");
+
+    out.println("\nSensor Status:");
+    for (int i = 0; i < sensorCount; i++)
     {
-    if (!detectedB
\ No newline at end of file
+        out.print("Sensor ");
+        out.print(i + 1);
+        out.print(" (");
+        out.print(sensors[i].azimuth);
+        out.print("deg): ");
+        out.print(sensors[i].lastDistance);
+        out.print("cm ");
+        out.println(sensors[i].sensorActive ? "ACTIVE" : "INACTIVE");
+    }
+
+    out.println("\nTracks:");
+    for (int i = 0; i < tracker.getTrackCount(); i++)
+    {
+        BirdObject *bird = tracker.getTrack(i);
+        out.print("#");
+        out.print((int)bird->trackId);
+        out.print(": ");
+        out.print(bird->distance);
+        out.print("cm @ ");
+        out.print(bird->azimuth);
+        out.print("deg, closing ");
+        out.print(bird->velocity);
+        out.print("m/s");
+        out.println(bird->confirmed ? " CONFIRMED" : " TENTATIVE");
+    }
+
+    out.println("=============================");
+}
@@ -4,33 +4,35 @@
 #define BIRD_DETECTION_H
 
 #include <Arduino.h>
+#include "ultrasonic_ranging.h"
+#include "bird_tracker.h"
+#include "median_filter.h"
+#include "sensor_array.h"
 
+#ifndef MAX_BIRDS
 #define MAX_BIRDS 10
-#define SENSOR_COUNT 3
+#endif
+#define DEFAULT_SENSOR_COUNT 3
 #define DETECTION_HISTORY_SIZE 10
 #define MIN_BIRD_SIZE_CM 15
 #define MAX_BIRD_SIZE_CM 200
 #define BIRD_SPEED_THRESHOLD_MPS 2.0
-#define NOISE_FILTER_SAMPLES 5
-
-struct BirdObject
-{
-    float distance;
-    float azimuth;
-    float lastDistance;
-    unsigned long lastSeen;
-    float velocity;
-    bool confirmed;
-    int confidenceLevel;
-};
+#define DETECTION_UPDATE_GAP_LIMIT_US 10000 // Longest tolerable stall between update() calls
+#ifndef NOISE_FILTER_SAMPLES
+#define NOISE_FILTER_SAMPLES 5 // Odd; 15-31 for heavy rain clutter
+#endif
 
 struct SensorData
 {
     int trigPin;
     int echoPin;
+    float azimuth;
+    float beamWidth;
+    float rangeOffset;
     float lastDistance;
     float distanceHistory[DETECTION_HISTORY_SIZE];
     int historyIndex;
+    StreamingMedian<NOISE_FILTER_SAMPLES> medianFilter;
     unsigned long lastReading;
     bool sensorActive;
 };
@@ -38,37 +40,59 @@ struct SensorData
 class BirdDetection
 {
 private:
-    SensorData sensors[SENSOR_COUNT];
+    SensorData sensors[MAX_SENSORS];
+    int sensorCount;
+    UltrasonicRanging ranging;
+    SensorArrayScheduler firingScheduler;
+    float ambientTemperature;
+    uint16_t ringReportMask;
+    unsigned long ringRefreshCount;
     BirdObject detectedBirds[MAX_BIRDS];
+    BirdTracker tracker;
     int activeBirdCount;
     float closestBirdDistance;
     bool systemEnabled;
     unsigned long lastUpdate;
+    unsigned long lastUpdateCallUs;
+    unsigned long maxUpdateGapUs;
+    bool updateGapArmed;
 
     float readUltrasonicDistance(int sensorIndex);
-    bool isValidBirdSignature(float distance, float previousDistance);
+    float convertEchoToDistance(unsigned long echoWidthUs);
+    void scheduleRanging(unsigned long currentTime);
+    void applyRangingTiming();
+    void noteSensorReported(int sensorIndex);
+    bool isValidBirdSignature(float distance);
     void updateBirdTracking();
     void filterNoise(int sensorIndex, float rawDistance);
     float calculateAzimuth(int sensorIndex);
     bool detectBirdMovement(int birdIndex);
-    void removeStaleDetections();
-    int findClosestFreeBirdSlot();
 
 public:
     BirdDetection();
     bool begin(int trig1, int echo1, int trig2, int echo2, int trig3, int echo3);
+    bool begin(const SensorMount *mounts, int count);
     void update();
     bool isBirdDetected(float maxRange);
     int getBirdCount();
     float getClosestDistance();
     BirdObject *getBirdData(int index);
+    int getTrackCount();
     bool selfTest();
     void calibrateSensors();
     void setEnabled(bool enabled);
     bool isEnabled();
     void resetDetection();
     float getBirdVelocity(int birdIndex);
-    String getDetectionReport();
+    void setAmbientTemperature(float temperatureC);
+    float getPingRate();
+    unsigned long getScanFrameUs();
+    int getSensorCount();
+    int getFiringGroupCount();
+    unsigned long getRingRefreshCount();
+    unsigned long getMaxUpdateGapUs();
+    void resetUpdateGap();
+    void printDetectionReport(Print &out);
 };
 
 #endif
\ No newline at end of file
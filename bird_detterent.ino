@@ -1,18 +1,31 @@
 
 #include <WiFiNINA.h>
-#include <ArduinoJson.h>
 #include "bird_detection.h"
 #include "visual_deterrent.h"
 #include "audio_deterrent.h"
 #include "power_management.h"
 #include "weather_protection.h"
 #include "emergency_system.h"
+#include "task_scheduler.h"
+#include "perf_monitor.h"
+#include "telemetry_protocol.h"
+#include "telemetry_queue.h"
+#include "track_events.h"
+#include "deterrent_targeting.h"
+#include "threat_assessment.h"
+#include "system_state_machine.h"
+#include "heap_guard.h"
+#include "config.h"
 
 #define SYSTEM_VERSION "1.0.0"
 #define DEBUG_MODE true
-#define BIRD_DETECTION_RADIUS_M 100
-#define EMERGENCY_DISTANCE_M 20
-#define MAX_ACTIVATION_TIME_MS 30000
+#define DETECTION_POLL_INTERVAL_MS 5   // Ranging queue drain and next TDMA slot
+#define CONSOLE_POLL_INTERVAL_MS 100   // Serial command polling
+#define TELEMETRY_FLUSH_FREQUENCY_HZ 2 // Uplink batches; sampling runs at TELEMETRY_UPDATE_FREQUENCY_HZ
+#define TELEMETRY_FLUSH_MAX_BATCHES 2  // Per flush, bounds the catch-up rate after an outage
+#define TELEMETRY_FLUSH_HEADROOM 8     // Free slots kept during an outage for the next flush period
+#define TELEMETRY_PERF_INTERVAL_FLUSHES 2
+#define TRACK_EVENT_POLL_FREQUENCY_HZ 20 // Change detection for the per-track event stream
 
 #define LED_STROBE_PIN_1 2
 #define LED_STROBE_PIN_2 3
@@ -28,22 +41,44 @@
 #define TRIG_PIN_3 11
 #define ECHO_PIN_3 12
 
-enum SystemState
-{
-    STANDBY,
-    ALERT,
-    ACTIVE_DETERRENT,
-    EMERGENCY,
-    MAINTENANCE
-};
+// Ultrasonic ring: pins, boresight azimuth, beam width, offset from centre.
+// Hangar installs extend this table to 8-12 transducers.
+const SensorMount sensorRing[] = {
+    {TRIG_PIN_1, ECHO_PIN_1, 0.0, SENSOR_DEFAULT_BEAM_WIDTH_DEG, 0.0},   // Front
+    {TRIG_PIN_2, ECHO_PIN_2, 270.0, SENSOR_DEFAULT_BEAM_WIDTH_DEG, 0.0}, // Left
+    {TRIG_PIN_3, ECHO_PIN_3, 90.0, SENSOR_DEFAULT_BEAM_WIDTH_DEG, 0.0}}; // Right
+
+// Deterrent emitters, in driver channel order: boresight and full beam.
+// An expander's segments are taken as an even ring starting at the front.
+#if LED_EXPANDER_CHANNELS == 0
+const EmitterMount strobeSegments[] = {
+    {270.0, 180.0}, // LED_STROBE_PIN_1, left half
+    {90.0, 180.0}}; // LED_STROBE_PIN_2, right half
+#endif
+const EmitterMount speakerMounts[] = {
+    {0.0, 360.0}}; // Single omnidirectional horn on AUDIO_PWM_PIN
 
 SystemState currentState = STANDBY;
-unsigned long lastBirdDetection = 0;
-unsigned long activationStartTime = 0;
 bool systemEnabled = true;
 int birdCount = 0;
 float batteryVoltage = 0.0;
 float systemTemperature = 0.0;
+TaskScheduler scheduler;
+TelemetryEncoder telemetryEncoder;
+TelemetryQueue telemetryQueue;
+TelemetryBacklog telemetryBacklog;
+TrackEventStream trackEvents;
+DeterrentTargeting ledTargeting;
+DeterrentTargeting speakerTargeting;
+ThreatAssessment threatAssessment;
+SystemStateMachine stateMachine;
+
+#if LED_EXPANDER_CHANNELS > 0
+Tlc5947LedDriver ledDriver(LED_EXPANDER_SPI, LED_EXPANDER_SPI_HZ, LED_EXPANDER_LATCH_PIN, LED_EXPANDER_CHANNELS);
+#else
+const int strobePins[] = {LED_STROBE_PIN_1, LED_STROBE_PIN_2};
+PwmPinLedDriver ledDriver(strobePins, sizeof(strobePins) / sizeof(strobePins[0]));
+#endif
 
 BirdDetection birdDetector;
 VisualDeterrent visualSystem;
@@ -62,7 +97,8 @@ void setup()
     while (!Serial && millis() < 5000)
         ;
     Serial.println("=== Drone Bird Deterrent System ===");
-    Serial.println("Version: " + String(SYSTEM_VERSION));
+    Serial.print("Version: ");
+    Serial.println(SYSTEM_VERSION);
     Serial.println("Initializing...");
 
     pinMode(STATUS_LED_PIN, OUTPUT);
@@ -71,6 +107,8 @@ void setup()
     pinMode(AUDIO_PWM_PIN, OUTPUT);
     pinMode(AUDIO_ENABLE_PIN, OUTPUT);
 
+    registerTasks();
+
     if (!initializeComponents())
     {
         Serial.println("CRITICAL: Component initialization failed!");
@@ -82,71 +120,172 @@ void setup()
 
     Serial.println("System initialized successfully");
     Serial.println("Entering STANDBY mode");
+    stateMachine.begin(STANDBY, millis());
     digitalWrite(STATUS_LED_PIN, HIGH);
 
     // Initial system status
     printSystemStatus();
+
+    scheduler.start();
+
+    // Everything is allocated by now; the loop runs on static memory only
+    heapGuardArm();
 }
 
 void loop()
 {
-    // Update system sensors
-    updateSensorReadings();
+    // One task per pass, highest rate first; idles until the next release
+    scheduler.service();
+}
 
-    // Main state machine
-    switch (currentState)
-    {
-    case STANDBY:
-        handleStandbyMode();
-        break;
+void registerTasks()
+{
+    // Periods come from config.h; the scheduler orders them rate-monotonically
+    scheduler.addTask("detection", runDetectionTask, (unsigned long)DETECTION_POLL_INTERVAL_MS * 1000);
+    scheduler.addTask("control", runControlTask, HZ_TO_PERIOD_US(CONTROL_UPDATE_FREQUENCY_HZ));
+    scheduler.addTask("sensors", updateSensorReadings, HZ_TO_PERIOD_US(SENSOR_UPDATE_FREQUENCY_HZ));
+    scheduler.addTask("console", serviceConsole, (unsigned long)CONSOLE_POLL_INTERVAL_MS * 1000);
+    scheduler.addTask("telemetry", sampleTelemetry, HZ_TO_PERIOD_US(TELEMETRY_UPDATE_FREQUENCY_HZ));
+    scheduler.addTask("uplink", flushTelemetry, HZ_TO_PERIOD_US(TELEMETRY_FLUSH_FREQUENCY_HZ));
+    scheduler.addTask("events", streamTrackEvents, HZ_TO_PERIOD_US(TRACK_EVENT_POLL_FREQUENCY_HZ));
+    scheduler.addTask("health", monitorSystemHealth, HZ_TO_PERIOD_US(HEALTH_CHECK_FREQUENCY_HZ));
+}
 
-    case ALERT:
-        handleAlertMode();
-        break;
+void runDetectionTask()
+{
+    PERF_SCOPE(PERF_DETECTION_UPDATE);
+    birdDetector.update();
+}
 
-    case ACTIVE_DETERRENT:
-        handleActiveDeterrentMode();
-        break;
+void runControlTask()
+{
+    unsigned long now = millis();
+    ThreatLevel threat = threatAssessment.update(birdDetector.getBirdData(0), birdDetector.getTrackCount(), now);
+    birdCount = threatAssessment.getBirdsInView();
 
+    // Work done while in a state, which can raise that state's own events
+    switch (currentState)
+    {
     case EMERGENCY:
-        handleEmergencyMode();
+        emergencyHandler.update();
+        if (emergencyHandler.isEmergencyResolved())
+        {
+            dispatchStateEvent(EVENT_EMERGENCY_RESOLVED, now);
+        }
         break;
 
     case MAINTENANCE:
-        handleMaintenanceMode();
+        if (runMaintenanceSelfTest())
+        {
+            dispatchStateEvent(EVENT_SELF_TEST_PASSED, now);
+        }
         break;
+
+    default:
+        break;
+    }
+
+    // Transitions come from the table in system_state_machine.cpp
+    if (stateMachine.isTimedOut(now))
+    {
+        dispatchStateEvent(EVENT_STATE_TIMEOUT, now);
     }
+    dispatchStateEvent(SystemStateMachine::threatEvent(threat), now);
 
-    // System health monitoring
-    monitorSystemHealth();
+    updateTargeting();
 
-    // Telemetry transmission
-    sendTelemetryData();
+    // Deterrent outputs advance their own patterns, calibration and test
+    // steps from here rather than blocking
+    {
+        PERF_SCOPE(PERF_VISUAL_UPDATE);
+        visualSystem.update();
+    }
+    {
+        PERF_SCOPE(PERF_AUDIO_UPDATE);
+        audioSystem.update();
+    }
 
     // Status LED heartbeat
     updateStatusLED();
+}
 
-    delay(50); // 20Hz main loop
+// While deterring, only the emitters facing a threat run, at a drive that
+// follows it; in every other state each emitter is available to its pattern
+void updateTargeting()
+{
+    if (currentState != ALERT && currentState != ACTIVE_DETERRENT)
+    {
+        visualSystem.setTargetMask(0xFFFF);
+        audioSystem.setDirectionalGain(1.0);
+        return;
+    }
+
+    unsigned long now = millis();
+    ledTargeting.update(birdDetector.getBirdData(0), birdDetector.getTrackCount(), now);
+    speakerTargeting.update(birdDetector.getBirdData(0), birdDetector.getTrackCount(), now);
+    visualSystem.setTargetMask(ledTargeting.getActiveMask());
+    audioSystem.setDirectionalGain(speakerTargeting.getDrive(0));
+}
+
+void serviceConsole()
+{
+    while (Serial.available() > 0)
+    {
+        switch (Serial.read())
+        {
+        case 't':
+            scheduler.printStatistics();
+            break;
+        case 'p':
+            perfPrintReport();
+            break;
+        case 'r':
+            scheduler.resetStatistics();
+            perfResetAll();
+            Serial.println("Task and performance statistics reset");
+            break;
+        case 's':
+            printSystemStatus();
+            break;
+        case 'd':
+            birdDetector.printDetectionReport(Serial);
+            visualSystem.printStatusReport(Serial);
+            audioSystem.printStatusReport(Serial);
+            break;
+        }
+    }
 }
 
 bool initializeComponents()
 {
     Serial.println("Initializing components...");
 
-    if (!birdDetector.begin(TRIG_PIN_1, ECHO_PIN_1, TRIG_PIN_2, ECHO_PIN_2, TRIG_PIN_3, ECHO_PIN_3))
+    if (!birdDetector.begin(sensorRing, sizeof(sensorRing) / sizeof(sensorRing[0])))
     {
         Serial.println("ERROR: Bird detection system failed to initialize");
         return false;
     }
     Serial.println("✓ Bird detection system initialized");
 
-    if (!visualSystem.begin(LED_STROBE_PIN_1, LED_STROBE_PIN_2))
+    if (!visualSystem.begin(ledDriver))
     {
         Serial.println("ERROR: Visual deterrent system failed to initialize");
         return false;
     }
     Serial.println("✓ Visual deterrent system initialized");
 
+#if LED_EXPANDER_CHANNELS > 0
+    bool targetingReady = ledTargeting.beginRing(visualSystem.getChannelCount());
+#else
+    bool targetingReady = ledTargeting.begin(strobeSegments, sizeof(strobeSegments) / sizeof(strobeSegments[0]));
+#endif
+    targetingReady = targetingReady && speakerTargeting.begin(speakerMounts, sizeof(speakerMounts) / sizeof(speakerMounts[0]));
+    if (!targetingReady)
+    {
+        Serial.println("ERROR: Deterrent targeting has no emitters");
+        return false;
+    }
+
     if (!audioSystem.begin(AUDIO_PWM_PIN, AUDIO_ENABLE_PIN))
     {
         Serial.println("ERROR: Audio deterrent system failed to initialize");
@@ -210,129 +349,98 @@ void initializeWiFi()
 void updateSensorReadings()
 {
 
-    birdDetector.update();
+    float ambientTemperature = weatherSystem.getWeatherData().temperature;
+    birdDetector.setAmbientTemperature(ambientTemperature);
+    visualSystem.setAmbientTemperature(ambientTemperature);
 
     // Update power management readings
     batteryVoltage = powerManager.getBatteryVoltage();
     systemTemperature = powerManager.getTemperature();
 
+    PERF_SCOPE(PERF_WEATHER_UPDATE);
     weatherSystem.update();
 }
 
-void handleStandbyMode()
+void dispatchStateEvent(StateEvent event, unsigned long now)
 {
-    // Continuous bird monitoring in low-power mode
-    if (birdDetector.isBirdDetected(BIRD_DETECTION_RADIUS_M))
-    {
-        Serial.println("ALERT: Bird detected at " + String(birdDetector.getClosestDistance()) + "m");
-        birdCount = birdDetector.getBirdCount();
-        lastBirdDetection = millis();
-
-        // Transition to alert mode
-        currentState = ALERT;
-        visualSystem.activateAlertMode();
-
-        if (DEBUG_MODE)
-        {
-            Serial.println("State transition: STANDBY -> ALERT");
-        }
-    }
+    SystemState from = currentState;
+    if (!stateMachine.dispatch(event, now))
+        return;
 
-    powerManager.setLowPowerMode(true);
+    currentState = stateMachine.getState();
+    enterState(from, currentState, stateMachine.getReason());
 }
 
-void handleAlertMode()
+// Entry actions, run once per transition
+void enterState(SystemState from, SystemState to, const char *reason)
 {
-    float closestDistance = birdDetector.getClosestDistance();
-
-    if (closestDistance <= EMERGENCY_DISTANCE_M)
+    Serial.print(getStateString(to));
+    Serial.print(": ");
+    Serial.print(reason);
+    if (threatAssessment.getBirdsInView() > 0)
     {
-        Serial.println("EMERGENCY: Bird within " + String(EMERGENCY_DISTANCE_M) + "m!");
-        currentState = ACTIVE_DETERRENT;
-        activationStartTime = millis();
-
-        // Activate full deterrent system
-        visualSystem.activateStrobeMode();
-        audioSystem.playDistressCalls();
-        powerManager.setLowPowerMode(false);
-
-        if (DEBUG_MODE)
+        Serial.print(" - closest ");
+        Serial.print(threatAssessment.getClosestDistance());
+        Serial.print("m, contact in ");
+        float ttc = threatAssessment.getMinTimeToContact();
+        if (isinf(ttc))
         {
-            Serial.println("State transition: ALERT -> ACTIVE_DETERRENT");
+            Serial.print("-");
         }
-    }
-    // Check if birds moved away
-    else if (!birdDetector.isBirdDetected(BIRD_DETECTION_RADIUS_M))
-    {
-        Serial.println("All clear - birds moved away");
-        currentState = STANDBY;
-        visualSystem.deactivate();
-
-        if (DEBUG_MODE)
+        else
         {
-            Serial.println("State transition: ALERT -> STANDBY");
+            Serial.print(ttc);
+            Serial.print("s");
         }
     }
-}
-
-void handleActiveDeterrentMode()
-{
-    unsigned long currentTime = millis();
-    float closestDistance = birdDetector.getClosestDistance();
-
-    if (closestDistance <= 5.0 && birdDetector.getBirdCount() > 2)
-    {
-        Serial.println("CRITICAL: Multiple birds within 5m - Emergency landing!");
-        currentState = EMERGENCY;
-        emergencyHandler.activateEmergencyMode("BIRD_STRIKE_IMMINENT");
-        return;
-    }
-
-    if (currentTime - activationStartTime > MAX_ACTIVATION_TIME_MS)
-    {
-        Serial.println("Maximum deterrent time reached - switching to emergency mode");
-        currentState = EMERGENCY;
-        emergencyHandler.activateEmergencyMode("DETERRENT_TIMEOUT");
-        return;
-    }
+    Serial.println();
 
-    if (!birdDetector.isBirdDetected(BIRD_DETECTION_RADIUS_M * 2))
+    switch (to)
     {
-        Serial.println("SUCCESS: Birds successfully deterred");
-        currentState = STANDBY;
+    case STANDBY:
         visualSystem.deactivate();
         audioSystem.stop();
+        powerManager.setLowPowerMode(true);
+        break;
 
-        if (DEBUG_MODE)
+    case ALERT:
+        if (from == ACTIVE_DETERRENT)
         {
-            Serial.println("State transition: ACTIVE_DETERRENT -> STANDBY");
+            audioSystem.stop();
         }
-    }
-
-    visualSystem.update();
-    audioSystem.update();
-}
+        visualSystem.activateAlertMode();
+        powerManager.setLowPowerMode(true);
+        break;
 
-void handleEmergencyMode()
-{
+    case ACTIVE_DETERRENT:
+        visualSystem.activateStrobeMode();
+        audioSystem.playDistressCalls();
+        powerManager.setLowPowerMode(false);
+        break;
 
-    emergencyHandler.update();
+    case EMERGENCY:
+        // All deterrent systems at maximum
+        emergencyHandler.activateEmergencyMode(reason);
+        visualSystem.activateEmergencyMode();
+        audioSystem.playEmergencySignals();
+        powerManager.setLowPowerMode(false);
+        break;
 
-    // All deterrent systems at maximum
-    visualSystem.activateEmergencyMode();
-    audioSystem.playEmergencySignals();
+    case MAINTENANCE:
+    default:
+        break;
+    }
 
-    // Check if emergency resolved
-    if (emergencyHandler.isEmergencyResolved())
+    if (DEBUG_MODE)
     {
-        Serial.println("Emergency resolved - returning to standby");
-        currentState = STANDBY;
-        visualSystem.deactivate();
-        audioSystem.stop();
+        Serial.print("State transition: ");
+        Serial.print(getStateString(from));
+        Serial.print(" -> ");
+        Serial.println(getStateString(to));
     }
 }
 
-void handleMaintenanceMode()
+bool runMaintenanceSelfTest()
 {
 
     Serial.println("=== MAINTENANCE MODE ===");
@@ -349,12 +457,12 @@ void handleMaintenanceMode()
     if (allTestsPassed)
     {
         Serial.println("All systems passed self-test");
-        currentState = STANDBY;
     }
     else
     {
         Serial.println("CRITICAL: System failures detected");
     }
+    return allTestsPassed;
 }
 
 void monitorSystemHealth()
@@ -362,14 +470,18 @@ void monitorSystemHealth()
     // Battery voltage monitoring
     if (batteryVoltage < 10.5)
     { // Below safe operating voltage
-        Serial.println("WARNING: Low battery voltage: " + String(batteryVoltage) + "V");
+        Serial.print("WARNING: Low battery voltage: ");
+        Serial.print(batteryVoltage);
+        Serial.println("V");
         emergencyHandler.reportHealthIssue("LOW_BATTERY");
     }
 
     // Temperature monitoring
     if (systemTemperature > 60.0)
     { // Overheating threshold
-        Serial.println("WARNING: High system temperature: " + String(systemTemperature) + "°C");
+        Serial.print("WARNING: High system temperature: ");
+        Serial.print(systemTemperature);
+        Serial.println("°C");
         emergencyHandler.reportHealthIssue("OVERHEATING");
     }
 
@@ -381,35 +493,127 @@ void monitorSystemHealth()
     }
 }
 
-void sendTelemetryData()
+void sampleTelemetry()
 {
-    static unsigned long lastTelemetry = 0;
+    TelemetrySample sample;
+    sample.values[TELEMETRY_TIMESTAMP_MS] = (int32_t)millis();
+    sample.values[TELEMETRY_STATE] = currentState;
+    sample.values[TELEMETRY_BATTERY_MV] = (int32_t)(batteryVoltage * 1000.0 + 0.5);
+    sample.values[TELEMETRY_TEMPERATURE_CC] = (int32_t)lround(systemTemperature * 100.0);
+    sample.values[TELEMETRY_BIRD_COUNT] = birdCount;
+    sample.values[TELEMETRY_CLOSEST_DISTANCE_MM] = (int32_t)lround(birdDetector.getClosestDistance() * 10.0);
+    sample.values[TELEMETRY_WEATHER_CONDITION] = weatherSystem.getCurrentCondition();
+    sample.values[TELEMETRY_WEATHER_CRITICAL] = weatherSystem.isWeatherCritical();
+    sample.values[TELEMETRY_EMERGENCY_STATE] = emergencyHandler.getCurrentState();
+    sample.values[TELEMETRY_HEALTH_ISSUES] = emergencyHandler.getHealthIssueCount();
+
+    telemetryQueue.push(sample);
+}
 
-    if (millis() - lastTelemetry > 5000)
-    { // Send every 5 seconds
-        if (WiFi.status() == WL_CONNECTED)
+// Packs full batches from the ring into the backlog. A partial batch stays
+// in the ring until it fills, or until the ring runs short of headroom.
+void storeTelemetryBacklog()
+{
+    while (telemetryQueue.available() > 0)
+    {
+        int pending = telemetryQueue.available();
+        telemetryEncoder.beginBatch();
+        while (telemetryEncoder.getBatchCount() < pending)
         {
-            DynamicJsonDocument telemetry(1024);
+            if (!telemetryEncoder.addToBatch(telemetryQueue.peek(telemetryEncoder.getBatchCount())))
+                break;
+        }
+        int count = telemetryEncoder.getBatchCount();
+        if (count == pending && pending < MAX_TELEMETRY_QUEUE - TELEMETRY_FLUSH_HEADROOM)
+            return;
+
+        int32_t firstMs = telemetryQueue.peek(0).values[TELEMETRY_TIMESTAMP_MS];
+        int32_t lastMs = telemetryQueue.peek(count - 1).values[TELEMETRY_TIMESTAMP_MS];
+        size_t length = telemetryEncoder.finishBatch();
+        telemetryBacklog.store(telemetryEncoder.getFrame(), length, count, firstMs, lastMs);
+        telemetryQueue.release(count);
+    }
+}
 
-            telemetry["timestamp"] = millis();
-            telemetry["state"] = getStateString(currentState);
-            telemetry["battery_voltage"] = batteryVoltage;
-            telemetry["temperature"] = systemTemperature;
-            telemetry["bird_count"] = birdCount;
-            telemetry["closest_bird_distance"] = birdDetector.getClosestDistance();
-            telemetry["weather_status"] = weatherSystem.getWeatherStatus();
-            telemetry["system_health"] = emergencyHandler.getHealthStatus();
+void flushTelemetry()
+{
+    static uint8_t flushesSincePerf = 0;
+    static uint8_t backlogFrame[TELEMETRY_MAX_FRAME];
 
-            String telemetryString;
-            serializeJson(telemetry, telemetryString);
+    // Store and forward: during an outage, and until its history has been
+    // sent, samples go through the backlog so they stay in order
+    bool linkUp = WiFi.status() == WL_CONNECTED;
+    if (!linkUp || !telemetryBacklog.isEmpty())
+    {
+        storeTelemetryBacklog();
+    }
+    if (!linkUp)
+        return;
 
-            if (DEBUG_MODE)
+    // Bounded drain, so recovering from an outage cannot flood the link
+    int batch = 0;
+    for (; batch < TELEMETRY_FLUSH_MAX_BATCHES && !telemetryBacklog.isEmpty(); batch++)
+    {
+        size_t length = telemetryBacklog.copyOldest(backlogFrame);
+        Serial.write(backlogFrame, length);
+        telemetryBacklog.release();
+    }
+    for (; batch < TELEMETRY_FLUSH_MAX_BATCHES && telemetryBacklog.isEmpty() && telemetryQueue.available() > 0;
+         batch++)
+    {
+        size_t length;
+        int count;
+        {
+            PERF_SCOPE(PERF_TELEMETRY_SERIALIZE);
+            int pending = telemetryQueue.available();
+            telemetryEncoder.beginBatch();
+            while (telemetryEncoder.getBatchCount() < pending)
             {
-                Serial.println("Telemetry: " + telemetryString);
+                if (!telemetryEncoder.addToBatch(telemetryQueue.peek(telemetryEncoder.getBatchCount())))
+                    break;
             }
+            count = telemetryEncoder.getBatchCount();
+            length = telemetryEncoder.finishBatch();
         }
+        Serial.write(telemetryEncoder.getFrame(), length);
+        telemetryQueue.release(count);
+    }
 
-        lastTelemetry = millis();
+#if ENABLE_PERFORMANCE_MONITORING
+    // Profiling summaries ride along about once a second
+    if (++flushesSincePerf >= TELEMETRY_PERF_INTERVAL_FLUSHES)
+    {
+        flushesSincePerf = 0;
+        int32_t perf[PERF_PROBE_COUNT * 4];
+        for (int i = 0; i < PERF_PROBE_COUNT; i++)
+        {
+            perf[i * 4] = perfProbes[i].getMin();
+            perf[i * 4 + 1] = perfProbes[i].getMean();
+            perf[i * 4 + 2] = perfProbes[i].getPercentile(0.99);
+            perf[i * 4 + 3] = perfProbes[i].getMax();
+        }
+        size_t length = telemetryEncoder.encodeValues(TELEMETRY_FRAME_PERF, perf, PERF_PROBE_COUNT * 4);
+        Serial.write(telemetryEncoder.getFrame(), length);
+    }
+#else
+    (void)flushesSincePerf;
+#endif
+}
+
+void streamTrackEvents()
+{
+    unsigned long now = millis();
+    trackEvents.update(birdDetector.getBirdData(0), birdDetector.getTrackCount(), now);
+
+    // Reports stay pending through an outage and go out, coalesced, once
+    // the link is back
+    if (WiFi.status() != WL_CONNECTED)
+        return;
+
+    size_t length = trackEvents.emit(telemetryEncoder, now);
+    if (length > 0)
+    {
+        Serial.write(telemetryEncoder.getFrame(), length);
     }
 }
 
@@ -435,6 +639,7 @@ void updateStatusLED()
         digitalWrite(STATUS_LED_PIN, HIGH); // Solid on
         return;
     case MAINTENANCE:
+    default:
         blinkInterval = 1000; // Medium blink
         break;
     }
@@ -447,32 +652,25 @@ void updateStatusLED()
     }
 }
 
-String getStateString(SystemState state)
+const char *getStateString(SystemState state)
 {
-    switch (state)
-    {
-    case STANDBY:
-        return "STANDBY";
-    case ALERT:
-        return "ALERT";
-    case ACTIVE_DETERRENT:
-        return "ACTIVE_DETERRENT";
-    case EMERGENCY:
-        return "EMERGENCY";
-    case MAINTENANCE:
-        return "MAINTENANCE";
-    default:
-        return "UNKNOWN";
-    }
+    return SystemStateMachine::getStateName(state);
 }
 
 void printSystemStatus()
 {
     Serial.println("\n=== SYSTEM STATUS ===");
-    Serial.println("State: " + getStateString(currentState));
-    Serial.println("Battery: " + String(batteryVoltage) + "V");
-    Serial.println("Temperature: " + String(systemTemperature) + "°C");
-    Serial.println("Birds detected: " + String(birdCount));
-    Serial.println("WiFi: " + String(WiFi.status() == WL_CONNECTED ? "Connected" : "Disconnected"));
+    Serial.print("State: ");
+    Serial.println(getStateString(currentState));
+    Serial.print("Battery: ");
+    Serial.print(batteryVoltage);
+    Serial.println("V");
+    Serial.print("Temperature: ");
+    Serial.print(systemTemperature);
+    Serial.println("°C");
+    Serial.print("Birds detected: ");
+    Serial.println(birdCount);
+    Serial.print("WiFi: ");
+    Serial.println(WiFi.status() == WL_CONNECTED ? "Connected" : "Disconnected");
     Serial.println("====================\n");
 }
\ No newline at end of file
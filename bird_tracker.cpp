@@ -0,0 +1,271 @@
+#include "bird_tracker.h"
+
+static_assert((TRACKER_STALE_TIMEOUT_MS * 3 / 4) * TRACKER_CONFIDENCE_DECAY_PER_S / 1000 <= 255,
+              "stale confidence decay must fit BirdObject::staleDecay");
+
+BirdTracker::BirdTracker(BirdObject *pool, int poolCapacity)
+{
+    tracks = pool;
+    capacity = poolCapacity;
+    trackCount = 0;
+    nextTrackId = 1;
+    reset();
+}
+
+void BirdTracker::reset()
+{
+    trackCount = 0;
+
+    for (int i = 0; i < capacity; i++)
+    {
+        tracks[i].distance = 9999.0;
+        tracks[i].azimuth = 0.0;
+        tracks[i].lastDistance = 9999.0;
+        tracks[i].lastSeen = 0;
+        tracks[i].velocity = 0.0;
+        tracks[i].confirmed = false;
+        tracks[i].confidenceLevel = 0;
+        tracks[i].trackId = 0;
+        tracks[i].sensorIndex = 0;
+        tracks[i].hits = 0;
+        tracks[i].misses = 0;
+        tracks[i].staleDecay = 0;
+        tracks[i].updated = false;
+        tracks[i].rangeRate = 0.0;
+        tracks[i].covariance[0][0] = 0.0;
+        tracks[i].covariance[0][1] = 0.0;
+        tracks[i].covariance[1][0] = 0.0;
+        tracks[i].covariance[1][1] = 0.0;
+        tracks[i].lastPredict = 0;
+    }
+}
+
+void BirdTracker::update(const TrackMeasurement *measurements, int count, unsigned long timestamp)
+{
+    if (count <= 0)
+        return;
+
+    uint32_t reportingSensors = 0;
+
+    for (int i = 0; i < trackCount; i++)
+    {
+        tracks[i].updated = false;
+    }
+
+    for (int m = 0; m < count; m++)
+    {
+        const TrackMeasurement &measurement = measurements[m];
+        reportingSensors |= (1UL << (measurement.sensorIndex & 31));
+
+        int bestTrack = -1;
+        float bestDistance = TRACKER_GATE_THRESHOLD;
+
+        for (int i = 0; i < trackCount; i++)
+        {
+            BirdObject *track = &tracks[i];
+            if (track->updated)
+                continue;
+            if (azimuthDifference(track->azimuth, measurement.azimuth) > TRACKER_AZIMUTH_GATE_DEG)
+                continue;
+
+            predict(track, measurement.timestamp);
+
+            float distance = innovationDistance(track, measurement);
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                bestTrack = i;
+            }
+        }
+
+        if (bestTrack >= 0)
+        {
+            BirdObject *track = &tracks[bestTrack];
+            correct(track, measurement);
+            track->updated = true;
+            track->hits = min(255, track->hits + 1);
+            track->misses = 0;
+            track->staleDecay = 0;
+            track->lastSeen = measurement.timestamp;
+            track->confidenceLevel = min(100, track->confidenceLevel + 10);
+            if (track->hits >= TRACKER_CONFIRM_HITS)
+            {
+                track->confirmed = true;
+            }
+        }
+        else if (spawnTrack(measurement))
+        {
+            tracks[trackCount - 1].updated = true;
+        }
+    }
+
+    // A track only misses when its own sensor reported and nothing matched it
+    for (int i = trackCount - 1; i >= 0; i--)
+    {
+        BirdObject *track = &tracks[i];
+        if (track->updated || !(reportingSensors & (1UL << (track->sensorIndex & 31))))
+            continue;
+
+        track->misses++;
+        track->confidenceLevel = max(0, track->confidenceLevel - 5);
+        if (track->misses > TRACKER_MAX_MISSES)
+        {
+            removeTrack(i);
+        }
+    }
+}
+
+void BirdTracker::predict(BirdObject *track, unsigned long timestamp)
+{
+    if ((long)(timestamp - track->lastPredict) <= 0)
+        return;
+
+    float dt = (timestamp - track->lastPredict) / 1000.0;
+    float dt2 = dt * dt;
+    float q = TRACKER_PROCESS_NOISE;
+    float (*p)[2] = track->covariance;
+
+    track->distance += track->rangeRate * dt;
+
+    float p00 = p[0][0] + dt * (p[0][1] + p[1][0]) + dt2 * p[1][1] + q * dt2 * dt2 / 4.0;
+    float p01 = p[0][1] + dt * p[1][1] + q * dt2 * dt / 2.0;
+    float p10 = p[1][0] + dt * p[1][1] + q * dt2 * dt / 2.0;
+    float p11 = p[1][1] + q * dt2;
+
+    p[0][0] = p00;
+    p[0][1] = p01;
+    p[1][0] = p10;
+    p[1][1] = p11;
+
+    track->lastPredict = timestamp;
+}
+
+float BirdTracker::innovationDistance(const BirdObject *track, const TrackMeasurement &measurement)
+{
+    float innovation = measurement.range - track->distance;
+    float variance = track->covariance[0][0] + TRACKER_MEASUREMENT_NOISE_CM * TRACKER_MEASUREMENT_NOISE_CM;
+    return innovation * innovation / variance;
+}
+
+void BirdTracker::correct(BirdObject *track, const TrackMeasurement &measurement)
+{
+    float (*p)[2] = track->covariance;
+    float innovation = measurement.range - track->distance;
+    float variance = p[0][0] + TRACKER_MEASUREMENT_NOISE_CM * TRACKER_MEASUREMENT_NOISE_CM;
+    float gainRange = p[0][0] / variance;
+    float gainRate = p[1][0] / variance;
+
+    track->lastDistance = track->distance;
+    track->distance += gainRange * innovation;
+    track->rangeRate += gainRate * innovation;
+    track->azimuth = measurement.azimuth;
+    track->velocity = -track->rangeRate / 100.0;
+
+    float p00 = (1.0 - gainRange) * p[0][0];
+    float p01 = (1.0 - gainRange) * p[0][1];
+    float p10 = p[1][0] - gainRate * p[0][0];
+    float p11 = p[1][1] - gainRate * p[0][1];
+
+    p[0][0] = p00;
+    p[0][1] = p01;
+    p[1][0] = p10;
+    p[1][1] = p11;
+}
+
+bool BirdTracker::spawnTrack(const TrackMeasurement &measurement)
+{
+    if (trackCount >= capacity)
+        return false;
+
+    BirdObject *track = &tracks[trackCount++];
+    track->distance = measurement.range;
+    track->lastDistance = measurement.range;
+    track->azimuth = measurement.azimuth;
+    track->lastSeen = measurement.timestamp;
+    track->lastPredict = measurement.timestamp;
+    track->velocity = 0.0;
+    track->rangeRate = 0.0;
+    track->confirmed = false;
+    track->confidenceLevel = 20;
+    track->trackId = nextTrackId++;
+    if (nextTrackId == 0)
+    {
+        nextTrackId = 1;
+    }
+    track->sensorIndex = measurement.sensorIndex;
+    track->hits = 1;
+    track->misses = 0;
+    track->staleDecay = 0;
+    track->covariance[0][0] = TRACKER_MEASUREMENT_NOISE_CM * TRACKER_MEASUREMENT_NOISE_CM;
+    track->covariance[0][1] = 0.0;
+    track->covariance[1][0] = 0.0;
+    track->covariance[1][1] = TRACKER_INITIAL_VELOCITY_VAR;
+    return true;
+}
+
+void BirdTracker::removeTrack(int index)
+{
+    trackCount--;
+    if (index != trackCount)
+    {
+        tracks[index] = tracks[trackCount];
+    }
+    tracks[trackCount].confirmed = false;
+    tracks[trackCount].confidenceLevel = 0;
+    tracks[trackCount].distance = 9999.0;
+    tracks[trackCount].velocity = 0.0;
+}
+
+void BirdTracker::removeStaleTracks(unsigned long timestamp)
+{
+    for (int i = trackCount - 1; i >= 0; i--)
+    {
+        unsigned long age = timestamp - tracks[i].lastSeen;
+
+        if (age > TRACKER_STALE_TIMEOUT_MS)
+        {
+            removeTrack(i);
+        }
+        else if (age > TRACKER_STALE_TIMEOUT_MS / 4)
+        {
+            // Take off whatever the time unseen has earned since the last
+            // call, however often this is called
+            unsigned long due = (age - TRACKER_STALE_TIMEOUT_MS / 4) * TRACKER_CONFIDENCE_DECAY_PER_S / 1000;
+            int step = (int)due - tracks[i].staleDecay;
+            tracks[i].staleDecay = (uint8_t)due;
+            tracks[i].confidenceLevel = max(0, tracks[i].confidenceLevel - step);
+            if (tracks[i].confidenceLevel < 10)
+            {
+                removeTrack(i);
+            }
+        }
+    }
+}
+
+float BirdTracker::azimuthDifference(float a, float b)
+{
+    float diff = fabs(a - b);
+    while (diff > 360.0)
+    {
+        diff -= 360.0;
+    }
+    return diff > 180.0 ? 360.0 - diff : diff;
+}
+
+int BirdTracker::getTrackCount()
+{
+    return trackCount;
+}
+
+int BirdTracker::getCapacity()
+{
+    return capacity;
+}
+
+BirdObject *BirdTracker::getTrack(int index)
+{
+    if (index < 0 || index >= trackCount)
+        return nullptr;
+
+    return &tracks[index];
+}
@@ -0,0 +1,74 @@
+#ifndef BIRD_TRACKER_H
+#define BIRD_TRACKER_H
+
+#include <Arduino.h>
+
+#define TRACKER_MEASUREMENT_NOISE_CM 3.0
+#define TRACKER_PROCESS_NOISE 2500.0 // Acceleration variance, (cm/s^2)^2
+#define TRACKER_INITIAL_VELOCITY_VAR 250000.0
+#define TRACKER_GATE_THRESHOLD 9.0 // Normalised innovation squared (3 sigma)
+#define TRACKER_AZIMUTH_GATE_DEG 30.0
+#define TRACKER_CONFIRM_HITS 3
+#define TRACKER_MAX_MISSES 6
+#define TRACKER_STALE_TIMEOUT_MS 2000
+#define TRACKER_CONFIDENCE_DECAY_PER_S 50 // Once unseen for a quarter of the stale timeout
+
+struct BirdObject
+{
+    float distance;     // Filtered range, cm
+    float azimuth;      // Bearing of the sensor that sees it, degrees
+    float lastDistance; // Range at the previous update, cm
+    unsigned long lastSeen;
+    float velocity; // Closing speed, m/s (positive when approaching)
+    bool confirmed;
+    int confidenceLevel;
+
+    // Constant-velocity Kalman state: range (cm) and range rate (cm/s)
+    uint16_t trackId;
+    uint8_t sensorIndex;
+    uint8_t hits;
+    uint8_t misses;
+    uint8_t staleDecay; // Confidence taken off since lastSeen, so decay follows elapsed time
+    bool updated; // Associated during the current update() pass
+    float rangeRate;
+    float covariance[2][2];
+    unsigned long lastPredict;
+};
+
+struct TrackMeasurement
+{
+    float range; // cm
+    float azimuth;
+    uint8_t sensorIndex;
+    unsigned long timestamp;
+};
+
+// Multi-target tracker over a fixed, caller-owned pool of BirdObjects. Live
+// tracks are kept packed at the front of the pool, so the per-update cost
+// scales with the number of birds in view rather than with pool capacity.
+class BirdTracker
+{
+private:
+    BirdObject *tracks;
+    int capacity;
+    int trackCount;
+    uint16_t nextTrackId;
+
+    void predict(BirdObject *track, unsigned long timestamp);
+    void correct(BirdObject *track, const TrackMeasurement &measurement);
+    float innovationDistance(const BirdObject *track, const TrackMeasurement &measurement);
+    bool spawnTrack(const TrackMeasurement &measurement);
+    void removeTrack(int index);
+    static float azimuthDifference(float a, float b);
+
+public:
+    BirdTracker(BirdObject *pool, int poolCapacity);
+    void reset();
+    void update(const TrackMeasurement *measurements, int count, unsigned long timestamp);
+    void removeStaleTracks(unsigned long timestamp);
+    int getTrackCount();
+    int getCapacity();
+    BirdObject *getTrack(int index);
+};
+
+#endif
@@ -0,0 +1,90 @@
+#include "brightness_lut.h"
+
+// round(255 * (i / 255)^2.2): perceived brightness to PWM duty
+static const uint8_t gammaTable[BRIGHTNESS_LEVELS] PROGMEM = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2,
+    3, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6,
+    6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10, 11, 11, 11, 12,
+    12, 13, 13, 13, 14, 14, 15, 15, 16, 16, 17, 17, 18, 18, 19, 19,
+    20, 20, 21, 22, 22, 23, 23, 24, 25, 25, 26, 26, 27, 28, 28, 29,
+    30, 30, 31, 32, 33, 33, 34, 35, 35, 36, 37, 38, 39, 39, 40, 41,
+    42, 43, 43, 44, 45, 46, 47, 48, 49, 49, 50, 51, 52, 53, 54, 55,
+    56, 57, 58, 59, 60, 61, 62, 63, 64, 65, 66, 67, 68, 69, 70, 71,
+    73, 74, 75, 76, 77, 78, 79, 81, 82, 83, 84, 85, 87, 88, 89, 90,
+    91, 93, 94, 95, 97, 98, 99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255};
+
+static_assert(LED_AMBIENT_BUCKETS >= 2 && LED_AMBIENT_BUCKETS <= AMBIENT_ADC_RANGE, "LED_AMBIENT_BUCKETS out of range");
+static_assert(LED_AMBIENT_HYSTERESIS < AMBIENT_BUCKET_WIDTH / 2, "LED_AMBIENT_HYSTERESIS must leave each bucket reachable");
+
+BrightnessTable::BrightnessTable()
+{
+    rebuildCount = 0;
+    rebuild(LED_AMBIENT_BUCKETS - 1);
+}
+
+// Stays in the current bucket until the reading is LED_AMBIENT_HYSTERESIS
+// past one of its edges, so a sensor sitting on a boundary does not keep
+// rebuilding the table and shifting the output
+bool BrightnessTable::setAmbient(int reading)
+{
+    int low = bucket * AMBIENT_BUCKET_WIDTH - LED_AMBIENT_HYSTERESIS;
+    int high = (bucket + 1) * AMBIENT_BUCKET_WIDTH + LED_AMBIENT_HYSTERESIS;
+    if (reading >= low && reading < high)
+        return false;
+
+    int newBucket = bucketFor(reading);
+    if (newBucket == bucket)
+        return false;
+
+    rebuild(newBucket);
+    return true;
+}
+
+void BrightnessTable::rebuild(int newBucket)
+{
+    bucket = newBucket;
+    int gain = gainFor(bucket);
+
+    levels[0] = 0;
+    for (int i = 1; i < BRIGHTNESS_LEVELS; i++)
+    {
+        uint8_t level = gammaCorrect((i * gain + 128) >> 8);
+        // A lit request never renders as dark
+        levels[i] = level > 0 ? level : 1;
+    }
+    rebuildCount++;
+}
+
+int BrightnessTable::getBucket()
+{
+    return bucket;
+}
+
+unsigned long BrightnessTable::getRebuildCount()
+{
+    return rebuildCount;
+}
+
+int BrightnessTable::bucketFor(int reading)
+{
+    return constrain(reading / AMBIENT_BUCKET_WIDTH, 0, LED_AMBIENT_BUCKETS - 1);
+}
+
+// Perceived gain for a bucket in 1/256ths, LED_AMBIENT_MIN_GAIN in the
+// darkest up to unity in the brightest
+int BrightnessTable::gainFor(int bucket)
+{
+    int minGain = (int)(LED_AMBIENT_MIN_GAIN * 256 + 0.5);
+    return minGain + (256 - minGain) * bucket / (LED_AMBIENT_BUCKETS - 1);
+}
+
+uint8_t BrightnessTable::gammaCorrect(uint8_t perceived)
+{
+    return pgm_read_byte(&gammaTable[perceived]);
+}
@@ -0,0 +1,37 @@
+#ifndef BRIGHTNESS_LUT_H
+#define BRIGHTNESS_LUT_H
+
+#include <Arduino.h>
+#include "config.h"
+
+#define BRIGHTNESS_LEVELS 256
+#define AMBIENT_ADC_RANGE 1024
+#define AMBIENT_BUCKET_WIDTH (AMBIENT_ADC_RANGE / LED_AMBIENT_BUCKETS)
+
+// Requested brightness to PWM level for the current ambient light. Requests
+// are in perceived brightness; each row of the table scales them by the
+// daylight gain for its ambient bucket and gamma-corrects (2.2) the result,
+// so a flash looks equally strong against the sky from dawn to noon. Only
+// the active row is held, rebuilt when the light sensor moves to another
+// bucket, so a write is a single lookup.
+class BrightnessTable
+{
+private:
+    uint8_t levels[BRIGHTNESS_LEVELS];
+    int bucket;
+    unsigned long rebuildCount;
+
+    void rebuild(int newBucket);
+
+public:
+    BrightnessTable();
+    bool setAmbient(int reading);
+    uint8_t lookup(uint8_t brightness) const { return levels[brightness]; }
+    int getBucket();
+    unsigned long getRebuildCount();
+    static int bucketFor(int reading);
+    static int gainFor(int bucket);
+    static uint8_t gammaCorrect(uint8_t perceived);
+};
+
+#endif
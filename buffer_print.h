@@ -0,0 +1,72 @@
+#ifndef BUFFER_PRINT_H
+#define BUFFER_PRINT_H
+
+#include <Arduino.h>
+
+// Print target over a caller-provided char buffer, for text that must be
+// built before it is sent. Output past the end is dropped; the buffer is
+// always terminated. Everything that takes a Print & can format into one
+// without touching the heap.
+class BufferPrint : public Print
+{
+private:
+    char *buffer;
+    size_t capacity;
+    size_t used;
+    bool truncated;
+
+public:
+    BufferPrint(char *buffer, size_t size) : buffer(buffer), capacity(size), used(0), truncated(false)
+    {
+        if (capacity > 0)
+        {
+            buffer[0] = 0;
+        }
+    }
+
+    size_t write(uint8_t c) override
+    {
+        if (used + 1 >= capacity)
+        {
+            truncated = true;
+            return 0;
+        }
+        buffer[used++] = (char)c;
+        buffer[used] = 0;
+        return 1;
+    }
+
+    size_t write(const uint8_t *data, size_t size) override
+    {
+        size_t room = used + 1 < capacity ? capacity - used - 1 : 0;
+        if (size > room)
+        {
+            truncated = true;
+            size = room;
+        }
+        memcpy(buffer + used, data, size);
+        used += size;
+        if (capacity > 0)
+        {
+            buffer[used] = 0;
+        }
+        return size;
+    }
+    using Print::write;
+
+    const char *c_str() const { return buffer; }
+    size_t length() const { return used; }
+    bool isTruncated() const { return truncated; }
+
+    void clear()
+    {
+        used = 0;
+        truncated = false;
+        if (capacity > 0)
+        {
+            buffer[0] = 0;
+        }
+    }
+};
+
+#endif
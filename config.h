@@ -8,7 +8,7 @@
 #define SYSTEM_BUILD_NUMBER 001
 
 // ==================== HARDWARE CONFIGURATION ====================
-s
+
 #define LED_STATUS_PIN 13
 #define LED_STROBE_PIN_1 2
 #define LED_STROBE_PIN_2 3
@@ -16,6 +16,15 @@ s
 #define AUDIO_ENABLE_PIN 5
 #define EMERGENCY_SERVO_PIN 6
 
+// Rigs with 8-16 strobe segments drive them from a TLC5947 PWM expander.
+// It needs an SPI bus of its own, since frames are sent from the strobe
+// timer interrupt; on MKR boards the header SPI pins carry ultrasonic lines,
+// so point LED_EXPANDER_SPI at a SERCOM-backed SPIClass for the wiring used.
+#define LED_EXPANDER_CHANNELS 0 // 0 drives LED_STROBE_PIN_1/2 directly
+#define LED_EXPANDER_SPI SPI
+#define LED_EXPANDER_SPI_HZ 8000000
+#define LED_EXPANDER_LATCH_PIN 0
+
 #define ULTRASONIC_TRIG_1 7 // Front sensor
 #define ULTRASONIC_ECHO_1 8
 #define ULTRASONIC_TRIG_2 9 // Left sensor
@@ -56,13 +65,24 @@ s
 
 #define LED_MAX_BRIGHTNESS 255
 #define LED_STROBE_FREQUENCY_HZ 10
-#define LED_THERMAL_LIMIT_C 70.0
+#define LED_THERMAL_LIMIT_C 70.0           // Junction limit the derating keeps below
+#define LED_THERMAL_RESISTANCE_C_PER_W 8.0 // Per segment, junction to air through its heatsink
+#define LED_THERMAL_CAPACITY_J_PER_C 15.0  // Segment plus heatsink; tau = R * C = 120 s
+#define LED_FULL_POWER_W 20.0              // Heat dissipated at level 255, continuous
+#define LED_DERATE_MARGIN_C 2.0            // Derated channels settle this far below the limit
+#define LED_DERATE_HORIZON_S 30.0          // Derating starts when the limit is this close
+#define LED_THERMAL_TRIP_C 75.0            // Hard per-channel cut, only reached on model error
+#define LED_THERMAL_UPDATE_MS 250
 #define LED_MAX_CONTINUOUS_TIME_MS 5000
 #define LED_COOLDOWN_TIME_MS 2000
+#define LED_AMBIENT_BUCKETS 8              // Daylight levels the brightness table is built for
+#define LED_AMBIENT_MIN_GAIN 0.5           // Perceived brightness in the dark, relative to full sun
+#define LED_AMBIENT_HYSTERESIS 16          // ADC counts past a bucket edge before switching
+#define LED_AMBIENT_UPDATE_MS 500
 #define REFLECTIVE_TAPE_EFFECTIVENESS 0.9
 
 #define AUDIO_MAX_VOLUME_DB 85
-#define AUDIO_SAMPLE_RATE_HZ 8000
+#define AUDIO_SAMPLE_RATE_HZ 62500
 #define AUDIO_BUFFER_SIZE 256
 #define ULTRASONIC_MIN_FREQ_HZ 17000
 #define ULTRASONIC_MAX_FREQ_HZ 24000
@@ -118,7 +138,8 @@ s
 #define WIND_RESISTANCE_MAX_MPS 30
 #define VIBRATION_RESISTANCE_G 5.0
 
-// ==================== FEATURE F
+// ==================== FEATURE FLAGS ====================
+
 #define ENABLE_BIRD_DETECTION 1
 #define ENABLE_VISUAL_DETERRENT 1
 #define ENABLE_AUDIO_DETERRENT 1
@@ -131,6 +152,9 @@ s
 #define ENABLE_SERIAL_COMMANDS 1
 #define ENABLE_SELF_TEST 1
 #define ENABLE_PERFORMANCE_MONITORING 1
+#ifndef ENABLE_HEAP_GUARD
+#define ENABLE_HEAP_GUARD 0 // Fault on any heap allocation after setup() (see heap_guard.h)
+#endif
 #define ENABLE_DATA_LOGGING 1
 
 #define ENABLE_ADAPTIVE_DETERRENCE 1
@@ -149,7 +173,7 @@ s
 #define MAIN_LOOP_FREQUENCY_HZ 20
 #define SENSOR_UPDATE_FREQUENCY_HZ 10
 #define CONTROL_UPDATE_FREQUENCY_HZ 50
-#define TELEMETRY_UPDATE_FREQUENCY_HZ 1
+#define TELEMETRY_UPDATE_FREQUENCY_HZ 10
 #define HEALTH_CHECK_FREQUENCY_HZ 0.2
 #define SENSOR_READ_TIMEOUT_MS 100
 #define COMMAND_EXECUTION_TIMEOUT_MS 5000
@@ -200,7 +224,10 @@ s
 #define SENSOR_HISTORY_SIZE 20
 
 #define MAX_LOG_ENTRIES 100
-#define MAX_TELEMETRY_QUEUE 50
+#define MAX_TELEMETRY_QUEUE 64 // Must be a power of two
+#define TELEMETRY_OUTAGE_RETENTION_S 60        // Link outage held without losing a sample
+#define TELEMETRY_BACKLOG_BYTES_PER_SAMPLE 16  // Packed batch budget; a steady scene runs 12-14
+#define TELEMETRY_BACKLOG_BYTES (TELEMETRY_OUTAGE_RETENTION_S * TELEMETRY_UPDATE_FREQUENCY_HZ * TELEMETRY_BACKLOG_BYTES_PER_SAMPLE)
 #define MAX_COMMAND_QUEUE 10
 #define MAX_ERROR_MESSAGES 20
 
@@ -0,0 +1,294 @@
+#include "dds_synth.h"
+
+// One full sine period, scaled to +/-127
+static const int8_t sineTable[DDS_TABLE_SIZE] PROGMEM = {
+    0, 3, 6, 9, 12, 16, 19, 22, 25, 28, 31, 34, 37, 40, 43, 46,
+    49, 51, 54, 57, 60, 63, 65, 68, 71, 73, 76, 78, 81, 83, 85, 88,
+    90, 92, 94, 96, 98, 100, 102, 104, 106, 107, 109, 111, 112, 113, 115, 116,
+    117, 118, 120, 121, 122, 122, 123, 124, 125, 125, 126, 126, 126, 127, 127, 127,
+    127, 127, 127, 127, 126, 126, 126, 125, 125, 124, 123, 122, 122, 121, 120, 118,
+    117, 116, 115, 113, 112, 111, 109, 107, 106, 104, 102, 100, 98, 96, 94, 92,
+    90, 88, 85, 83, 81, 78, 76, 73, 71, 68, 65, 63, 60, 57, 54, 51,
+    49, 46, 43, 40, 37, 34, 31, 28, 25, 22, 19, 16, 12, 9, 6, 3,
+    0, -3, -6, -9, -12, -16, -19, -22, -25, -28, -31, -34, -37, -40, -43, -46,
+    -49, -51, -54, -57, -60, -63, -65, -68, -71, -73, -76, -78, -81, -83, -85, -88,
+    -90, -92, -94, -96, -98, -100, -102, -104, -106, -107, -109, -111, -112, -113, -115, -116,
+    -117, -118, -120, -121, -122, -122, -123, -124, -125, -125, -126, -126, -126, -127, -127, -127,
+    -127, -127, -127, -127, -126, -126, -126, -125, -125, -124, -123, -122, -122, -121, -120, -118,
+    -117, -116, -115, -113, -112, -111, -109, -107, -106, -104, -102, -100, -98, -96, -94, -92,
+    -90, -88, -85, -83, -81, -78, -76, -73, -71, -68, -65, -63, -60, -57, -54, -51,
+    -49, -46, -43, -40, -37, -34, -31, -28, -25, -22, -19, -16, -12, -9, -6, -3};
+
+DdsSynthesizer::DdsSynthesizer()
+{
+    activeProgram = 0;
+    swapPending = false;
+    finished = true;
+    volume = 255;
+    sampleRate = 1;
+    phase = 0;
+    increment = 0;
+    incrementStep = 0;
+    incrementRatio = 0;
+    level = 0;
+    levelStep = 0;
+    gain = 0;
+    playing = false;
+    eventLeft = 0;
+    eventLength = 0;
+    segmentIndex = 0;
+    samplesLeft = 0;
+    cyclesDone = 0;
+    tailLeft = 0;
+
+    for (int i = 0; i < 2; i++)
+    {
+        programs[i].segmentCount = 0;
+        programs[i].repeatCount = 0;
+        programs[i].tailSamples = 0;
+    }
+}
+
+void DdsSynthesizer::begin(uint32_t rateHz)
+{
+    sampleRate = rateHz;
+}
+
+DdsProgram *DdsSynthesizer::editProgram()
+{
+    // A commit the interrupt has not picked up yet is withdrawn, so the back
+    // program is never read while it is being rewritten
+    noInterrupts();
+    swapPending = false;
+    interrupts();
+
+    return &programs[activeProgram ^ 1];
+}
+
+void DdsSynthesizer::commitProgram()
+{
+    swapPending = true;
+}
+
+void DdsSynthesizer::silence()
+{
+    noInterrupts();
+    swapPending = false;
+    playing = false;
+    finished = true;
+    interrupts();
+}
+
+void DdsSynthesizer::setVolume(uint8_t level)
+{
+    volume = level;
+}
+
+void DdsSynthesizer::startProgram()
+{
+    const DdsProgram &program = programs[activeProgram];
+
+    // Phase is deliberately left running so program changes do not click
+    segmentIndex = 0;
+    cyclesDone = 0;
+    tailLeft = program.tailSamples;
+    playing = program.segmentCount > 0 && program.repeatCount > 0;
+    finished = !playing && program.tailSamples == 0;
+
+    if (playing)
+    {
+        startSegment(program.segments[0]);
+    }
+}
+
+void DdsSynthesizer::startSegment(const DdsSegment &segment)
+{
+    increment = segment.phaseIncrement;
+    incrementStep = segment.incrementStep;
+    incrementRatio = segment.incrementRatio;
+    level = segment.level;
+    levelStep = segment.levelStep;
+    samplesLeft = segment.sampleCount;
+
+    // Ramps restart on the segment boundary so they land where compiled
+    gain = (level >> 16) * volume;
+    if (incrementRatio != 0)
+    {
+        uint32_t target = (uint32_t)(((uint64_t)increment * incrementRatio) >> 30);
+        incrementStep = ((int32_t)(target - increment)) / DDS_CONTROL_BLOCK;
+    }
+    scheduleEvent();
+}
+
+void DdsSynthesizer::scheduleEvent()
+{
+    eventLength = samplesLeft < DDS_CONTROL_BLOCK ? samplesLeft : DDS_CONTROL_BLOCK;
+    eventLeft = eventLength;
+}
+
+void DdsSynthesizer::updateControl()
+{
+    level += levelStep;
+    if (level < 0)
+    {
+        level = 0;
+    }
+    gain = (level >> 16) * volume;
+
+    // Exponential sweeps are followed piecewise-linearly, one 64-bit
+    // multiply per block instead of one per sample
+    if (incrementRatio != 0)
+    {
+        uint32_t target = (uint32_t)(((uint64_t)increment * incrementRatio) >> 30);
+        incrementStep = ((int32_t)(target - increment)) / DDS_CONTROL_BLOCK;
+    }
+}
+
+void DdsSynthesizer::handleEvent()
+{
+    samplesLeft -= eventLength;
+    if (samplesLeft > 0)
+    {
+        updateControl();
+        scheduleEvent();
+        return;
+    }
+
+    const DdsProgram &program = programs[activeProgram];
+    if (++segmentIndex >= program.segmentCount)
+    {
+        segmentIndex = 0;
+        if (cyclesDone < DDS_REPEAT_FOREVER - 1)
+        {
+            cyclesDone++;
+        }
+        if (program.repeatCount != DDS_REPEAT_FOREVER && cyclesDone >= program.repeatCount)
+        {
+            playing = false;
+            return;
+        }
+    }
+    startSegment(program.segments[segmentIndex]);
+}
+
+uint8_t DdsSynthesizer::idleSample()
+{
+    if (tailLeft > 0)
+    {
+        tailLeft--;
+    }
+    else
+    {
+        finished = true;
+    }
+    return DDS_OUTPUT_MIDPOINT;
+}
+
+uint8_t DdsSynthesizer::nextSample()
+{
+    if (swapPending)
+    {
+        activeProgram ^= 1;
+        swapPending = false;
+        startProgram();
+    }
+
+    if (!playing)
+        return finished ? DDS_OUTPUT_MIDPOINT : idleSample();
+
+    int sample = (int8_t)pgm_read_byte(&sineTable[phase >> (32 - DDS_TABLE_BITS)]);
+    phase += increment;
+    increment += incrementStep;
+    sample = (sample * gain) >> 16;
+
+    if (--eventLeft == 0)
+    {
+        handleEvent();
+    }
+
+    return DDS_OUTPUT_MIDPOINT + sample;
+}
+
+void DdsSynthesizer::render(uint8_t *output, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        output[i] = nextSample();
+    }
+}
+
+bool DdsSynthesizer::isFinished()
+{
+    return finished && !swapPending;
+}
+
+uint8_t DdsSynthesizer::getSegmentIndex()
+{
+    return segmentIndex;
+}
+
+uint8_t DdsSynthesizer::getSegmentTag()
+{
+    return programs[activeProgram].segments[segmentIndex].tag;
+}
+
+uint16_t DdsSynthesizer::getCyclesDone()
+{
+    return cyclesDone;
+}
+
+uint32_t DdsSynthesizer::getSampleRate()
+{
+    return sampleRate;
+}
+
+uint32_t DdsSynthesizer::frequencyToIncrement(float frequency)
+{
+    if (frequency <= 0.0 || sampleRate == 0)
+        return 0;
+
+    return (uint32_t)(frequency * 4294967296.0 / sampleRate + 0.5);
+}
+
+uint32_t DdsSynthesizer::millisToSamples(unsigned long ms)
+{
+    return (uint32_t)((uint64_t)ms * sampleRate / 1000);
+}
+
+bool DdsSynthesizer::appendSegment(DdsProgram &program, float startHz, float endHz, bool exponential,
+                                   float startLevel, float endLevel, uint32_t samples)
+{
+    if (samples == 0)
+        return true;
+    if (program.segmentCount >= DDS_MAX_SEGMENTS)
+        return false;
+
+    DdsSegment &segment = program.segments[program.segmentCount++];
+    uint32_t startIncrement = frequencyToIncrement(startHz);
+    uint32_t endIncrement = frequencyToIncrement(endHz);
+
+    segment.phaseIncrement = startIncrement;
+    segment.incrementStep = 0;
+    segment.incrementRatio = 0;
+    if (startIncrement != endIncrement)
+    {
+        if (exponential && startHz > 0.0 && endHz > 0.0)
+        {
+            float blocks = (float)samples / DDS_CONTROL_BLOCK;
+            segment.incrementRatio = (uint32_t)(pow(endHz / startHz, 1.0 / blocks) * 1073741824.0 + 0.5);
+        }
+        else
+        {
+            segment.incrementStep = (int32_t)(((int64_t)endIncrement - (int64_t)startIncrement) / (int64_t)samples);
+        }
+    }
+
+    startLevel = constrain(startLevel, 0.0, 1.0) * 255;
+    endLevel = constrain(endLevel, 0.0, 1.0) * 255;
+    uint32_t blocks = samples / DDS_CONTROL_BLOCK;
+    segment.level = (int32_t)(startLevel * 65536.0);
+    segment.levelStep = blocks > 0 ? (int32_t)((endLevel - startLevel) * 65536.0 / blocks) : 0;
+    segment.sampleCount = samples;
+    segment.tag = 0;
+    return true;
+}
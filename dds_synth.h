@@ -0,0 +1,93 @@
+#ifndef DDS_SYNTH_H
+#define DDS_SYNTH_H
+
+#include <Arduino.h>
+
+#define DDS_TABLE_BITS 8
+#define DDS_TABLE_SIZE (1 << DDS_TABLE_BITS)
+#define DDS_MAX_SEGMENTS 20
+#define DDS_CONTROL_BLOCK 32 // Samples between amplitude / exponential sweep updates
+#define DDS_REPEAT_FOREVER 0xFFFF
+#define DDS_OUTPUT_MIDPOINT 128
+
+// One stretch of a waveform, in sample units. Frequency and amplitude move
+// linearly (or, with incrementRatio, exponentially) from their start values;
+// every ramp is a running sum, so no per-sample transcendental is needed.
+struct DdsSegment
+{
+    uint32_t phaseIncrement; // 2^32 * frequency / sampleRate at the segment start
+    int32_t incrementStep;   // Linear sweep: added to the increment every sample
+    uint32_t incrementRatio; // Exponential sweep: Q30 factor per control block, 0 for none
+    int32_t level;           // Amplitude at the segment start, Q16 of 0-255
+    int32_t levelStep;       // Added to the level every control block
+    uint32_t sampleCount;    // At least 1
+    uint8_t tag;             // Caller's label, e.g. the pattern component
+};
+
+// A compiled pattern: the segment cycle is played repeatCount times, then
+// tailSamples of silence, after which the synthesizer reports finished.
+struct DdsProgram
+{
+    DdsSegment segments[DDS_MAX_SEGMENTS];
+    uint8_t segmentCount;
+    uint16_t repeatCount;
+    uint32_t tailSamples;
+};
+
+// Direct digital synthesis from a sine wavetable with a 32-bit phase
+// accumulator. nextSample() is cheap enough to run from the sample-rate timer
+// interrupt. Programs are double-buffered: the main loop fills the back
+// program and commits it, and the interrupt swaps it in between samples.
+class DdsSynthesizer
+{
+private:
+    DdsProgram programs[2];
+    volatile uint8_t activeProgram;
+    volatile bool swapPending;
+    volatile bool finished;
+    volatile uint8_t volume;
+
+    uint32_t sampleRate;
+    uint32_t phase;
+    uint32_t increment;
+    int32_t incrementStep;
+    uint32_t incrementRatio;
+    int32_t level;
+    int32_t levelStep;
+    int32_t gain; // level * volume, Q16
+    bool playing; // Inside the repeated segment cycle
+    uint32_t eventLeft; // Samples to the next control block or segment end
+    uint32_t eventLength;
+    uint8_t segmentIndex;
+    uint32_t samplesLeft; // In the current segment, as of the last event
+    uint16_t cyclesDone;
+    uint32_t tailLeft;
+
+    void startProgram();
+    void startSegment(const DdsSegment &segment);
+    void scheduleEvent();
+    void handleEvent();
+    void updateControl();
+    uint8_t idleSample();
+
+public:
+    DdsSynthesizer();
+    void begin(uint32_t rateHz);
+    DdsProgram *editProgram();
+    void commitProgram();
+    void silence();
+    void setVolume(uint8_t level);
+    uint8_t nextSample();
+    void render(uint8_t *output, int count);
+    bool isFinished();
+    uint8_t getSegmentIndex();
+    uint8_t getSegmentTag();
+    uint16_t getCyclesDone();
+    uint32_t getSampleRate();
+    uint32_t frequencyToIncrement(float frequency);
+    uint32_t millisToSamples(unsigned long ms);
+    bool appendSegment(DdsProgram &program, float startHz, float endHz, bool exponential, float startLevel,
+                       float endLevel, uint32_t samples);
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef DEADLINE_TIMER_H
+#define DEADLINE_TIMER_H
+
+#include <Arduino.h>
+
+// Millisecond deadline for cooperative code: instead of delay(), arm the
+// timer and poll expired() from update(). Comparisons are wrap-safe across
+// the 49-day millis() rollover.
+class DeadlineTimer
+{
+private:
+    unsigned long deadline;
+    bool armed;
+
+public:
+    DeadlineTimer() : deadline(0), armed(false) {}
+
+    void start(unsigned long delayMs)
+    {
+        deadline = millis() + delayMs;
+        armed = true;
+    }
+
+    // Periodic re-arm that keeps phase; restarts from now if a whole period
+    // was missed, so a long stall does not cause a burst of catch-up runs
+    void advance(unsigned long periodMs)
+    {
+        unsigned long now = millis();
+        deadline += periodMs;
+        if (!armed || (long)(now - deadline) >= (long)periodMs)
+        {
+            deadline = now + periodMs;
+        }
+        armed = true;
+    }
+
+    void cancel()
+    {
+        armed = false;
+    }
+
+    bool isArmed()
+    {
+        return armed;
+    }
+
+    bool expired()
+    {
+        return armed && (long)(millis() - deadline) >= 0;
+    }
+
+    unsigned long remaining()
+    {
+        if (!armed)
+            return 0;
+
+        long left = (long)(deadline - millis());
+        return left > 0 ? (unsigned long)left : 0;
+    }
+};
+
+#endif
@@ -0,0 +1,188 @@
+#include "deterrent_targeting.h"
+
+DeterrentTargeting::DeterrentTargeting()
+{
+    emitterCount = 0;
+    reset();
+}
+
+bool DeterrentTargeting::begin(const EmitterMount *mounts, int count)
+{
+    if (count <= 0 || count > TARGET_MAX_EMITTERS)
+        return false;
+
+    for (int i = 0; i < count; i++)
+    {
+        emitters[i] = mounts[i];
+    }
+    emitterCount = count;
+    reset();
+    return true;
+}
+
+// Evenly spaced emitters around the full circle, the first facing front,
+// each covering its share of it
+bool DeterrentTargeting::beginRing(int count)
+{
+    if (count <= 0 || count > TARGET_MAX_EMITTERS)
+        return false;
+
+    for (int i = 0; i < count; i++)
+    {
+        emitters[i].azimuth = 360.0 * i / count;
+        emitters[i].beamWidth = 360.0 / count;
+    }
+    emitterCount = count;
+    reset();
+    return true;
+}
+
+void DeterrentTargeting::reset()
+{
+    for (int i = 0; i < TARGET_MAX_EMITTERS; i++)
+    {
+        weights[i] = 0.0;
+        lastThreat[i] = 0;
+    }
+    activeMask = 0;
+    threatCount = 0;
+    peakThreat = 0.0;
+    uncovered = false;
+}
+
+// Proximity scaled by closing speed: a bird holding station counts half,
+// one closing at TARGET_CLOSING_REF_MPS or faster counts in full, and one
+// leaving at that speed not at all
+float DeterrentTargeting::threatWeight(const BirdObject &track)
+{
+    float proximity = constrain(1.0 - track.distance / TARGET_RANGE_CM, 0.0, 1.0);
+    float closing = constrain(track.velocity / TARGET_CLOSING_REF_MPS, -1.0, 1.0);
+    return proximity * (1.0 + closing) * 0.5;
+}
+
+float DeterrentTargeting::azimuthDifference(float a, float b)
+{
+    float diff = fmod(fabs(a - b), 360.0);
+    return diff > 180.0 ? 360.0 - diff : diff;
+}
+
+float DeterrentTargeting::coverage(const EmitterMount &emitter, float azimuth)
+{
+    float outside = azimuthDifference(emitter.azimuth, azimuth) - emitter.beamWidth / 2;
+    if (outside <= 0.0)
+        return 1.0;
+    return max(0.0, 1.0 - outside / TARGET_AZIMUTH_MARGIN_DEG);
+}
+
+void DeterrentTargeting::update(const BirdObject *tracks, int count, unsigned long now)
+{
+    for (int e = 0; e < emitterCount; e++)
+    {
+        weights[e] = 0.0;
+    }
+    threatCount = 0;
+    peakThreat = 0.0;
+    uncovered = false;
+
+    for (int i = 0; i < count; i++)
+    {
+        const BirdObject &track = tracks[i];
+        if (!track.confirmed)
+            continue;
+
+        float threat = threatWeight(track);
+        if (threat < TARGET_RELEASE_WEIGHT)
+            continue;
+
+        threatCount++;
+        peakThreat = max(peakThreat, threat);
+        float bestCover = 0.0;
+        for (int e = 0; e < emitterCount; e++)
+        {
+            float cover = coverage(emitters[e], track.azimuth);
+            weights[e] = max(weights[e], threat * cover);
+            bestCover = max(bestCover, cover);
+        }
+        if (threat >= TARGET_ACTIVATE_WEIGHT && threat * bestCover < TARGET_ACTIVATE_WEIGHT)
+        {
+            uncovered = true;
+        }
+    }
+
+    uint16_t mask = 0;
+    for (int e = 0; e < emitterCount; e++)
+    {
+        bool wasActive = activeMask & (1 << e);
+        if (weights[e] >= (wasActive ? TARGET_RELEASE_WEIGHT : TARGET_ACTIVATE_WEIGHT))
+        {
+            lastThreat[e] = now;
+            mask |= 1 << e;
+        }
+        else if (wasActive && now - lastThreat[e] < TARGET_HOLD_MS)
+        {
+            mask |= 1 << e;
+        }
+    }
+    activeMask = uncovered ? getAllMask() : mask;
+}
+
+uint16_t DeterrentTargeting::getActiveMask()
+{
+    return activeMask;
+}
+
+uint16_t DeterrentTargeting::getAllMask()
+{
+    return emitterCount >= 16 ? 0xFFFF : (uint16_t)((1 << emitterCount) - 1);
+}
+
+float DeterrentTargeting::getWeight(int emitter)
+{
+    return emitter >= 0 && emitter < emitterCount ? weights[emitter] : 0.0;
+}
+
+// Output level for an emitter that can be driven below full: zero while it
+// is off, full from TARGET_FULL_DRIVE_WEIGHT up, and never below the
+// activation weight's share while it is held on
+float DeterrentTargeting::getDrive(int emitter)
+{
+    if (emitter < 0 || emitter >= emitterCount || !(activeMask & (1 << emitter)))
+        return 0.0;
+    if (uncovered)
+        return 1.0;
+    float weight = max(weights[emitter], (float)TARGET_ACTIVATE_WEIGHT);
+    return min(1.0, weight / TARGET_FULL_DRIVE_WEIGHT);
+}
+
+int DeterrentTargeting::getEmitterCount()
+{
+    return emitterCount;
+}
+
+int DeterrentTargeting::getActiveCount()
+{
+    int active = 0;
+    for (int e = 0; e < emitterCount; e++)
+    {
+        if (activeMask & (1 << e))
+        {
+            active++;
+        }
+    }
+    return active;
+}
+
+int DeterrentTargeting::getThreatCount()
+{
+    return threatCount;
+}
+
+float DeterrentTargeting::getPeakThreat()
+{
+    return peakThreat;
+}
+
+bool DeterrentTargeting::hasUncoveredThreat()
+{
+    return uncovered;
+}
@@ -0,0 +1,64 @@
+#ifndef DETERRENT_TARGETING_H
+#define DETERRENT_TARGETING_H
+
+#include <Arduino.h>
+#include "bird_tracker.h"
+#include "sensor_array.h"
+
+#define TARGET_MAX_EMITTERS 16
+#define TARGET_RANGE_CM RANGING_MAX_RANGE_CM     // Threat is zero at the edge of ranging
+#define TARGET_CLOSING_REF_MPS 5.0               // Closing speed that doubles a bird's threat
+#define TARGET_AZIMUTH_MARGIN_DEG (SENSOR_DEFAULT_BEAM_WIDTH_DEG / 2) // A track's bearing is a sensor boresight
+#define TARGET_ACTIVATE_WEIGHT 0.10              // Emitter switches on at this weight
+#define TARGET_RELEASE_WEIGHT 0.05               // ...and off below this, after the hold time
+#define TARGET_HOLD_MS 1500                      // Keeps an emitter on while a bird crosses between beams
+#define TARGET_FULL_DRIVE_WEIGHT 0.3              // Weight at which getDrive() reaches full output
+
+// Where one deterrent emitter points
+struct EmitterMount
+{
+    float azimuth;   // Boresight bearing, degrees clockwise from front
+    float beamWidth; // Full width it covers at full effect, degrees
+};
+
+// Maps confirmed tracks onto a ring of deterrent emitters (LED segments,
+// speakers). Each track gets a threat weight from its range and closing
+// speed; each emitter takes the strongest threat inside its beam, fading
+// out over TARGET_AZIMUTH_MARGIN_DEG past the edge. Emitters switch on and
+// off on that weight with hysteresis and a hold time, so only the ones
+// facing birds draw power. A threat no emitter covers switches every emitter
+// on rather than none.
+class DeterrentTargeting
+{
+private:
+    EmitterMount emitters[TARGET_MAX_EMITTERS];
+    float weights[TARGET_MAX_EMITTERS];
+    unsigned long lastThreat[TARGET_MAX_EMITTERS];
+    uint16_t activeMask;
+    int emitterCount;
+    int threatCount;
+    float peakThreat;
+    bool uncovered;
+
+    static float azimuthDifference(float a, float b);
+    static float coverage(const EmitterMount &emitter, float azimuth);
+
+public:
+    DeterrentTargeting();
+    bool begin(const EmitterMount *mounts, int count);
+    bool beginRing(int count);
+    void reset();
+    void update(const BirdObject *tracks, int count, unsigned long now);
+    uint16_t getActiveMask();
+    uint16_t getAllMask();
+    float getWeight(int emitter);
+    float getDrive(int emitter);
+    int getEmitterCount();
+    int getActiveCount();
+    int getThreatCount();
+    float getPeakThreat();
+    bool hasUncoveredThreat();
+    static float threatWeight(const BirdObject &track);
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef EMERGENCY_SYSTEM_H
+#define EMERGENCY_SYSTEM_H
+
+#include <Arduino.h>
+
+#define MAX_HEALTH_ISSUES 10
+#define MAX_EMERGENCY_ACTIVATIONS 3
+#define EMERGENCY_TIMEOUT_MS 30000
+#define EMERGENCY_BEACON_DURATION_MS 60000
+
+enum EmergencyState
+{
+    EMERGENCY_IDLE = 0,
+    EMERGENCY_ACTIVE = 1,
+    EMERGENCY_RECOVERING = 2,
+    EMERGENCY_LOCKOUT = 3
+};
+
+// Reasons and issue codes are kept by pointer: pass string literals
+struct HealthIssue
+{
+    const char *code;
+    unsigned long firstReported;
+    unsigned long lastReported;
+    int occurrences;
+};
+
+class EmergencySystem
+{
+private:
+    int servoPin;
+    EmergencyState currentState;
+    const char *activeReason;
+    unsigned long activationTime;
+    int activationCount;
+    HealthIssue healthIssues[MAX_HEALTH_ISSUES];
+    int healthIssueCount;
+
+public:
+    EmergencySystem();
+    bool begin(int servoPin);
+    void update();
+    void activateEmergencyMode(const char *reason);
+    bool isEmergencyResolved();
+    void reportHealthIssue(const char *issue);
+    void clearHealthIssues();
+    const char *getHealthStatus(char *buffer, size_t size);
+    int getHealthIssueCount();
+    EmergencyState getCurrentState();
+    int getActivationCount();
+    bool selfTest();
+};
+
+#endif
@@ -3,30 +3,36 @@
 import sys
 import json
 import time
+import asyncio
 import logging
 import sqlite3
+import struct
 import threading
+import queue
+import random
+import re
+import zlib
 from datetime import datetime, timedelta
 from dataclasses import dataclass, asdict
-from typing import Dict, List, Optional, Tuple
+from typing import Callable, Dict, List, Optional, Tuple
 from pathlib import Path
 
-import numpy as np
-import matplotlib.pyplot as plt
-from matplotlib.animation import FuncAnimation
-from matplotlib.backends.backend_qt5agg import FigureCanvasQTAgg as FigureCanvas
-from matplotlib.figure import Figure
-
+# GUI and link dependencies are only needed for the live station; the data
+# layer (decoder, database, benchmarks) runs without them.
 try:
+    import numpy as np
+    import matplotlib.pyplot as plt
+    from matplotlib.animation import FuncAnimation
+    from matplotlib.backends.backend_qt5agg import FigureCanvasQTAgg as FigureCanvas
+    from matplotlib.figure import Figure
     from PyQt5.QtWidgets import *
     from PyQt5.QtCore import *
     from PyQt5.QtGui import *
     import serial
     import requests
+    MISSING_DEPENDENCY = None
 except ImportError as e:
-    print(f"Missing dependency: {e}")
-    print("Install with: pip install PyQt5 matplotlib numpy pyserial requests")
-    sys.exit(1)
+    MISSING_DEPENDENCY = e
 
 CONFIG = {
     'serial_port': '/dev/ttyUSB0',
@@ -34,7 +40,13 @@ CONFIG = {
     'update_interval': 1000,  
     'log_file': 'bird_deterrent.log',
     'database_file': 'telemetry.db',
+    'archive_dir': 'telemetry_archive',
+    'units': {'/dev/ttyUSB0': 'unit-1'},  # serial port -> unit id
+    'ingest_port': 7600,  # TCP telemetry sources
+    'max_unit_id_length': 64,  # bytes; archive headers store strings with a one-byte length
     'backup_interval': 3600,  # seconds
+    'db_flush_interval': 0.5,  # seconds between batched commits
+    'db_max_batch': 5000,  # rows per transaction
     'alert_thresholds': {
         'battery_low': 11.0,
         'temperature_high': 60.0,
@@ -46,7 +58,7 @@ CONFIG = {
 @dataclass
 class TelemetryData:
     """Structure for telemetry data from drone"""
-    timestamp: float
+    timestamp: float  # Unix time once ingested (see UptimeClock)
     state: str
     battery_voltage: float
     temperature: float
@@ -58,6 +70,8 @@ class TelemetryData:
     longitude: float = 0.0
     altitude: float = 0.0
     heading: float = 0.0
+    unit_id: str = ''
+    uptime: float = 0.0  # Drone millis() when sampled, s
 
 @dataclass
 class SystemStatus:
@@ -73,19 +87,892 @@ class SystemStatus:
         if self.alerts is None:
             self.alerts = []
 
+# Binary telemetry protocol (see telemetry_protocol.h on the drone side).
+# Frames are COBS-encoded between 0x00 delimiters; after decoding:
+#   version | type | sequence | zigzag varint fields | CRC16-CCITT (big endian)
+TELEMETRY_PROTOCOL_VERSION = 1
+TELEMETRY_FRAME_KEY = 0
+TELEMETRY_FRAME_DELTA = 1
+TELEMETRY_FRAME_PERF = 2
+TELEMETRY_FRAME_BATCH = 3
+TELEMETRY_FRAME_TRACKS = 4
+TELEMETRY_FIELD_COUNT = 10
+TELEMETRY_HEADER_SIZE = 3
+
+SYSTEM_STATES = ['STANDBY', 'ALERT', 'ACTIVE_DETERRENT', 'EMERGENCY', 'MAINTENANCE']
+WEATHER_CONDITIONS = ['CLEAR', 'LIGHT_RAIN', 'HEAVY_RAIN', 'SNOW', 'HIGH_WIND', 'STORM', 'EXTREME']
+PERF_PROBES = ['detection', 'visual', 'audio', 'weather', 'telemetry']
+TRACK_EVENT_KINDS = ['UPDATE', 'NEW', 'LOST']
+TRACK_EVENT_FIELDS = 6
+TRACK_TIMEOUT_S = 5.0  # Drone refreshes live tracks every 2 s
+TRACK_HISTORY_POINTS = 50
+PLOT_SERIES_CAPACITY = 4 ** 10  # Samples kept per plotted field, about 29 h at 10 Hz
+PLOT_SPAN_S = 600.0
+PLOT_FIELDS = ('battery_voltage', 'temperature', 'bird_count', 'closest_bird_distance')
+
+
+@dataclass
+class TrackEvent:
+    """One per-track report from the detection event stream"""
+    timestamp: float  # Unix time once ingested (see UptimeClock)
+    track_id: int
+    kind: str
+    range_cm: float
+    azimuth: float
+    velocity: float  # m/s, positive when closing
+    confidence: int
+    unit_id: str = ''
+    uptime: float = 0.0  # Drone millis() when reported, s
+
+
+def crc16_ccitt(data: bytes, crc: int = 0xFFFF) -> int:
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(data: bytes) -> Optional[bytes]:
+    """Undo COBS stuffing of one frame (without delimiters); None if malformed"""
+    output = bytearray()
+    index = 0
+    while index < len(data):
+        code = data[index]
+        end = index + code
+        if code == 0 or end > len(data):
+            return None
+        output += data[index + 1:end]
+        index = end
+        if code < 0xFF and index < len(data):
+            output.append(0)
+    return bytes(output)
+
+
+def cobs_encode(data: bytes) -> bytes:
+    output = bytearray([0])
+    code_index = 0
+    code = 1
+    for byte in data:
+        if byte:
+            output.append(byte)
+            code += 1
+        if not byte or code == 0xFF:
+            output[code_index] = code
+            code_index = len(output)
+            output.append(0)
+            code = 1
+    output[code_index] = code
+    return bytes(output)
+
+
+def read_varint(data: bytes, offset: int) -> Tuple[int, int]:
+    """Decode one zigzag LEB128 value; returns (value, next offset)"""
+    result = 0
+    shift = 0
+    while True:
+        if offset >= len(data) or shift > 28:
+            raise ValueError("truncated varint")
+        byte = data[offset]
+        offset += 1
+        result |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            break
+    result &= 0xFFFFFFFF
+    return (result >> 1) ^ -(result & 1), offset
+
+
+def to_int32(value: int) -> int:
+    value &= 0xFFFFFFFF
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+class TelemetryDecoder:
+    """Reassembles binary telemetry frames from a serial byte stream.
+
+    Delta frames are applied on top of the last key frame chain; after a
+    lost or corrupt frame they are ignored until the next key frame. Batch
+    frames (store-and-forward uplink) are self-contained: the first sample
+    is absolute and the rest are deltas within the batch.
+    Anything between delimiters that fails COBS or CRC (for example text
+    log lines) is counted and dropped.
+    """
+
+    def __init__(self):
+        self.buffer = bytearray()
+        self.values: Optional[List[int]] = None
+        self.last_sequence: Optional[int] = None
+        self.perf: Dict[str, Dict[str, int]] = {}
+        self.track_events: List[TrackEvent] = []
+        self.frames = 0
+        self.rejected = 0
+        self.resyncs = 0
+
+    def feed(self, data: bytes) -> List[TelemetryData]:
+        samples = []
+        self.buffer += data
+        while True:
+            end = self.buffer.find(b'\x00')
+            if end < 0:
+                break
+            chunk = bytes(self.buffer[:end])
+            del self.buffer[:end + 1]
+            if chunk:
+                samples.extend(self.decode_frame(chunk))
+        return samples
+
+    def decode_frame(self, chunk: bytes) -> List[TelemetryData]:
+        frame = cobs_decode(chunk)
+        if frame is None or len(frame) < TELEMETRY_HEADER_SIZE + 2:
+            self.rejected += 1
+            return []
+        body, crc = frame[:-2], (frame[-2] << 8) | frame[-1]
+        if crc16_ccitt(body) != crc or body[0] != TELEMETRY_PROTOCOL_VERSION:
+            self.rejected += 1
+            return []
+
+        frame_type, sequence = body[1], body[2]
+        fields = []
+        offset = TELEMETRY_HEADER_SIZE
+        try:
+            while offset < len(body):
+                value, offset = read_varint(body, offset)
+                fields.append(value)
+        except ValueError:
+            self.rejected += 1
+            return []
+
+        in_order = self.last_sequence is not None and sequence == (self.last_sequence + 1) & 0xFF
+        self.last_sequence = sequence
+        self.frames += 1
+
+        if frame_type == TELEMETRY_FRAME_PERF:
+            for i, name in enumerate(PERF_PROBES):
+                if len(fields) >= (i + 1) * 4:
+                    self.perf[name] = dict(zip(('min', 'mean', 'p99', 'max'), fields[i * 4:i * 4 + 4]))
+            if not in_order:
+                self.values = None
+            return []
+
+        if frame_type == TELEMETRY_FRAME_TRACKS:
+            if not fields or (len(fields) - 1) % TRACK_EVENT_FIELDS:
+                self.rejected += 1
+                return []
+            uptime = (fields[0] & 0xFFFFFFFF) / 1000.0
+            for start in range(1, len(fields), TRACK_EVENT_FIELDS):
+                track_id, kind, range_mm, azimuth, velocity, confidence = fields[start:start + TRACK_EVENT_FIELDS]
+                self.track_events.append(TrackEvent(
+                    timestamp=uptime,
+                    track_id=track_id,
+                    kind=TRACK_EVENT_KINDS[kind] if 0 <= kind < len(TRACK_EVENT_KINDS) else 'UNKNOWN',
+                    range_cm=range_mm / 10.0,
+                    azimuth=azimuth / 10.0,
+                    velocity=velocity / 100.0,
+                    confidence=confidence,
+                    uptime=uptime))
+            return []
+
+        if frame_type == TELEMETRY_FRAME_BATCH:
+            if not fields or len(fields) % TELEMETRY_FIELD_COUNT:
+                self.rejected += 1
+                return []
+            samples = []
+            values = [0] * TELEMETRY_FIELD_COUNT
+            for start in range(0, len(fields), TELEMETRY_FIELD_COUNT):
+                deltas = fields[start:start + TELEMETRY_FIELD_COUNT]
+                values = [to_int32(a + d) for a, d in zip(values, deltas)]
+                samples.append(self.to_telemetry(values))
+            return samples
+
+        if len(fields) < TELEMETRY_FIELD_COUNT:
+            self.rejected += 1
+            return []
+        if frame_type == TELEMETRY_FRAME_KEY:
+            self.values = [to_int32(v) for v in fields[:TELEMETRY_FIELD_COUNT]]
+        elif frame_type == TELEMETRY_FRAME_DELTA and self.values is not None and in_order:
+            self.values = [to_int32(a + d) for a, d in zip(self.values, fields[:TELEMETRY_FIELD_COUNT])]
+        else:
+            if self.values is not None:
+                self.resyncs += 1
+            self.values = None
+            return []
+
+        return [self.to_telemetry(self.values)]
+
+    def take_track_events(self) -> List[TrackEvent]:
+        events, self.track_events = self.track_events, []
+        return events
+
+    @staticmethod
+    def to_telemetry(values: List[int]) -> TelemetryData:
+        """Samples carry the drone's uptime as their timestamp until
+        IngestServer maps it onto wall-clock time"""
+        (uptime_ms, state, battery_mv, temperature_cc, bird_count, closest_mm,
+         condition, weather_critical, emergency_state, health_issues) = values[:TELEMETRY_FIELD_COUNT]
+        return TelemetryData(
+            timestamp=(uptime_ms & 0xFFFFFFFF) / 1000.0,
+            state=SYSTEM_STATES[state] if 0 <= state < len(SYSTEM_STATES) else 'UNKNOWN',
+            battery_voltage=battery_mv / 1000.0,
+            temperature=temperature_cc / 100.0,
+            bird_count=bird_count,
+            closest_bird_distance=closest_mm / 10.0,
+            weather_status='CRITICAL' if weather_critical else
+                WEATHER_CONDITIONS[condition] if 0 <= condition < len(WEATHER_CONDITIONS) else 'UNKNOWN',
+            system_health='OK' if health_issues == 0 else f'ISSUES:{health_issues}',
+            uptime=(uptime_ms & 0xFFFFFFFF) / 1000.0)
+
+class LiveTrackPlot:
+    """Polar plot of the drones' live bird tracks fed from the event stream.
+
+    Each track keeps a short trail of reported positions; tracks are removed
+    on a LOST event or when no report arrives within TRACK_TIMEOUT_S. Event
+    timestamps are Unix time as stamped by IngestServer, so expire() and
+    refresh() take time.time(). sink() is an IngestServer sink: it only
+    queues, and refresh() applies the queued events on the UI thread.
+    """
+
+    def __init__(self, figure: 'Figure', max_range_cm: float = 400.0):
+        self.axes = figure.add_subplot(111, projection='polar')
+        self.axes.set_theta_zero_location('N')
+        self.axes.set_theta_direction(-1)  # Azimuth is clockwise from the nose
+        self.axes.set_rmax(max_range_cm)
+        self.axes.set_title('Live bird tracks (cm)')
+        self.tracks: Dict[Tuple[str, int], List[TrackEvent]] = {}
+        self.artists: Dict[Tuple[str, int], Tuple[object, object]] = {}
+        self.incoming: 'queue.Queue[List[TrackEvent]]' = queue.Queue()
+
+    def sink(self, samples: List[TelemetryData], events: List[TrackEvent]):
+        if events:
+            self.incoming.put(events)
+
+    def apply(self, events: List[TrackEvent]):
+        for event in events:
+            key = (event.unit_id, event.track_id)
+            if event.kind == 'LOST':
+                self.tracks.pop(key, None)
+                continue
+            trail = self.tracks.setdefault(key, [])
+            trail.append(event)
+            del trail[:-TRACK_HISTORY_POINTS]
+
+    def expire(self, now: float):
+        for key in [k for k, trail in self.tracks.items() if now - trail[-1].timestamp > TRACK_TIMEOUT_S]:
+            del self.tracks[key]
+
+    def refresh(self, now: float):
+        while True:
+            try:
+                self.apply(self.incoming.get_nowait())
+            except queue.Empty:
+                break
+        self.expire(now)
+        self.redraw()
+
+    def redraw(self):
+        for key in list(self.artists):
+            if key not in self.tracks:
+                trail_line, head = self.artists.pop(key)
+                trail_line.remove()
+                head.remove()
+        for key, trail in self.tracks.items():
+            theta = np.radians([e.azimuth for e in trail])
+            radius = [e.range_cm for e in trail]
+            if key not in self.artists:
+                trail_line, = self.axes.plot(theta, radius, '-', alpha=0.4)
+                head, = self.axes.plot(theta[-1:], radius[-1:], 'o', color=trail_line.get_color())
+                self.artists[key] = (trail_line, head)
+            else:
+                trail_line, head = self.artists[key]
+                trail_line.set_data(theta, radius)
+                head.set_data(theta[-1:], radius[-1:])
+            unit_id, track_id = key
+            head.set_label(f'{unit_id} #{track_id} {trail[-1].velocity:+.1f} m/s')
+        if self.artists:
+            self.axes.legend(loc='lower left', fontsize='small')
+        self.axes.figure.canvas.draw_idle()
+
+
+class DecimatedSeries:
+    """Ring buffer of (time, value) samples with an incrementally maintained
+    min/max pyramid: level k summarises blocks of 4**k samples. A window
+    query picks the level whose blocks fit the requested number of points
+    and emits a min and a max per block, so the cost depends on the screen
+    width, not on how many samples are stored. Appends touch one block per
+    level. Timestamps must not decrease."""
+
+    def __init__(self, capacity: int = PLOT_SERIES_CAPACITY):
+        levels = (capacity.bit_length() - 1) // 2
+        if capacity != 4 ** levels:
+            raise ValueError("capacity must be a power of 4")
+        self.capacity = capacity
+        self.levels = levels
+        self.times = [0.0] * capacity
+        self.values = [0.0] * capacity
+        # One spare block per level: a window that is not block aligned spans
+        # one more block than the ring holds whole
+        self.mins = [[0.0] * ((capacity >> (2 * k)) + 1) for k in range(levels + 1)]
+        self.maxs = [[0.0] * ((capacity >> (2 * k)) + 1) for k in range(levels + 1)]
+        self.starts = [[0.0] * ((capacity >> (2 * k)) + 1) for k in range(levels + 1)]
+        self.count = 0
+
+    def __len__(self) -> int:
+        return min(self.count, self.capacity)
+
+    def append(self, timestamp: float, value: float):
+        index = self.count
+        slot = index & (self.capacity - 1)
+        self.times[slot] = timestamp
+        self.values[slot] = value
+        for k in range(1, self.levels + 1):
+            shift = 2 * k
+            mins, maxs = self.mins[k], self.maxs[k]
+            block = (index >> shift) % len(mins)
+            if index & ((1 << shift) - 1) == 0:
+                mins[block] = maxs[block] = value
+                self.starts[k][block] = timestamp
+            else:
+                if value < mins[block]:
+                    mins[block] = value
+                if value > maxs[block]:
+                    maxs[block] = value
+        self.count = index + 1
+
+    def time_at(self, index: int) -> float:
+        return self.times[index & (self.capacity - 1)]
+
+    def search(self, timestamp: float) -> int:
+        """First stored index whose time is >= timestamp"""
+        low, high = self.count - len(self), self.count
+        while low < high:
+            middle = (low + high) // 2
+            if self.time_at(middle) < timestamp:
+                low = middle + 1
+            else:
+                high = middle
+        return low
+
+    def window(self, start: float, end: float, points: int) -> Tuple[List[float], List[float]]:
+        """At most 2 * points vertices covering samples in [start, end)"""
+        low, high = self.search(start), self.search(end)
+        mask = self.capacity - 1
+        if high - low <= 2 * points:
+            slots = [index & mask for index in range(low, high)]
+            return [self.times[slot] for slot in slots], [self.values[slot] for slot in slots]
+
+        level = 1
+        while level < self.levels and ((high - 1) >> (2 * level)) - (low >> (2 * level)) >= points:
+            level += 1
+        shift = 2 * level
+        mins, maxs, starts = self.mins[level], self.maxs[level], self.starts[level]
+        blocks = len(mins)
+        xs: List[float] = []
+        ys: List[float] = []
+        for block in range(low >> shift, ((high - 1) >> shift) + 1):
+            slot = block % blocks
+            timestamp = starts[slot] if block << shift >= low else self.times[low & mask]
+            xs += (timestamp, timestamp)
+            ys += (mins[slot], maxs[slot])
+        return xs, ys
+
+
+class StripChart:
+    """Scrolling telemetry plots redrawn by blitting.
+
+    Samples go into a DecimatedSeries per field; each refresh asks for one
+    min/max pair per horizontal pixel and blits only the lines over a cached
+    background. The time axis jumps by half a span when the data reaches
+    the right edge, and the value axes widen when the data leaves them;
+    only those cases pay for a full redraw.
+    """
+
+    def __init__(self, figure: 'Figure', fields: Tuple[str, ...] = PLOT_FIELDS, span: float = PLOT_SPAN_S):
+        self.figure = figure
+        self.span = span
+        self.series = {field: DecimatedSeries() for field in fields}
+        self.axes = {}
+        self.lines = {}
+        first = None
+        for index, field in enumerate(fields):
+            axes = figure.add_subplot(len(fields), 1, index + 1, sharex=first)
+            axes.set_ylabel(field.replace('_', ' '))
+            line, = axes.plot([], [], '-', linewidth=0.8, animated=True)
+            self.axes[field] = axes
+            self.lines[field] = line
+            first = first or axes
+        self.start: Optional[float] = None
+        self.background = None
+        figure.canvas.mpl_connect('draw_event', self.on_draw)
+
+    def append(self, data: TelemetryData):
+        for field, series in self.series.items():
+            series.append(data.timestamp, getattr(data, field))
+
+    def on_draw(self, event):
+        self.background = self.figure.canvas.copy_from_bbox(self.figure.bbox)
+        for field, line in self.lines.items():
+            self.axes[field].draw_artist(line)
+
+    def refresh(self):
+        series = next(iter(self.series.values()))
+        if not len(series):
+            return
+        latest = series.time_at(series.count - 1)
+        full = self.background is None
+        if self.start is None or latest >= self.start + self.span:
+            self.start = latest - self.span / 2 if self.start is not None else latest
+            for axes in self.axes.values():
+                axes.set_xlim(self.start, self.start + self.span)
+            full = True
+
+        for field, line in self.lines.items():
+            axes = self.axes[field]
+            xs, ys = self.series[field].window(self.start, self.start + self.span, max(1, int(axes.bbox.width)))
+            line.set_data(xs, ys)
+            if ys:
+                bottom, top = axes.get_ylim()
+                low, high = min(ys), max(ys)
+                if low < bottom or high > top:
+                    margin = (high - low) * 0.1 or 1.0
+                    axes.set_ylim(min(low, bottom) - margin, max(high, top) + margin)
+                    full = True
+
+        canvas = self.figure.canvas
+        if full:
+            canvas.draw()  # on_draw recaptures the background and draws the lines
+        else:
+            canvas.restore_region(self.background)
+            for field, line in self.lines.items():
+                self.axes[field].draw_artist(line)
+            canvas.blit(self.figure.bbox)
+
+
+TELEMETRY_COLUMNS = ('timestamp', 'state', 'battery_voltage', 'temperature', 'bird_count',
+                     'closest_bird_distance', 'weather_status', 'system_health',
+                     'latitude', 'longitude', 'altitude', 'heading', 'unit_id', 'uptime')
+INSERT_TELEMETRY_SQL = (f"INSERT INTO telemetry ({', '.join(TELEMETRY_COLUMNS)}) "
+                        f"VALUES ({', '.join('?' * len(TELEMETRY_COLUMNS))})")
+INSERT_EVENT_SQL = "INSERT INTO events (timestamp, event_type, description, severity) VALUES (?, ?, ?, ?)"
+TRACK_EVENT_COLUMNS = ('timestamp', 'track_id', 'kind', 'range_cm', 'azimuth', 'velocity', 'confidence',
+                       'unit_id', 'uptime')
+INSERT_TRACK_EVENT_SQL = (f"INSERT INTO track_events ({', '.join(TRACK_EVENT_COLUMNS)}) "
+                          f"VALUES ({', '.join('?' * len(TRACK_EVENT_COLUMNS))})")
+
+
+# Columnar archive: one file per time partition, holding each telemetry
+# column separately (scaled to integers, delta + zigzag varint coded, or
+# dictionary coded for strings) and zlib-compressed. The chunk header carries
+# min/max/sum zone maps for the whole chunk and for fixed segments within it,
+# so range scans skip chunks that cannot match and coarse downsampled
+# queries are answered from headers without touching column data. Headers
+# are also appended to a manifest, so opening the archive is one read.
+ARCHIVE_MAGIC = b'TCA1'
+ARCHIVE_SUFFIX = '.tchunk'
+ARCHIVE_MANIFEST = 'manifest.tca'
+ARCHIVE_PARTITION_S = 3600
+ARCHIVE_SEGMENTS = 12  # Zone-map granularity within a chunk (5 min at 1 h partitions)
+
+# name -> scale for numeric columns (stored as round(value * scale)), None for strings
+ARCHIVE_COLUMNS = {
+    'timestamp': 1000,
+    'state': None,
+    'battery_voltage': 1000,
+    'temperature': 100,
+    'bird_count': 1,
+    'closest_bird_distance': 10,
+    'weather_status': None,
+    'system_health': None,
+    'latitude': 10000000,
+    'longitude': 10000000,
+    'altitude': 100,
+    'heading': 10,
+    'unit_id': None,
+}
+ARCHIVE_NUMERIC = [name for name, scale in ARCHIVE_COLUMNS.items() if scale is not None]
+ARCHIVE_STRINGS = [name for name, scale in ARCHIVE_COLUMNS.items() if scale is None]
+ARCHIVE_ZONE = struct.Struct(f"<3d{3 * len(ARCHIVE_NUMERIC)}d")  # start, end, rows, then min/max/sum per column
+
+
+def encode_varints(values: List[int]) -> bytes:
+    output = bytearray()
+    for value in values:
+        value = (value << 1) ^ (value >> 63)  # zigzag
+        while value >= 0x80:
+            output.append((value & 0x7F) | 0x80)
+            value >>= 7
+        output.append(value)
+    return bytes(output)
+
+
+def decode_varints(data: bytes, count: int) -> List[int]:
+    values = []
+    value = shift = 0
+    for byte in data:
+        value |= (byte & 0x7F) << shift
+        if byte & 0x80:
+            shift += 7
+            continue
+        values.append((value >> 1) ^ -(value & 1))
+        value = shift = 0
+    if len(values) != count:
+        raise ValueError("column length mismatch")
+    return values
+
+
+@dataclass
+class ChunkHeader:
+    """Zone entries are (start, end, rows, min, max, sum per numeric column);
+    zones[0] covers the chunk, the rest its non-empty segments"""
+    name: str
+    zones: List[tuple]
+    columns: List[Tuple[int, int]]  # (offset, length) after the header, in ARCHIVE_COLUMNS order
+    dictionaries: Dict[str, List[str]]
+    data_offset: int
+
+    @property
+    def start(self) -> float:
+        return self.zones[0][0]
+
+    @property
+    def end(self) -> float:
+        return self.zones[0][1]
+
+    @property
+    def rows(self) -> int:
+        return int(self.zones[0][2])
+
+    def zone(self, index: int, column: str) -> Tuple[float, float, float]:
+        base = 3 + 3 * ARCHIVE_NUMERIC.index(column)
+        return self.zones[index][base:base + 3]
+
+
+def pack_chunk_header(zones: List[tuple], columns: List[Tuple[int, int]],
+                      dictionaries: Dict[str, List[str]]) -> bytes:
+    body = bytearray(struct.pack('<H', len(zones)))
+    for zone in zones:
+        body += ARCHIVE_ZONE.pack(*zone)
+    for offset, length in columns:
+        body += struct.pack('<II', offset, length)
+    for name in ARCHIVE_STRINGS:
+        body += struct.pack('<H', len(dictionaries[name]))
+        for value in dictionaries[name]:
+            encoded = value.encode()
+            body += struct.pack('<B', len(encoded)) + encoded
+    return zlib.compress(bytes(body), 6)
+
+
+def unpack_chunk_header(name: str, blob: bytes, data_offset: int) -> ChunkHeader:
+    body = zlib.decompress(blob)
+    (count,) = struct.unpack_from('<H', body, 0)
+    offset = 2
+    zones = []
+    for _ in range(count):
+        zones.append(ARCHIVE_ZONE.unpack_from(body, offset))
+        offset += ARCHIVE_ZONE.size
+    columns = []
+    for _ in ARCHIVE_COLUMNS:
+        columns.append(struct.unpack_from('<II', body, offset))
+        offset += 8
+    dictionaries = {}
+    for column in ARCHIVE_STRINGS:
+        (entries,) = struct.unpack_from('<H', body, offset)
+        offset += 2
+        values = []
+        for _ in range(entries):
+            length = body[offset]
+            values.append(body[offset + 1:offset + 1 + length].decode())
+            offset += 1 + length
+        dictionaries[column] = values
+    return ChunkHeader(name=name, zones=zones, columns=columns, dictionaries=dictionaries,
+                       data_offset=data_offset)
+
+
+class TelemetryArchive:
+    """Long-term columnar telemetry store with a downsampled query API"""
+
+    def __init__(self, directory: str, partition_seconds: int = ARCHIVE_PARTITION_S,
+                 segments: int = ARCHIVE_SEGMENTS):
+        self.directory = Path(directory)
+        self.directory.mkdir(parents=True, exist_ok=True)
+        self.partition_seconds = partition_seconds
+        self.segments = segments
+        self.lock = threading.Lock()
+        self.pending: List[TelemetryData] = []
+        self.pending_partition: Optional[int] = None
+        self.headers: List[ChunkHeader] = []
+        self.bytes_read = 0
+        self.load_manifest()
+
+    def load_manifest(self):
+        known = set()
+        manifest = self.directory / ARCHIVE_MANIFEST
+        if manifest.exists():
+            data = manifest.read_bytes()
+            self.bytes_read += len(data)
+            offset = 0
+            # A torn final entry (crash mid-append) is ignored and rebuilt below
+            while offset + 8 <= len(data):
+                name_length, blob_length, data_offset = struct.unpack_from('<HIH', data, offset)
+                end = offset + 8 + name_length + blob_length
+                if end > len(data):
+                    break
+                name = data[offset + 8:offset + 8 + name_length].decode()
+                try:
+                    self.headers.append(unpack_chunk_header(name, data[offset + 8 + name_length:end], data_offset))
+                    known.add(name)
+                except (zlib.error, struct.error, UnicodeDecodeError):
+                    break
+                offset = end
+            if offset != len(data):
+                self.headers = [header for header in self.headers if header.name in known]
+                self.rewrite_manifest()
+
+        for path in sorted(self.directory.glob('*' + ARCHIVE_SUFFIX)):
+            if path.name in known:
+                continue
+            try:
+                header = self.read_header(path)
+            except (OSError, ValueError, zlib.error, struct.error) as e:
+                logging.error(f"Skipping unreadable archive chunk {path}: {e}")
+                continue
+            self.headers.append(header)
+            self.append_manifest(header, path.read_bytes()[8:header.data_offset])
+        self.headers.sort(key=lambda header: header.start)
+
+    def manifest_entry(self, header: ChunkHeader, blob: bytes) -> bytes:
+        name = header.name.encode()
+        return struct.pack('<HIH', len(name), len(blob), header.data_offset) + name + blob
+
+    def append_manifest(self, header: ChunkHeader, blob: bytes):
+        with open(self.directory / ARCHIVE_MANIFEST, 'ab') as manifest:
+            manifest.write(self.manifest_entry(header, blob))
+
+    def rewrite_manifest(self):
+        with open(self.directory / ARCHIVE_MANIFEST, 'wb') as manifest:
+            for header in self.headers:
+                with open(self.directory / header.name, 'rb') as source:
+                    manifest.write(self.manifest_entry(header, source.read(header.data_offset)[8:]))
+
+    def read_header(self, path: Path) -> ChunkHeader:
+        with open(path, 'rb') as source:
+            prefix = source.read(8)
+            if len(prefix) != 8 or prefix[:4] != ARCHIVE_MAGIC:
+                raise ValueError("not an archive chunk")
+            length = int.from_bytes(prefix[4:], 'little')
+            blob = source.read(length)
+        self.bytes_read += 8 + length
+        return unpack_chunk_header(path.name, blob, 8 + length)
+
+    def partition_of(self, timestamp: float) -> int:
+        return int(timestamp // self.partition_seconds)
+
+    def append(self, data: TelemetryData):
+        with self.lock:
+            partition = self.partition_of(data.timestamp)
+            if self.pending and partition != self.pending_partition:
+                self.seal()
+            self.pending_partition = partition
+            self.pending.append(data)
+
+    def flush(self):
+        """Write out the partially filled partition; later rows for the same
+        partition go into another chunk"""
+        with self.lock:
+            self.seal()
+
+    def seal(self):
+        if not self.pending:
+            return
+        rows = sorted(self.pending, key=lambda data: data.timestamp)
+        self.pending = []
+
+        def zone_of(subset: List[TelemetryData]) -> tuple:
+            zone = [subset[0].timestamp, subset[-1].timestamp, len(subset)]
+            for name in ARCHIVE_NUMERIC:
+                values = [getattr(data, name) for data in subset]
+                zone += [min(values), max(values), sum(values)]
+            return tuple(zone)
+
+        zones = [zone_of(rows)]
+        partition_start = self.pending_partition * self.partition_seconds
+        segment_width = self.partition_seconds / self.segments
+        first = 0
+        for index in range(self.segments):
+            limit = partition_start + (index + 1) * segment_width
+            last = first
+            while last < len(rows) and rows[last].timestamp < limit:
+                last += 1
+            if last > first:
+                zones.append(zone_of(rows[first:last]))
+            first = last
+
+        blobs = []
+        columns = []
+        dictionaries = {}
+        offset = 0
+        for name, scale in ARCHIVE_COLUMNS.items():
+            values = [getattr(data, name) for data in rows]
+            if scale is None:
+                dictionary = sorted(set(values))
+                lookup = {value: index for index, value in enumerate(dictionary)}
+                dictionaries[name] = dictionary
+                payload = encode_varints([lookup[value] for value in values])
+            else:
+                scaled = [int(round(value * scale)) for value in values]
+                payload = encode_varints([b - a for a, b in zip([0] + scaled, scaled)])
+            blob = zlib.compress(payload, 6)
+            columns.append((offset, len(blob)))
+            offset += len(blob)
+            blobs.append(blob)
+
+        blob = pack_chunk_header(zones, columns, dictionaries)
+        sequence = sum(1 for existing in self.headers
+                       if self.partition_of(existing.start) == self.pending_partition)
+        name = f"{self.pending_partition:010d}_{sequence:03d}{ARCHIVE_SUFFIX}"
+        with open(self.directory / name, 'wb') as output:
+            output.write(ARCHIVE_MAGIC + len(blob).to_bytes(4, 'little') + blob)
+            for column in blobs:
+                output.write(column)
+
+        header = unpack_chunk_header(name, blob, 8 + len(blob))
+        self.append_manifest(header, blob)
+        self.headers.append(header)
+        self.headers.sort(key=lambda existing: existing.start)
+
+    def chunks_between(self, start: float, end: float) -> List[ChunkHeader]:
+        return [header for header in self.headers if header.end >= start and header.start <= end]
+
+    def read_columns(self, header: ChunkHeader, names: List[str]) -> Dict[str, list]:
+        result = {}
+        order = list(ARCHIVE_COLUMNS)
+        with open(self.directory / header.name, 'rb') as source:
+            for name in names:
+                offset, length = header.columns[order.index(name)]
+                source.seek(header.data_offset + offset)
+                payload = zlib.decompress(source.read(length))
+                self.bytes_read += length
+                values = decode_varints(payload, header.rows)
+                scale = ARCHIVE_COLUMNS[name]
+                if scale is None:
+                    dictionary = header.dictionaries[name]
+                    result[name] = [dictionary[index] for index in values]
+                else:
+                    total = 0
+                    decoded = []
+                    for delta in values:
+                        total += delta
+                        decoded.append(total / scale)
+                    result[name] = decoded
+        return result
+
+    def read(self, start: float, end: float, columns: Optional[List[str]] = None,
+             where: Optional[Tuple[str, float, float]] = None) -> Dict[str, list]:
+        """Rows in [start, end] as column lists, optionally only those with
+        where = (column, low, high) in range. Chunks whose zone map excludes
+        the predicate are never read."""
+        names = list(columns or ARCHIVE_COLUMNS)
+        needed = list(dict.fromkeys(['timestamp'] + names + ([where[0]] if where else [])))
+        result: Dict[str, list] = {name: [] for name in names}
+        with self.lock:
+            headers = self.chunks_between(start, end)
+        for header in headers:
+            if where:
+                low, high, _ = header.zone(0, where[0])
+                if high < where[1] or low > where[2]:
+                    continue
+            data = self.read_columns(header, needed)
+            for row, timestamp in enumerate(data['timestamp']):
+                if not start <= timestamp <= end:
+                    continue
+                if where and not where[1] <= data[where[0]][row] <= where[2]:
+                    continue
+                for name in names:
+                    result[name].append(data[name][row])
+        return result
+
+    def downsample(self, column: str, start: float, end: float,
+                   buckets: int) -> List[Tuple[float, float, float, float, int]]:
+        """(bucket start, min, mean, max, count) for each non-empty bucket.
+        When buckets are wider than a zone-map segment the answer comes from
+        chunk headers alone, with each segment counted in the bucket its
+        first sample falls in."""
+        width = (end - start) / buckets
+        sums = [[float('inf'), 0.0, float('-inf'), 0] for _ in range(buckets)]
+
+        def accumulate(timestamp: float, low: float, total: float, high: float, count: int):
+            index = min(buckets - 1, int((timestamp - start) / width))
+            bucket = sums[index]
+            bucket[0] = min(bucket[0], low)
+            bucket[1] += total
+            bucket[2] = max(bucket[2], high)
+            bucket[3] += count
+
+        with self.lock:
+            headers = self.chunks_between(start, end)
+        segment_width = self.partition_seconds / self.segments
+        base = 3 + 3 * ARCHIVE_NUMERIC.index(column)
+        for header in headers:
+            if width >= segment_width and start <= header.start and header.end < end:
+                for zone in header.zones[1:]:
+                    accumulate(zone[0], zone[base], zone[base + 2], zone[base + 1], int(zone[2]))
+                continue
+
+            data = self.read_columns(header, ['timestamp', column])
+            for timestamp, value in zip(data['timestamp'], data[column]):
+                if start <= timestamp < end:
+                    accumulate(timestamp, value, value, value, 1)
+
+        return [(start + index * width, low, total / count, high, count)
+                for index, (low, total, high, count) in enumerate(sums) if count]
+
+    def disk_usage(self) -> int:
+        return sum(path.stat().st_size for path in self.directory.iterdir())
+
+    def close(self):
+        self.flush()
+
+
 class DatabaseManager:
-   
-    
-    def __init__(self, db_file: str):
+    """SQLite store for telemetry and events.
+
+    Writes are queued and committed by a background writer thread, one
+    transaction per flush interval, through a single persistent connection
+    in WAL mode. Readers use their own connection per thread, which WAL lets
+    run concurrently with the writer. With an archive directory, telemetry
+    is also appended to a TelemetryArchive per unit for long-range queries.
+    """
+
+    def __init__(self, db_file: str, flush_interval: float = CONFIG['db_flush_interval'],
+                 max_batch: int = CONFIG['db_max_batch'], archive_dir: Optional[str] = None):
         self.db_file = db_file
+        self.archive_dir = archive_dir
+        self.archives: Dict[str, TelemetryArchive] = {}
+        self.flush_interval = flush_interval
+        self.max_batch = max_batch
+        self.pending: 'queue.Queue[Optional[Tuple[str, tuple]]]' = queue.Queue()
+        self.readers = threading.local()
+        self.rows_written = 0
+        self.transactions = 0
+        self.write_errors = 0
+        self.archive_errors = 0
+
+        self.conn = self.connect()
         self.init_database()
-    
+        self.writer = threading.Thread(target=self.writer_loop, name='db-writer', daemon=True)
+        self.writer.start()
+
+    def connect(self) -> sqlite3.Connection:
+        conn = sqlite3.connect(self.db_file, check_same_thread=False)
+        conn.execute('PRAGMA journal_mode=WAL')
+        # WAL keeps the database consistent on power loss at NORMAL; only the
+        # last transactions may be lost, not corrupted
+        conn.execute('PRAGMA synchronous=NORMAL')
+        return conn
+
     def init_database(self):
-     
-        conn = sqlite3.connect(self.db_file)
-        cursor = conn.cursor()
-        
-       
+        cursor = self.conn.cursor()
+
         cursor.execute('''
             CREATE TABLE IF NOT EXISTS telemetry (
                 id INTEGER PRIMARY KEY AUTOINCREMENT,
@@ -100,11 +987,18 @@ class DatabaseManager:
                 latitude REAL,
                 longitude REAL,
                 altitude REAL,
-                heading REAL
+                heading REAL,
+                unit_id TEXT DEFAULT '',
+                uptime REAL DEFAULT 0
             )
         ''')
-        
-       
+
+        columns = [row[1] for row in cursor.execute('PRAGMA table_info(telemetry)')]
+        if 'unit_id' not in columns:
+            cursor.execute("ALTER TABLE telemetry ADD COLUMN unit_id TEXT DEFAULT ''")
+        if 'uptime' not in columns:
+            cursor.execute("ALTER TABLE telemetry ADD COLUMN uptime REAL DEFAULT 0")
+
         cursor.execute('''
             CREATE TABLE IF NOT EXISTS events (
                 id INTEGER PRIMARY KEY AUTOINCREMENT,
@@ -114,8 +1008,22 @@ class DatabaseManager:
                 severity TEXT
             )
         ''')
-        
-      
+
+        cursor.execute('''
+            CREATE TABLE IF NOT EXISTS track_events (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                timestamp REAL,
+                track_id INTEGER,
+                kind TEXT,
+                range_cm REAL,
+                azimuth REAL,
+                velocity REAL,
+                confidence INTEGER,
+                unit_id TEXT DEFAULT '',
+                uptime REAL DEFAULT 0
+            )
+        ''')
+
         cursor.execute('''
             CREATE TABLE IF NOT EXISTS missions (
                 id INTEGER PRIMARY KEY AUTOINCREMENT,
@@ -128,28 +1036,729 @@ class DatabaseManager:
                 notes TEXT
             )
         ''')
-        
-        conn.commit()
-        conn.close()
-    
+
+        cursor.execute('CREATE INDEX IF NOT EXISTS idx_telemetry_timestamp ON telemetry (timestamp)')
+        cursor.execute('CREATE INDEX IF NOT EXISTS idx_telemetry_unit ON telemetry (unit_id, timestamp)')
+        cursor.execute('CREATE INDEX IF NOT EXISTS idx_events_timestamp ON events (timestamp)')
+        cursor.execute('CREATE INDEX IF NOT EXISTS idx_track_events_unit ON track_events (unit_id, timestamp)')
+        self.conn.commit()
+
     def insert_telemetry(self, data: TelemetryData):
-      
-        conn = sqlite3.connect(self.db_file)
-        cursor = conn.cursor()
-        
-        cursor.execute('''
-            INSERT INTO telemetry (
-                timestamp, state, battery_voltage, temperature,
-                bird_count, closest_bird_distance, weather_status,
-                system_health, latitude, longitude, altitude, heading
-            ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-        ''', (
-            data.timestamp, data.state, data.battery_voltage, data.temperature,
-            data.bird_count, data.closest_bird_distance, data.weather_status,
-            data.system_health, data.latitude, data.longitude, data.altitude, data.heading
-        ))
-        
+        """Queue one sample; it is committed with the next batch"""
+        self.pending.put((INSERT_TELEMETRY_SQL, tuple(getattr(data, column) for column in TELEMETRY_COLUMNS)))
+
+    def insert_event(self, timestamp: float, event_type: str, description: str, severity: str = 'INFO'):
+        self.pending.put((INSERT_EVENT_SQL, (timestamp, event_type, description, severity)))
+
+    def insert_track_event(self, event: TrackEvent):
+        self.pending.put((INSERT_TRACK_EVENT_SQL, tuple(getattr(event, column) for column in TRACK_EVENT_COLUMNS)))
+
+    def writer_loop(self):
+        running = True
+        while running:
+            try:
+                first = self.pending.get(timeout=self.flush_interval)
+            except queue.Empty:
+                continue
+
+            # Let a batch accumulate, then take everything queued so far
+            batch = [first]
+            deadline = time.monotonic() + self.flush_interval
+            while len(batch) < self.max_batch:
+                try:
+                    batch.append(self.pending.get(timeout=max(0.0, deadline - time.monotonic())))
+                except queue.Empty:
+                    break
+
+            if None in batch:
+                running = False
+            try:
+                self.write_batch([item for item in batch if item is not None])
+            except Exception as e:
+                # Keep the writer alive; flush() and close() wait on it
+                logging.error(f"Database writer failed, {len(batch)} rows dropped: {e}")
+            finally:
+                for _ in batch:
+                    self.pending.task_done()
+
+    def write_batch(self, batch: List[Tuple[str, tuple]]):
+        if not batch:
+            return
+
+        # Group rows by statement so each executemany reuses one prepared
+        # statement from the connection's cache
+        grouped: Dict[str, List[tuple]] = {}
+        for sql, row in batch:
+            grouped.setdefault(sql, []).append(row)
+        try:
+            with self.conn:
+                for sql, rows in grouped.items():
+                    self.conn.executemany(sql, rows)
+            self.rows_written += len(batch)
+            self.transactions += 1
+        except sqlite3.Error as e:
+            self.write_errors += len(batch)
+            logging.error(f"Database write failed, {len(batch)} rows dropped: {e}")
+
+        if self.archive_dir:
+            rows = grouped.get(INSERT_TELEMETRY_SQL, [])
+            try:
+                for row in rows:
+                    data = TelemetryData(*row)
+                    self.get_archive(data.unit_id).append(data)
+            except (OSError, struct.error, ValueError) as e:
+                self.archive_errors += len(rows)
+                logging.error(f"Archive write failed, {len(rows)} rows not archived: {e}")
+
+    def get_archive(self, unit_id: str = '') -> TelemetryArchive:
+        archive = self.archives.get(unit_id)
+        if archive is None:
+            directory = Path(self.archive_dir)
+            if unit_id:
+                directory /= re.sub(r'[^A-Za-z0-9_.-]', '_', unit_id)
+            archive = TelemetryArchive(str(directory))
+            self.archives[unit_id] = archive
+        return archive
+
+    def flush(self):
+        """Block until everything queued so far is committed"""
+        self.pending.join()
+
+    def close(self):
+        if self.writer.is_alive():
+            self.pending.put(None)
+            self.writer.join()
+        for archive in self.archives.values():
+            archive.close()
+        self.conn.close()
+
+    def reader(self) -> sqlite3.Connection:
+        conn = getattr(self.readers, 'conn', None)
+        if conn is None:
+            conn = sqlite3.connect(self.db_file)
+            self.readers.conn = conn
+        return conn
+
+    def get_recent_telemetry(self, hours: int = 24, unit_id: Optional[str] = None) -> List[TelemetryData]:
+        cutoff = time.time() - hours * 3600
+        query = f"SELECT {', '.join(TELEMETRY_COLUMNS)} FROM telemetry WHERE timestamp >= ?"
+        parameters: tuple = (cutoff,)
+        if unit_id is not None:
+            query += " AND unit_id = ?"
+            parameters += (unit_id,)
+        cursor = self.reader().execute(query + " ORDER BY timestamp", parameters)
+        return [TelemetryData(*row) for row in cursor.fetchall()]
+
+    def get_recent_track_events(self, hours: int = 24, unit_id: Optional[str] = None) -> List[TrackEvent]:
+        cutoff = time.time() - hours * 3600
+        query = f"SELECT {', '.join(TRACK_EVENT_COLUMNS)} FROM track_events WHERE timestamp >= ?"
+        parameters: tuple = (cutoff,)
+        if unit_id is not None:
+            query += " AND unit_id = ?"
+            parameters += (unit_id,)
+        cursor = self.reader().execute(query + " ORDER BY id", parameters)
+        return [TrackEvent(*row) for row in cursor.fetchall()]
+
+
+@dataclass
+class UnitStats:
+    """Per-source ingest counters kept by IngestServer"""
+    unit_id: str
+    source: str
+    connected: bool = True
+    bytes: int = 0
+    samples: int = 0
+    track_events: int = 0
+    rejected: int = 0
+    reboots: int = 0
+    last_seen: float = 0.0
+
+
+class UptimeClock:
+    """Maps one unit's millis() uptime onto Unix time.
+
+    The boot time is estimated as receive time minus the newest uptime in
+    each delivery; link latency only ever makes that estimate late, so the
+    earliest one is kept. Uptime going backwards means the unit rebooted (or
+    millis() wrapped), and the clock re-anchors from the next delivery.
+    """
+
+    def __init__(self):
+        self.boot: Optional[float] = None
+        self.last_uptime: Optional[float] = None
+        self.reboots = 0
+
+    def anchor(self, uptime: float, received: float):
+        candidate = received - uptime
+        if self.boot is None or candidate < self.boot:
+            self.boot = candidate
+
+    def stamp(self, samples: List[TelemetryData], events: List[TrackEvent], received: float):
+        # Samples arrive in uptime order, so split them into runs per boot
+        run: List[TelemetryData] = []
+        for sample in samples:
+            if self.last_uptime is not None and sample.uptime < self.last_uptime:
+                if run:
+                    self.anchor(run[-1].uptime, received)
+                    for earlier in run:
+                        earlier.timestamp = self.boot + earlier.uptime
+                    run = []
+                self.boot = None
+                self.reboots += 1
+            self.last_uptime = sample.uptime
+            run.append(sample)
+        if run:
+            self.anchor(run[-1].uptime, received)
+        if events:
+            self.anchor(max(event.uptime for event in events), received)
+        for record in run + events:
+            record.timestamp = self.boot + record.uptime
+
+
+TelemetrySink = Callable[[List[TelemetryData], List[TrackEvent]], None]
+
+
+class IngestServer:
+    """Telemetry ingest for several units on one asyncio loop.
+
+    TCP sources open with a 'UNIT <id>' line followed by the binary frame
+    stream; serial sources are registered with their unit id (see
+    CONFIG['units']) and read through the loop's fd watcher. Every source
+    has its own decoder, so sequence and delta state never mix between
+    units. Decoded records are tagged with the unit id, their uptime is
+    mapped onto Unix time by the source's UptimeClock, and they are handed
+    to every sink on the loop thread, so sinks must not block:
+    DatabaseManager.insert_telemetry only enqueues, and a UI should hand
+    records to its own queue.
+    """
+
+    def __init__(self, sinks: List[TelemetrySink]):
+        self.sinks = sinks
+        self.units: Dict[str, UnitStats] = {}
+        self.server: Optional[asyncio.AbstractServer] = None
+        self.serial_ports = []
+
+    async def start_tcp(self, host: str, port: int) -> int:
+        self.server = await asyncio.start_server(self.handle_client, host, port)
+        return self.server.sockets[0].getsockname()[1]
+
+    def add_serial(self, port: str, unit_id: str, baud_rate: int = CONFIG['baud_rate']):
+        link = serial.Serial(port, baud_rate, timeout=0)
+        decoder = TelemetryDecoder()
+        clock = UptimeClock()
+        stats = self.register(unit_id, port)
+        loop = asyncio.get_running_loop()
+
+        def on_readable():
+            try:
+                data = link.read(link.in_waiting or 1)
+            except serial.SerialException as e:
+                logging.error(f"Serial link {port} for {unit_id} failed: {e}")
+                loop.remove_reader(link.fileno())
+                stats.connected = False
+                return
+            self.deliver(stats, decoder, clock, data)
+
+        loop.add_reader(link.fileno(), on_readable)
+        self.serial_ports.append(link)
+
+    def register(self, unit_id: str, source: str) -> UnitStats:
+        stats = self.units.get(unit_id)
+        if stats is None or stats.source != source:
+            stats = UnitStats(unit_id=unit_id, source=source)
+            self.units[unit_id] = stats
+        stats.connected = True
+        return stats
+
+    async def handle_client(self, reader: asyncio.StreamReader, writer: asyncio.StreamWriter):
+        peer = writer.get_extra_info('peername')
+        source = f"{peer[0]}:{peer[1]}" if peer else 'tcp'
+        decoder = TelemetryDecoder()
+        clock = UptimeClock()
+        try:
+            line = await asyncio.wait_for(reader.readline(), timeout=5.0)
+        except (asyncio.TimeoutError, ConnectionError):
+            writer.close()
+            return
+
+        if line.startswith(b'UNIT '):
+            name = line[5:].strip()
+            if len(name) > CONFIG['max_unit_id_length']:
+                logging.warning(f"Rejected {source}: unit id longer than {CONFIG['max_unit_id_length']} bytes")
+                writer.close()
+                return
+            unit_id = name.decode(errors='replace') or source
+            data = b''
+        else:
+            # No greeting: name the unit after its address and keep the bytes
+            unit_id, data = source, line
+        stats = self.register(unit_id, source)
+
+        try:
+            while True:
+                if data:
+                    self.deliver(stats, decoder, clock, data)
+                data = await reader.read(4096)
+                if not data:
+                    break
+        except ConnectionError as e:
+            logging.warning(f"Connection from {unit_id} lost: {e}")
+        finally:
+            stats.connected = False
+            writer.close()
+
+    def deliver(self, stats: UnitStats, decoder: TelemetryDecoder, clock: UptimeClock, data: bytes):
+        stats.bytes += len(data)
+        stats.last_seen = time.time()
+        samples = decoder.feed(data)
+        events = decoder.take_track_events()
+        stats.rejected = decoder.rejected
+        if not samples and not events:
+            return
+
+        clock.stamp(samples, events, stats.last_seen)
+        stats.reboots = clock.reboots
+        for sample in samples:
+            sample.unit_id = stats.unit_id
+        for event in events:
+            event.unit_id = stats.unit_id
+        stats.samples += len(samples)
+        stats.track_events += len(events)
+        for sink in self.sinks:
+            try:
+                sink(samples, events)
+            except Exception as e:
+                logging.error(f"Telemetry sink failed for {stats.unit_id}: {e}")
+
+    async def close(self):
+        if self.server:
+            self.server.close()
+            await self.server.wait_closed()
+        for link in self.serial_ports:
+            asyncio.get_running_loop().remove_reader(link.fileno())
+            link.close()
+
+
+def encode_telemetry_frame(frame_type: int, sequence: int, values: List[int]) -> bytes:
+    """Frame values the way the drone does, delimiters included"""
+    body = bytes([TELEMETRY_PROTOCOL_VERSION, frame_type, sequence & 0xFF]) + encode_varints(values)
+    return b'\x00' + cobs_encode(body + crc16_ccitt(body).to_bytes(2, 'big')) + b'\x00'
+
+
+async def simulate_unit(host: str, port: int, unit_id: str, rate_hz: float, batch: int,
+                        seconds: float, epoch: float):
+    """One simulated drone: store-and-forward batches at rate_hz samples/s.
+    Sample uptimes are ms since epoch, so the receiver can measure latency
+    from the newest sample in each batch"""
+    reader, writer = await asyncio.open_connection(host, port)
+    writer.write(f"UNIT {unit_id}\n".encode())
+    interval = batch / rate_hz
+    sequence = 0
+    deadline = time.time() + seconds
+    next_send = time.time() + random.random() * interval  # Spread units over the interval
+    while next_send < deadline:
+        await asyncio.sleep(max(0.0, next_send - time.time()))
+        now_ms = int((time.time() - epoch) * 1000)
+        values = []
+        previous = [0] * TELEMETRY_FIELD_COUNT
+        for index in range(batch):
+            sample = [now_ms - int((batch - 1 - index) * 1000 / rate_hz), 2, 12400 - index, 3520, 2, 1523,
+                      0, 0, 0, 0]
+            values += [a - b for a, b in zip(sample, previous)]
+            previous = sample
+        writer.write(encode_telemetry_frame(TELEMETRY_FRAME_BATCH, sequence, values))
+        await writer.drain()
+        sequence += 1
+        next_send += interval
+    writer.close()
+    await writer.wait_closed()
+
+
+def run_load_generator(host: str, port: int, units: int, rate_hz: float, batch: int,
+                       seconds: float, epoch: float):
+    async def run():
+        await asyncio.gather(*(simulate_unit(host, port, f"unit-{index:02d}", rate_hz, batch, seconds, epoch)
+                               for index in range(units)))
+    asyncio.run(run())
+
+
+def load_test(directory: str, units: int = 50, rate_hz: float = 10.0, batch: int = 5,
+              seconds: float = 10.0) -> Dict[str, float]:
+    """Ingest from simulated units in a separate process into a database and
+    archive; report throughput and end-to-end latency"""
+    import multiprocessing
+
+    db = DatabaseManager(str(Path(directory) / 'telemetry.db'), archive_dir=str(Path(directory) / 'archive'))
+    latencies: List[float] = []
+    epoch = time.time()
+
+    def measure(samples: List[TelemetryData], events: List[TrackEvent]):
+        if samples:
+            latencies.append(time.time() - epoch - max(sample.uptime for sample in samples))
+
+    def store(samples: List[TelemetryData], events: List[TrackEvent]):
+        for sample in samples:
+            db.insert_telemetry(sample)
+
+    async def run() -> float:
+        server = IngestServer([measure, store])
+        port = await server.start_tcp('127.0.0.1', 0)
+        generator = multiprocessing.Process(target=run_load_generator,
+                                            args=('127.0.0.1', port, units, rate_hz, batch, seconds, epoch))
+        began = time.time()
+        generator.start()
+        await asyncio.get_running_loop().run_in_executor(None, generator.join)
+        # Let the last bytes in flight arrive
+        await asyncio.sleep(0.2)
+        elapsed = time.time() - began
+        await server.close()
+        stats.extend(server.units.values())
+        return elapsed
+
+    stats: List[UnitStats] = []
+    elapsed = asyncio.run(run())
+    db.flush()
+    db.close()
+
+    latencies.sort()
+    samples = sum(unit.samples for unit in stats)
+    return {
+        'units': len(stats),
+        'samples': samples,
+        'expected': units * int(seconds * rate_hz / batch) * batch,
+        'samples_per_second': samples / seconds,
+        'rejected': sum(unit.rejected for unit in stats),
+        'stored': db.rows_written,
+        'latency_p50_ms': latencies[len(latencies) // 2] * 1000 if latencies else 0.0,
+        'latency_p99_ms': latencies[int(len(latencies) * 0.99)] * 1000 if latencies else 0.0,
+        'latency_max_ms': latencies[-1] * 1000 if latencies else 0.0,
+        'elapsed': elapsed,
+    }
+
+
+def replay_capture(path: str, directory: str) -> Dict[str, object]:
+    """Ingest a bird_deterrent_sim --capture file as one delivery into a
+    database and archive, then read it back as the UI would"""
+    db = DatabaseManager(str(Path(directory) / 'telemetry.db'), archive_dir=str(Path(directory) / 'archive'))
+    ingested: List[TelemetryData] = []
+    ingested_events: List[TrackEvent] = []
+
+    def store(samples: List[TelemetryData], events: List[TrackEvent]):
+        ingested.extend(samples)
+        ingested_events.extend(events)
+        for sample in samples:
+            db.insert_telemetry(sample)
+        for event in events:
+            db.insert_track_event(event)
+
+    server = IngestServer([store])
+    stats = server.register('replay', path)
+    server.deliver(stats, TelemetryDecoder(), UptimeClock(), Path(path).read_bytes())
+    db.flush()
+    db.close()
+
+    db = DatabaseManager(str(Path(directory) / 'telemetry.db'))
+    recent = db.get_recent_telemetry(24, 'replay')
+    recent_events = db.get_recent_track_events(24, 'replay')
+    db.close()
+    archive = TelemetryArchive(str(Path(directory) / 'archive' / 'replay'))
+    now = time.time()
+    result = {
+        'ingested': len(ingested),
+        'recent': len(recent),
+        'matching': sum(1 for sent, read in zip(ingested, recent)
+                        if abs(sent.timestamp - read.timestamp) < 1e-3 and sent.uptime == read.uptime),
+        'events': len(ingested_events),
+        'recent_events': sum(1 for sent, read in zip(ingested_events, recent_events) if sent == read),
+        'span': recent[-1].timestamp - recent[0].timestamp if recent else 0.0,
+        'newest_age': now - recent[-1].timestamp if recent else 0.0,
+        'partitions': sorted({archive.partition_of(header.start) for header in archive.headers}),
+        'current_partition': archive.partition_of(now),
+    }
+    archive.close()
+    return result
+
+
+def benchmark_plotting(sizes: Tuple[int, ...] = (1000, 10000, 100000, 1000000),
+                       width: int = 1000, frames: int = 20) -> List[Dict[str, float]]:
+    """Per-frame cost of producing plot data for the whole session: the
+    rescan-and-replot approach copies every stored sample each frame, the
+    decimated series emits one min/max pair per pixel"""
+    results = []
+    rng = random.Random(3)
+    for size in sizes:
+        stored = []
+        series = DecimatedSeries()
+        for index in range(size):
+            data = TelemetryData(timestamp=index * 0.1, state='STANDBY', battery_voltage=12.0 + rng.random(),
+                                 temperature=25.0, bird_count=0, closest_bird_distance=0.0,
+                                 weather_status='CLEAR', system_health='OK')
+            stored.append(data)
+            series.append(data.timestamp, data.battery_voltage)
+        end = size * 0.1
+
+        began = time.perf_counter()
+        for _ in range(frames):
+            xs = [data.timestamp for data in stored]
+            ys = [data.battery_voltage for data in stored]
+        rescan = (time.perf_counter() - began) / frames
+
+        began = time.perf_counter()
+        for _ in range(frames):
+            xs, ys = series.window(0.0, end, width)
+        decimated = (time.perf_counter() - began) / frames
+
+        began = time.perf_counter()
+        for index in range(1000):
+            series.append(end + index * 0.1, 12.0)
+        append = (time.perf_counter() - began) / 1000
+
+        results.append({'samples': size, 'rescan_ms': rescan * 1000, 'decimated_ms': decimated * 1000,
+                        'vertices': len(xs), 'append_us': append * 1e6})
+    return results
+
+
+def benchmark_database(db_file: str, seconds: float = 5.0, rate: int = 0) -> Dict[str, float]:
+    """Sustained ingest: feed rows as fast as possible (or at rate rows/s)
+    for the given time and report committed rows per second"""
+    db = DatabaseManager(db_file)
+    sample = TelemetryData(timestamp=0.0, state='ACTIVE_DETERRENT', battery_voltage=12.4, temperature=35.2,
+                           bird_count=2, closest_bird_distance=152.3, weather_status='CLEAR', system_health='OK')
+    start = time.monotonic()
+    produced = 0
+    while time.monotonic() - start < seconds:
+        if rate and produced >= rate * (time.monotonic() - start):
+            time.sleep(0.001)
+            continue
+        sample.timestamp = time.time()
+        db.insert_telemetry(sample)
+        produced += 1
+    db.flush()
+    elapsed = time.monotonic() - start
+    result = {
+        'rows': db.rows_written,
+        'rows_per_second': db.rows_written / elapsed,
+        'transactions': db.transactions,
+        'rows_per_transaction': db.rows_written / max(1, db.transactions),
+    }
+    db.close()
+    return result
+
+
+def benchmark_legacy_inserts(db_file: str, seconds: float = 2.0) -> Dict[str, float]:
+    """The previous scheme: connect, insert one row, commit, close"""
+    DatabaseManager(db_file).close()
+    conn = sqlite3.connect(db_file)
+    conn.execute('PRAGMA journal_mode=DELETE')
+    conn.close()
+    row = (0.0, 'ACTIVE_DETERRENT', 12.4, 35.2, 2, 152.3, 'CLEAR', 'OK', 0.0, 0.0, 0.0, 0.0, '', 0.0)
+    start = time.monotonic()
+    rows = 0
+    while time.monotonic() - start < seconds:
+        conn = sqlite3.connect(db_file)
+        conn.execute(INSERT_TELEMETRY_SQL, row)
         conn.commit()
         conn.close()
-    
-    def get_recent_telemetry(self, hours: int = 24)
\ No newline at end of file
+        rows += 1
+    return {'rows': rows, 'rows_per_second': rows / (time.monotonic() - start)}
+
+
+def benchmark_archive(directory: str, days: int = 30, interval: float = 10.0,
+                      buckets: int = 1000) -> Dict[str, Dict[str, float]]:
+    """Store days of synthetic telemetry in both SQLite and the archive, then
+    time the plot query for the whole window: min/mean/max bird count in
+    buckets"""
+    import random
+
+    rng = random.Random(1)
+    start = 1700000000.0
+    rows = []
+    for index in range(int(days * 86400 / interval)):
+        timestamp = start + index * interval
+        birds = max(0, int(rng.gauss(1.5, 2)))
+        rows.append(TelemetryData(timestamp=timestamp, state='ACTIVE_DETERRENT' if birds else 'STANDBY',
+                                  battery_voltage=round(12.6 - (index % 8640) * 0.0001, 3),
+                                  temperature=round(25 + rng.random() * 5, 2), bird_count=birds,
+                                  closest_bird_distance=round(rng.uniform(50, 400), 1) if birds else 0.0,
+                                  weather_status='CLEAR', system_health='OK'))
+    end = rows[-1].timestamp + interval
+
+    db_file = str(Path(directory) / 'telemetry.db')
+    db = DatabaseManager(db_file)
+    db.close()
+    conn = sqlite3.connect(db_file)
+    with conn:
+        conn.executemany(INSERT_TELEMETRY_SQL, [tuple(getattr(data, column) for column in TELEMETRY_COLUMNS)
+                                                for data in rows])
+    conn.close()
+
+    archive = TelemetryArchive(str(Path(directory) / 'archive'))
+    for data in rows:
+        archive.append(data)
+    archive.close()
+
+    width = (end - start) / buckets
+    conn = sqlite3.connect(db_file)
+    began = time.perf_counter()
+    conn.execute("SELECT CAST((timestamp - ?) / ? AS INTEGER) AS bucket, MIN(bird_count), AVG(bird_count), "
+                 "MAX(bird_count), COUNT(*) FROM telemetry WHERE timestamp >= ? AND timestamp < ? "
+                 "GROUP BY bucket", (start, width, start, end)).fetchall()
+    sql_seconds = time.perf_counter() - began
+    conn.close()
+
+    # Opening the archive reads every chunk header, so count it in the query
+    began = time.perf_counter()
+    archive = TelemetryArchive(str(Path(directory) / 'archive'))
+    points = archive.downsample('bird_count', start, end, buckets)
+    archive_seconds = time.perf_counter() - began
+    header_bytes = archive.bytes_read
+
+    # A plot refresh with the archive already open touches no files
+    began = time.perf_counter()
+    archive.downsample('bird_count', start, end, buckets)
+    refresh_seconds = time.perf_counter() - began
+
+    began = time.perf_counter()
+    busy = archive.read(start, end, ['timestamp', 'bird_count'], where=('bird_count', 9, 1000))
+    scan_seconds = time.perf_counter() - began
+
+    return {
+        'rows': {'count': len(rows), 'points': len(points), 'busy_rows': len(busy['timestamp'])},
+        'sqlite': {'bytes': Path(db_file).stat().st_size, 'query_ms': sql_seconds * 1000},
+        'archive': {'bytes': archive.disk_usage(), 'query_ms': archive_seconds * 1000,
+                    'refresh_ms': refresh_seconds * 1000,
+                    'header_bytes': header_bytes, 'chunks': len(archive.headers),
+                    'scan_ms': scan_seconds * 1000},
+    }
+
+
+def main():
+    import argparse
+    import tempfile
+
+    parser = argparse.ArgumentParser(description='Bird deterrent ground station')
+    parser.add_argument('--bench-db', action='store_true', help='measure sustained database ingest and exit')
+    parser.add_argument('--bench-archive', action='store_true', help='compare archive and SQLite range queries and exit')
+    parser.add_argument('--bench-plot', action='store_true', help='measure plot data cost vs stored samples and exit')
+    parser.add_argument('--load-test', action='store_true', help='ingest from simulated units and exit')
+    parser.add_argument('--serve', action='store_true', help='run the headless ingest server')
+    parser.add_argument('--plot-tracks', action='store_true', help='with --serve, plot live tracks from all units')
+    parser.add_argument('--replay', metavar='CAPTURE', help='ingest a simulator capture, check it reads back and exit')
+    parser.add_argument('--units', type=int, default=50)
+    parser.add_argument('--rate', type=float, default=10.0, help='samples/s per simulated unit')
+    parser.add_argument('--seconds', type=float, default=5.0)
+    parser.add_argument('--days', type=int, default=30)
+    args = parser.parse_args()
+
+    if args.bench_db:
+        with tempfile.TemporaryDirectory() as directory:
+            legacy = benchmark_legacy_inserts(str(Path(directory) / 'legacy.db'), min(args.seconds, 2.0))
+            batched = benchmark_database(str(Path(directory) / 'batched.db'), args.seconds)
+        print(f"{'writer':<28} {'rows/s':>10} {'rows/txn':>10}")
+        print(f"{'connect+commit per row':<28} {legacy['rows_per_second']:>10.0f} {1:>10}")
+        print(f"{'WAL, batched writer':<28} {batched['rows_per_second']:>10.0f} "
+              f"{batched['rows_per_transaction']:>10.0f}")
+        return
+
+    if args.bench_archive:
+        with tempfile.TemporaryDirectory() as directory:
+            result = benchmark_archive(directory, args.days)
+        rows, sql, archive = result['rows'], result['sqlite'], result['archive']
+        print(f"{rows['count']} rows over {args.days} days, {rows['points']} plot points")
+        print(f"{'store':<10} {'disk KB':>10} {'plot ms':>10}")
+        print(f"{'sqlite':<10} {sql['bytes'] / 1024:>10.0f} {sql['query_ms']:>10.1f}")
+        print(f"{'archive':<10} {archive['bytes'] / 1024:>10.0f} {archive['query_ms']:>10.1f}")
+        print(f"archive plot refresh once open: {archive['refresh_ms']:.1f} ms")
+        print(f"archive plot read {archive['header_bytes'] / 1024:.0f} KB of headers from {archive['chunks']} chunks; "
+              f"bird_count >= 9 scan found {rows['busy_rows']} rows in {archive['scan_ms']:.1f} ms")
+        return
+
+    if args.bench_plot:
+        print(f"{'samples':>10} {'rescan ms':>10} {'decimated ms':>13} {'vertices':>9} {'append us':>10}")
+        for result in benchmark_plotting():
+            print(f"{result['samples']:>10} {result['rescan_ms']:>10.2f} {result['decimated_ms']:>13.3f} "
+                  f"{result['vertices']:>9} {result['append_us']:>10.2f}")
+        return
+
+    if args.load_test:
+        with tempfile.TemporaryDirectory() as directory:
+            result = load_test(directory, args.units, args.rate, seconds=args.seconds)
+        print(f"{result['units']} units at {args.rate:g} Hz for {args.seconds:g} s: "
+              f"{result['samples']}/{result['expected']} samples, {result['stored']} stored, "
+              f"{result['rejected']} frames rejected")
+        print(f"ingest {result['samples_per_second']:.0f} samples/s, latency p50 {result['latency_p50_ms']:.1f} ms, "
+              f"p99 {result['latency_p99_ms']:.1f} ms, max {result['latency_max_ms']:.1f} ms")
+        return
+
+    if args.replay:
+        with tempfile.TemporaryDirectory() as directory:
+            result = replay_capture(args.replay, directory)
+        in_recent = result['ingested'] > 0 and result['recent'] == result['matching'] == result['ingested']
+        in_archive = result['partitions'] and result['partitions'][-1] == result['current_partition']
+        events_stored = result['recent_events'] == result['events']
+        print(f"replayed {result['ingested']} samples over {result['span']:.1f} s, newest "
+              f"{result['newest_age']:.1f} s old; get_recent_telemetry(24) returned {result['recent']}, "
+              f"{result['matching']} matching {'PASS' if in_recent else 'FAIL'}")
+        print(f"archive partitions {result['partitions']}, current {result['current_partition']} "
+              f"{'PASS' if in_archive else 'FAIL'}")
+        print(f"track events: {result['events']} ingested, {result['recent_events']} read back "
+              f"{'PASS' if events_stored else 'FAIL'}")
+        sys.exit(0 if in_recent and in_archive and events_stored else 1)
+
+    if args.serve:
+        logging.basicConfig(level=logging.INFO)
+        db = DatabaseManager(CONFIG['database_file'], archive_dir=CONFIG['archive_dir'])
+
+        sinks: List[TelemetrySink] = []
+
+        def store(samples: List[TelemetryData], events: List[TrackEvent]):
+            for sample in samples:
+                db.insert_telemetry(sample)
+            for event in events:
+                db.insert_track_event(event)
+        sinks.append(store)
+
+        track_plot = None
+        if args.plot_tracks:
+            if MISSING_DEPENDENCY is not None:
+                print(f"Missing dependency for --plot-tracks: {MISSING_DEPENDENCY}")
+                sys.exit(1)
+            figure = plt.figure()
+            track_plot = LiveTrackPlot(figure)
+            sinks.append(track_plot.sink)
+
+        async def serve():
+            server = IngestServer(sinks)
+            port = await server.start_tcp('0.0.0.0', CONFIG['ingest_port'])
+            if MISSING_DEPENDENCY is None:
+                for serial_port, unit_id in CONFIG['units'].items():
+                    try:
+                        server.add_serial(serial_port, unit_id)
+                    except serial.SerialException as e:
+                        logging.error(f"Cannot open {serial_port} for {unit_id}: {e}")
+            logging.info(f"Ingesting telemetry on port {port}")
+            await asyncio.Event().wait()
+
+        try:
+            if track_plot is None:
+                asyncio.run(serve())
+            else:
+                # Matplotlib owns the main thread; the ingest loop runs beside it
+                threading.Thread(target=asyncio.run, args=(serve(),), name='ingest', daemon=True).start()
+                animation = FuncAnimation(figure, lambda frame: track_plot.refresh(time.time()),
+                                          interval=CONFIG['update_interval'], cache_frame_data=False)
+                plt.show()
+        except KeyboardInterrupt:
+            pass
+        finally:
+            db.close()
+        return
+
+    if MISSING_DEPENDENCY is not None:
+        print(f"Missing dependency: {MISSING_DEPENDENCY}")
+        print("Install with: pip install PyQt5 matplotlib numpy pyserial requests")
+        sys.exit(1)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,144 @@
+#include "heap_guard.h"
+
+#if ENABLE_HEAP_GUARD
+
+#ifdef SIM_HAL
+#include "SimHal.h"
+#else
+#include <errno.h>
+#include <new>
+#include <stdlib.h>
+#endif
+
+static volatile bool armed = false;
+static volatile unsigned long violations = 0;
+
+static void heapGuardFault(size_t bytes)
+{
+    violations++;
+    if (violations > 1)
+        return;
+
+    // Printing is heap-free, so reporting cannot recurse into the guard
+    Serial.print("FATAL: heap allocation of ");
+    Serial.print((unsigned long)bytes);
+    Serial.println(" bytes after setup()");
+#ifndef SIM_HAL
+    Serial.flush();
+    noInterrupts();
+    while (true)
+    {
+    }
+#endif
+}
+
+bool heapGuardIsArmed()
+{
+    return armed;
+}
+
+unsigned long heapGuardGetViolations()
+{
+    return violations;
+}
+
+#ifdef SIM_HAL
+
+void heapGuardArm()
+{
+    armed = true;
+    SimHal::setAllocationHook(heapGuardFault);
+}
+
+#else
+
+void heapGuardArm()
+{
+    armed = true;
+}
+
+void *operator new(size_t size)
+{
+    if (armed)
+    {
+        heapGuardFault(size);
+    }
+    return malloc(size);
+}
+
+void *operator new[](size_t size)
+{
+    if (armed)
+    {
+        heapGuardFault(size);
+    }
+    return malloc(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return operator new(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return operator new[](size);
+}
+
+// The core's new.cpp defines new and delete in one object, so any reference
+// to a delete this file leaves out would link it in as well and collide with
+// the operators above. Every variant is replaced here, sized ones included.
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept
+{
+    free(ptr);
+}
+
+// Replaces the libnosys heap break so that malloc growing the heap after
+// setup() is caught too
+extern "C" void *_sbrk(ptrdiff_t increment)
+{
+    extern char end; // First free RAM after .bss, from the linker script
+    static char *heapTop = &end;
+
+    if (armed && increment > 0)
+    {
+        heapGuardFault(increment);
+    }
+    if (heapTop + increment > (char *)__get_MSP())
+    {
+        errno = ENOMEM;
+        return (void *)-1;
+    }
+    char *previous = heapTop;
+    heapTop += increment;
+    return previous;
+}
+
+#endif
+
+#endif
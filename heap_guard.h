@@ -0,0 +1,26 @@
+#ifndef HEAP_GUARD_H
+#define HEAP_GUARD_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// Static memory budget: everything the firmware needs is allocated by the
+// end of setup(), and the main loop must not touch the heap (a long-running
+// MCU fragments it). Built with ENABLE_HEAP_GUARD, heapGuardArm() at the end
+// of setup() turns any later allocation into a fault: the target reports it
+// and halts, the host simulation counts it and fails the run.
+//
+// On the target operator new and heap growth (_sbrk) are trapped, which
+// catches every String that needs more memory but not one that reuses a
+// freed block; the host HAL reports every String allocation.
+#if ENABLE_HEAP_GUARD
+void heapGuardArm();
+bool heapGuardIsArmed();
+unsigned long heapGuardGetViolations();
+#else
+inline void heapGuardArm() {}
+inline bool heapGuardIsArmed() { return false; }
+inline unsigned long heapGuardGetViolations() { return 0; }
+#endif
+
+#endif
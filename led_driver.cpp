@@ -0,0 +1,93 @@
+#include "led_driver.h"
+
+PwmPinLedDriver::PwmPinLedDriver(const int *channelPins, int count)
+{
+    channelCount = constrain(count, 0, MAX_LED_CHANNELS);
+    for (int i = 0; i < channelCount; i++)
+    {
+        pins[i] = channelPins[i];
+        shadow[i] = 0;
+    }
+}
+
+bool PwmPinLedDriver::begin()
+{
+    for (int i = 0; i < channelCount; i++)
+    {
+        pinMode(pins[i], OUTPUT);
+        analogWrite(pins[i], 0);
+        shadow[i] = 0;
+    }
+    return channelCount > 0;
+}
+
+int PwmPinLedDriver::getChannelCount()
+{
+    return channelCount;
+}
+
+void PwmPinLedDriver::commitFrame(const uint8_t *levels)
+{
+    for (int i = 0; i < channelCount; i++)
+    {
+        if (levels[i] != shadow[i])
+        {
+            shadow[i] = levels[i];
+            analogWrite(pins[i], levels[i]);
+        }
+    }
+}
+
+Tlc5947LedDriver::Tlc5947LedDriver(SPIClass &spi, uint32_t spiClockHz, int latch, int count)
+    : bus(spi)
+{
+    clockHz = spiClockHz;
+    latchPin = latch;
+    channelCount = constrain(count, 0, MAX_LED_CHANNELS);
+    chipCount = (channelCount + TLC5947_CHANNELS - 1) / TLC5947_CHANNELS;
+}
+
+bool Tlc5947LedDriver::begin()
+{
+    pinMode(latchPin, OUTPUT);
+    digitalWrite(latchPin, LOW);
+    bus.begin();
+
+    uint8_t dark[MAX_LED_CHANNELS] = {};
+    commitFrame(dark);
+    return channelCount > 0;
+}
+
+int Tlc5947LedDriver::getChannelCount()
+{
+    return channelCount;
+}
+
+void Tlc5947LedDriver::commitFrame(const uint8_t *levels)
+{
+    // Channels are shifted last first, two 12-bit values to three bytes.
+    // 8-bit levels widen as v * 4095 / 255, i.e. v repeated in the low nibble.
+    uint8_t *out = packed;
+    for (int channel = chipCount * TLC5947_CHANNELS - 1; channel > 0; channel -= 2)
+    {
+        uint8_t high = channel < channelCount ? levels[channel] : 0;
+        uint8_t low = channel - 1 < channelCount ? levels[channel - 1] : 0;
+        uint16_t first = (high << 4) | (high >> 4);
+        uint16_t second = (low << 4) | (low >> 4);
+        *out++ = first >> 4;
+        *out++ = (uint8_t)(first << 4) | (second >> 8);
+        *out++ = (uint8_t)second;
+    }
+
+    bus.beginTransaction(SPISettings(clockHz, MSBFIRST, SPI_MODE0));
+    bus.transfer(packed, getFrameBytes());
+    bus.endTransaction();
+
+    digitalWrite(latchPin, HIGH);
+    digitalWrite(latchPin, LOW);
+}
+
+size_t Tlc5947LedDriver::getFrameBytes()
+{
+    return (size_t)chipCount * TLC5947_FRAME_BYTES;
+}
@@ -0,0 +1,64 @@
+#ifndef LED_DRIVER_H
+#define LED_DRIVER_H
+
+#include <Arduino.h>
+#include <SPI.h>
+
+#define MAX_LED_CHANNELS 16
+#define TLC5947_CHANNELS 24   // Per chip, 12-bit PWM each
+#define TLC5947_FRAME_BYTES 36 // 24 x 12 bits
+#define TLC5947_MAX_CHIPS ((MAX_LED_CHANNELS + TLC5947_CHANNELS - 1) / TLC5947_CHANNELS)
+
+// Output stage for the strobe segments. Callers hand over a whole frame, one
+// level per channel, and the driver pushes it to the hardware in one go, so
+// patterns never see a half-updated rig and the cost of an edge is one
+// commit however many channels change. commitFrame() runs in the strobe
+// timer interrupt.
+class LedDriver
+{
+public:
+    virtual ~LedDriver() {}
+    virtual bool begin() = 0;
+    virtual int getChannelCount() = 0;
+    virtual void commitFrame(const uint8_t *levels) = 0;
+};
+
+// One native PWM pin per channel; only changed channels are written
+class PwmPinLedDriver : public LedDriver
+{
+private:
+    int pins[MAX_LED_CHANNELS];
+    uint8_t shadow[MAX_LED_CHANNELS];
+    int channelCount;
+
+public:
+    PwmPinLedDriver(const int *channelPins, int count);
+    bool begin() override;
+    int getChannelCount() override;
+    void commitFrame(const uint8_t *levels) override;
+};
+
+// A chain of TLC5947 24-channel PWM expanders on SPI. The whole frame is
+// shifted out in one burst (last channel first, 12 bits each) and latched
+// with a pulse on XLAT, so every segment changes on the same edge and the
+// bus cost is fixed per chip rather than per channel. The bus must not be
+// shared with anything driven from the main loop.
+class Tlc5947LedDriver : public LedDriver
+{
+private:
+    SPIClass &bus;
+    uint32_t clockHz;
+    int latchPin;
+    int channelCount;
+    int chipCount;
+    uint8_t packed[TLC5947_MAX_CHIPS * TLC5947_FRAME_BYTES];
+
+public:
+    Tlc5947LedDriver(SPIClass &spi, uint32_t spiClockHz, int latch, int count);
+    bool begin() override;
+    int getChannelCount() override;
+    void commitFrame(const uint8_t *levels) override;
+    size_t getFrameBytes();
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include "led_thermal.h"
+
+#define LED_THERMAL_TAU_S (LED_THERMAL_RESISTANCE_C_PER_W * LED_THERMAL_CAPACITY_J_PER_C)
+
+LedThermalModel::LedThermalModel()
+{
+    reset(25.0);
+}
+
+void LedThermalModel::reset(float ambientC)
+{
+    temperature = ambientC;
+    ambient = ambientC;
+}
+
+// Exact step for constant duty over dtS, so the update interval does not
+// affect accuracy
+void LedThermalModel::update(float duty, float ambientC, float dtS)
+{
+    ambient = ambientC;
+    float target = steadyStateAt(duty);
+    temperature = target + (temperature - target) * exp(-dtS / LED_THERMAL_TAU_S);
+}
+
+float LedThermalModel::getTemperature()
+{
+    return temperature;
+}
+
+float LedThermalModel::steadyStateAt(float duty)
+{
+    return ambient + constrain(duty, 0.0, 1.0) * LED_FULL_POWER_W * LED_THERMAL_RESISTANCE_C_PER_W;
+}
+
+// Seconds until the segment reaches limitC at this duty: 0 if it is there
+// already, -1 if it never will
+float LedThermalModel::timeToLimit(float duty, float limitC)
+{
+    if (temperature >= limitC)
+        return 0.0;
+
+    float target = steadyStateAt(duty);
+    if (target <= limitC)
+        return -1.0;
+
+    return LED_THERMAL_TAU_S * log((target - temperature) / (target - limitC));
+}
+
+float LedThermalModel::sustainableDuty(float limitC)
+{
+    float duty = (limitC - ambient) / (LED_FULL_POWER_W * LED_THERMAL_RESISTANCE_C_PER_W);
+    return constrain(duty, 0.0, 1.0);
+}
+
+// Output scale for a pattern asking for this duty. Full output while the
+// limit is more than LED_DERATE_HORIZON_S away, then a blend that reaches
+// the sustainable duty as the limit arrives, so the segment settles just
+// below it instead of overshooting. Above the target the scale keeps
+// falling in proportion to the excess.
+float LedThermalModel::derateScale(float duty)
+{
+    if (duty <= 0.0)
+        return 1.0;
+
+    float limit = LED_THERMAL_LIMIT_C - LED_DERATE_MARGIN_C;
+    float sustained = min(sustainableDuty(limit) / duty, 1.0f);
+    float remaining = timeToLimit(duty, limit);
+
+    if (remaining < 0.0 || remaining >= LED_DERATE_HORIZON_S)
+        return 1.0;
+    if (remaining > 0.0)
+        return sustained + (1.0 - sustained) * remaining / LED_DERATE_HORIZON_S;
+
+    float excess = (temperature - limit) / (LED_THERMAL_TRIP_C - limit);
+    return sustained * constrain(1.0 - excess, 0.0, 1.0);
+}
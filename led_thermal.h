@@ -0,0 +1,29 @@
+#ifndef LED_THERMAL_H
+#define LED_THERMAL_H
+
+#include <Arduino.h>
+#include "config.h"
+
+// First-order thermal RC model of one LED segment: heat in proportional to
+// PWM duty, heat out through LED_THERMAL_RESISTANCE_C_PER_W to the ambient
+// air. From it the strobe can tell how long it has before the limit at the
+// duty a pattern asks for, and which duty it can hold indefinitely, so it
+// can trade a little brightness early instead of going dark later.
+class LedThermalModel
+{
+private:
+    float temperature;
+    float ambient;
+
+public:
+    LedThermalModel();
+    void reset(float ambientC);
+    void update(float duty, float ambientC, float dtS);
+    float getTemperature();
+    float steadyStateAt(float duty);
+    float timeToLimit(float duty, float limitC);
+    float sustainableDuty(float limitC);
+    float derateScale(float duty);
+};
+
+#endif
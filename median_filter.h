@@ -0,0 +1,91 @@
+#ifndef MEDIAN_FILTER_H
+#define MEDIAN_FILTER_H
+
+// Sliding-window median kept as a sorted array alongside the arrival-order
+// ring. Each push() evicts the oldest sample and slides the new one into
+// place, so a sample costs one binary search plus the distance the value
+// moves, instead of a full sort of the window.
+template <int WindowSize>
+class StreamingMedian
+{
+    static_assert(WindowSize > 0, "Median window must hold at least one sample");
+    static_assert(WindowSize % 2 == 1, "Median window should be odd so the median is a sample");
+
+private:
+    float ring[WindowSize];
+    float sorted[WindowSize];
+    int head;
+    int count;
+
+    int findSorted(float value) const
+    {
+        int low = 0;
+        int high = count - 1;
+        while (low < high)
+        {
+            int mid = (low + high) / 2;
+            if (sorted[mid] < value)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        return low;
+    }
+
+public:
+    StreamingMedian() { reset(); }
+
+    void reset()
+    {
+        head = 0;
+        count = 0;
+    }
+
+    void push(float value)
+    {
+        int slot;
+
+        if (count < WindowSize)
+        {
+            slot = count++;
+        }
+        else
+        {
+            slot = findSorted(ring[head]);
+        }
+
+        ring[head] = value;
+        if (++head == WindowSize)
+            head = 0;
+
+        // Slide the freed slot towards where the new value belongs
+        while (slot > 0 && sorted[slot - 1] > value)
+        {
+            sorted[slot] = sorted[slot - 1];
+            slot--;
+        }
+        while (slot < count - 1 && sorted[slot + 1] < value)
+        {
+            sorted[slot] = sorted[slot + 1];
+            slot++;
+        }
+        sorted[slot] = value;
+    }
+
+    float median() const
+    {
+        return count > 0 ? sorted[count / 2] : 0.0f;
+    }
+
+    int size() const
+    {
+        return count;
+    }
+
+    bool isFull() const
+    {
+        return count == WindowSize;
+    }
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include "perf_monitor.h"
+
+#if ENABLE_PERFORMANCE_MONITORING
+PerfProbe perfProbes[PERF_PROBE_COUNT] = {
+    PerfProbe("detection"),
+    PerfProbe("visual"),
+    PerfProbe("audio"),
+    PerfProbe("weather"),
+    PerfProbe("telemetry")};
+#endif
+
+PerfProbe::PerfProbe(const char *probeName)
+{
+    name = probeName;
+    reset();
+}
+
+int PerfProbe::bucketFor(unsigned long us)
+{
+    if (us < PERF_SUB_BUCKETS)
+        return (int)us;
+    if (us >= PERF_HISTOGRAM_MAX_US)
+        return PERF_HISTOGRAM_BUCKETS - 1;
+
+    int exponent = 31 - __builtin_clz(us);
+    int sub = (us >> (exponent - PERF_SUB_BUCKET_BITS)) & (PERF_SUB_BUCKETS - 1);
+    return (exponent - PERF_SUB_BUCKET_BITS + 1) * PERF_SUB_BUCKETS + sub;
+}
+
+unsigned long PerfProbe::bucketUpperBound(int bucket)
+{
+    if (bucket < PERF_SUB_BUCKETS)
+        return (unsigned long)bucket;
+
+    int exponent = bucket / PERF_SUB_BUCKETS + PERF_SUB_BUCKET_BITS - 1;
+    int sub = bucket % PERF_SUB_BUCKETS;
+    unsigned long width = 1UL << (exponent - PERF_SUB_BUCKET_BITS);
+    return (1UL << exponent) + (sub + 1) * width - 1;
+}
+
+void PerfProbe::record(unsigned long us)
+{
+    count++;
+    totalUs += us;
+    if (us < minUs)
+    {
+        minUs = us;
+    }
+    if (us > maxUs)
+    {
+        maxUs = us;
+    }
+    histogram[bucketFor(us)]++;
+}
+
+void PerfProbe::reset()
+{
+    count = 0;
+    minUs = 0xFFFFFFFFUL;
+    maxUs = 0;
+    totalUs = 0;
+    for (int i = 0; i < PERF_HISTOGRAM_BUCKETS; i++)
+    {
+        histogram[i] = 0;
+    }
+}
+
+const char *PerfProbe::getName()
+{
+    return name;
+}
+
+unsigned long PerfProbe::getCount()
+{
+    return count;
+}
+
+unsigned long PerfProbe::getMin()
+{
+    return count > 0 ? minUs : 0;
+}
+
+unsigned long PerfProbe::getMax()
+{
+    return maxUs;
+}
+
+unsigned long PerfProbe::getMean()
+{
+    return count > 0 ? (unsigned long)(totalUs / count) : 0;
+}
+
+unsigned long PerfProbe::getPercentile(float fraction)
+{
+    if (count == 0)
+        return 0;
+
+    // Upper edge of the bucket holding the rank, capped by the true maximum
+    unsigned long rank = (unsigned long)(fraction * (count - 1)) + 1;
+    unsigned long seen = 0;
+    for (int i = 0; i < PERF_HISTOGRAM_BUCKETS; i++)
+    {
+        seen += histogram[i];
+        if (seen >= rank)
+        {
+            unsigned long bound = bucketUpperBound(i);
+            return bound < maxUs ? bound : maxUs;
+        }
+    }
+    return maxUs;
+}
+
+void perfPrintReport()
+{
+#if ENABLE_PERFORMANCE_MONITORING
+    Serial.println("\n=== PERFORMANCE (us) ===");
+    for (int i = 0; i < PERF_PROBE_COUNT; i++)
+    {
+        PerfProbe &probe = perfProbes[i];
+        Serial.print(probe.getName());
+        Serial.print(": n ");
+        Serial.print(probe.getCount());
+        Serial.print(", min ");
+        Serial.print(probe.getMin());
+        Serial.print(", mean ");
+        Serial.print(probe.getMean());
+        Serial.print(", p99 ");
+        Serial.print(probe.getPercentile(0.99));
+        Serial.print(", max ");
+        Serial.println(probe.getMax());
+    }
+    Serial.println("========================\n");
+#else
+    Serial.println("Performance monitoring disabled");
+#endif
+}
+
+void perfResetAll()
+{
+#if ENABLE_PERFORMANCE_MONITORING
+    for (int i = 0; i < PERF_PROBE_COUNT; i++)
+    {
+        perfProbes[i].reset();
+    }
+#endif
+}
@@ -0,0 +1,91 @@
+#ifndef PERF_MONITOR_H
+#define PERF_MONITOR_H
+
+#include <Arduino.h>
+#include "config.h"
+
+#ifndef ENABLE_PERFORMANCE_MONITORING
+#define ENABLE_PERFORMANCE_MONITORING 0
+#endif
+
+// Log-linear histogram: exact below 4 us, then 4 buckets per power of two
+// (<= 25% quantisation) up to PERF_HISTOGRAM_MAX_US; anything longer lands
+// in the last bucket.
+#define PERF_SUB_BUCKET_BITS 2
+#define PERF_SUB_BUCKETS (1 << PERF_SUB_BUCKET_BITS)
+#define PERF_HISTOGRAM_MAX_EXPONENT 16
+#define PERF_HISTOGRAM_MAX_US (1UL << (PERF_HISTOGRAM_MAX_EXPONENT + 1))
+#define PERF_HISTOGRAM_BUCKETS (PERF_SUB_BUCKETS * PERF_HISTOGRAM_MAX_EXPONENT)
+
+enum PerfProbeId
+{
+    PERF_DETECTION_UPDATE,
+    PERF_VISUAL_UPDATE,
+    PERF_AUDIO_UPDATE,
+    PERF_WEATHER_UPDATE,
+    PERF_TELEMETRY_SERIALIZE,
+    PERF_PROBE_COUNT
+};
+
+// Timing distribution of one instrumented section. Fixed size, no heap;
+// record() is a handful of integer operations so it can sit on hot paths.
+class PerfProbe
+{
+private:
+    const char *name;
+    unsigned long count;
+    unsigned long minUs;
+    unsigned long maxUs;
+    unsigned long long totalUs;
+    unsigned long histogram[PERF_HISTOGRAM_BUCKETS];
+
+    static int bucketFor(unsigned long us);
+    static unsigned long bucketUpperBound(int bucket);
+
+public:
+    explicit PerfProbe(const char *probeName);
+    void record(unsigned long us);
+    void reset();
+
+    const char *getName();
+    unsigned long getCount();
+    unsigned long getMin();
+    unsigned long getMax();
+    unsigned long getMean();
+    unsigned long getPercentile(float fraction);
+};
+
+#if ENABLE_PERFORMANCE_MONITORING
+
+extern PerfProbe perfProbes[PERF_PROBE_COUNT];
+
+// Records the lifetime of the enclosing scope against a probe
+class ScopedPerfTimer
+{
+private:
+    PerfProbe &probe;
+    unsigned long startUs;
+
+public:
+    explicit ScopedPerfTimer(PerfProbeId id) : probe(perfProbes[id]), startUs(micros()) {}
+    ~ScopedPerfTimer() { probe.record(micros() - startUs); }
+};
+
+#define PERF_CONCAT_INNER(a, b) a##b
+#define PERF_CONCAT(a, b) PERF_CONCAT_INNER(a, b)
+#define PERF_SCOPE(id) ScopedPerfTimer PERF_CONCAT(perfScope, __LINE__)(id)
+
+#else
+
+// Compiled out: no probe storage, no timer reads
+#define PERF_SCOPE(id) \
+    do                 \
+    {                  \
+    } while (0)
+
+#endif
+
+void perfPrintReport();
+void perfResetAll();
+
+#endif
@@ -31,7 +31,7 @@ enum PowerMode
 struct VoltageRail
 {
     PowerRail railId;
-    String name;
+    const char *name;
     float targetVoltage;
     float currentVoltage;
     float currentDraw;
@@ -103,13 +103,13 @@ public:
     VoltageRail *getRailInfo(PowerRail rail);
     PowerMetrics getMetrics();
     bool selfTest();
-    String getPowerReport();
+    void printPowerReport(Print &out);
     void resetEnergyCounters();
     float getRailVoltage(PowerRail rail);
     float getRailCurrent(PowerRail rail);
     bool isRailEnabled(PowerRail rail);
     void calibratePowerReadings();
-    String getModeString();
+    const char *getModeString();
     bool isBatteryHealthy();
     float getEstimatedRuntime();
 };
@@ -0,0 +1,193 @@
+#include "sensor_array.h"
+#include "config.h"
+
+SensorArrayScheduler::SensorArrayScheduler()
+{
+    groupCount = 0;
+    currentGroup = 0;
+    slotClockStarted = false;
+    nextSlotUs = 0;
+    windowStartUs = 0;
+    pingsInWindow = 0;
+    achievedPingRate = 0.0;
+
+    for (int i = 0; i < MAX_SENSORS; i++)
+    {
+        groupSizes[i] = 0;
+    }
+
+    configureTiming(RANGING_MAX_RANGE_CM, 20.0);
+}
+
+float SensorArrayScheduler::speedOfSoundAt(float temperatureC)
+{
+#if ULTRASONIC_TEMPERATURE_COMPENSATION
+    return 331.3 * sqrt(1.0 + temperatureC / 273.15);
+#else
+    return ULTRASONIC_SPEED_OF_SOUND_MPS;
+#endif
+}
+
+void SensorArrayScheduler::configureTiming(float maxRangeCm, float temperatureC)
+{
+    speedOfSound = speedOfSoundAt(temperatureC);
+
+    // Round trip in microseconds: 2 * range(m) / c(m/s) * 1e6
+    float usPerCm = 2.0 * 10000.0 / speedOfSound;
+    float reverbRangeCm = max(maxRangeCm, (float)RANGING_REVERB_RANGE_CM);
+
+    listenUs = (unsigned long)(maxRangeCm * usPerCm) + RANGING_SLOT_GUARD_US;
+    slotUs = (unsigned long)(reverbRangeCm * usPerCm) + RANGING_SLOT_GUARD_US;
+}
+
+bool SensorArrayScheduler::isSlotDue(unsigned long nowUs)
+{
+    return !slotClockStarted || (long)(nowUs - nextSlotUs) >= 0;
+}
+
+int SensorArrayScheduler::beginSlot(unsigned long nowUs)
+{
+    // Keep slots phase-locked to the frame; if we fell a whole slot behind
+    // (e.g. a long blocking call elsewhere) restart the frame from now
+    if (!slotClockStarted || (long)(nowUs - nextSlotUs) >= (long)slotUs)
+    {
+        nextSlotUs = nowUs;
+        slotClockStarted = true;
+    }
+    nextSlotUs += slotUs;
+
+    return nextGroup();
+}
+
+void SensorArrayScheduler::recordPings(int count, unsigned long nowUs)
+{
+    if (pingsInWindow == 0 && windowStartUs == 0)
+    {
+        windowStartUs = nowUs;
+    }
+
+    pingsInWindow += count;
+
+    unsigned long elapsed = nowUs - windowStartUs;
+    if (elapsed >= RANGING_RATE_WINDOW_US)
+    {
+        achievedPingRate = pingsInWindow * 1000000.0 / elapsed;
+        pingsInWindow = 0;
+        windowStartUs = nowUs;
+    }
+}
+
+bool SensorArrayScheduler::mountsConflict(const SensorMount &a, const SensorMount &b)
+{
+    float separation = fabs(a.azimuth - b.azimuth);
+    while (separation > 360.0)
+    {
+        separation -= 360.0;
+    }
+    if (separation > 180.0)
+    {
+        separation = 360.0 - separation;
+    }
+
+    float widestBeam = max(a.beamWidth, b.beamWidth);
+    return separation < widestBeam + SENSOR_CROSSTALK_MARGIN_DEG;
+}
+
+void SensorArrayScheduler::build(const SensorMount *mounts, int count)
+{
+    groupCount = 0;
+    currentGroup = 0;
+
+    // Greedy colouring in mounting order: each sensor joins the first group
+    // that has no member within its crosstalk cone
+    for (int sensor = 0; sensor < count && sensor < MAX_SENSORS; sensor++)
+    {
+        int group = 0;
+        for (; group < groupCount; group++)
+        {
+            bool conflict = false;
+            for (int m = 0; m < groupSizes[group] && !conflict; m++)
+            {
+                conflict = mountsConflict(mounts[sensor], mounts[groupMembers[group][m]]);
+            }
+            if (!conflict)
+                break;
+        }
+
+        if (group == groupCount)
+        {
+            groupSizes[group] = 0;
+            groupCount++;
+        }
+        groupMembers[group][groupSizes[group]++] = sensor;
+    }
+}
+
+int SensorArrayScheduler::nextGroup()
+{
+    if (groupCount == 0)
+        return -1;
+
+    int group = currentGroup;
+    currentGroup = (currentGroup + 1) % groupCount;
+    return group;
+}
+
+float SensorArrayScheduler::getSpeedOfSound()
+{
+    return speedOfSound;
+}
+
+unsigned long SensorArrayScheduler::getListenUs()
+{
+    return listenUs;
+}
+
+unsigned long SensorArrayScheduler::getSlotUs()
+{
+    return slotUs;
+}
+
+unsigned long SensorArrayScheduler::getFrameUs()
+{
+    return slotUs * groupCount;
+}
+
+float SensorArrayScheduler::getAchievedPingRate()
+{
+    return achievedPingRate;
+}
+
+float SensorArrayScheduler::getTheoreticalPingRate()
+{
+    if (groupCount == 0 || slotUs == 0)
+        return 0.0;
+
+    int sensors = 0;
+    for (int g = 0; g < groupCount; g++)
+    {
+        sensors += groupSizes[g];
+    }
+    return sensors * 1000000.0 / getFrameUs();
+}
+
+int SensorArrayScheduler::getGroupCount()
+{
+    return groupCount;
+}
+
+int SensorArrayScheduler::getGroupSize(int group)
+{
+    if (group < 0 || group >= groupCount)
+        return 0;
+
+    return groupSizes[group];
+}
+
+int SensorArrayScheduler::getGroupMember(int group, int index)
+{
+    if (group < 0 || group >= groupCount || index < 0 || index >= groupSizes[group])
+        return -1;
+
+    return groupMembers[group][index];
+}
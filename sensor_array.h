@@ -0,0 +1,69 @@
+#ifndef SENSOR_ARRAY_H
+#define SENSOR_ARRAY_H
+
+#include <Arduino.h>
+
+#define MAX_SENSORS 12
+#define SENSOR_DEFAULT_BEAM_WIDTH_DEG 30.0
+#define SENSOR_CROSSTALK_MARGIN_DEG 30.0
+
+#define RANGING_MAX_RANGE_CM 400.0
+#define RANGING_REVERB_RANGE_CM 500.0 // Beyond this, stray echoes are too weak to trigger
+#define RANGING_SLOT_GUARD_US 500      // Trigger, burst and echo-line settling
+#define RANGING_RATE_WINDOW_US 1000000
+
+// Physical description of one transducer in the ring
+struct SensorMount
+{
+    int trigPin;
+    int echoPin;
+    float azimuth;     // Boresight bearing, degrees clockwise from front
+    float beamWidth;   // Full beam width, degrees
+    float rangeOffset; // Distance from transducer face to array centre, cm
+};
+
+// Partitions the ring into firing groups whose members are far enough apart
+// in azimuth not to hear each other's echoes, and plays the groups as a TDMA
+// frame: one group per slot, each slot just long enough for the furthest
+// audible echo to die out at the current speed of sound.
+class SensorArrayScheduler
+{
+private:
+    uint8_t groupMembers[MAX_SENSORS][MAX_SENSORS];
+    uint8_t groupSizes[MAX_SENSORS];
+    int groupCount;
+    int currentGroup;
+
+    float speedOfSound; // m/s
+    unsigned long listenUs;
+    unsigned long slotUs;
+    unsigned long nextSlotUs;
+    bool slotClockStarted;
+
+    unsigned long windowStartUs;
+    unsigned long pingsInWindow;
+    float achievedPingRate;
+
+    static bool mountsConflict(const SensorMount &a, const SensorMount &b);
+
+public:
+    SensorArrayScheduler();
+    void build(const SensorMount *mounts, int count);
+    void configureTiming(float maxRangeCm, float temperatureC);
+    bool isSlotDue(unsigned long nowUs);
+    int beginSlot(unsigned long nowUs);
+    void recordPings(int count, unsigned long nowUs);
+    int nextGroup();
+    int getGroupCount();
+    int getGroupSize(int group);
+    int getGroupMember(int group, int index);
+    float getSpeedOfSound();
+    unsigned long getListenUs();
+    unsigned long getSlotUs();
+    unsigned long getFrameUs();
+    float getAchievedPingRate();
+    float getTheoreticalPingRate();
+    static float speedOfSoundAt(float temperatureC);
+};
+
+#endif
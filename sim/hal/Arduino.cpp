@@ -0,0 +1,535 @@
+#include "Arduino.h"
+#include "SimHal.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <deque>
+#include <map>
+
+#define SIM_ECHO_LATENCY_US 450 // Transducer burst time before the echo line rises
+
+namespace
+{
+    struct PendingEdge
+    {
+        uint64_t timeUs;
+        int pin;
+        int level;
+    };
+
+    struct EchoBinding
+    {
+        int echoPin;
+        SimHal::EchoScript script;
+    };
+
+    struct InterruptBinding
+    {
+        void (*callback)();
+        int mode;
+    };
+
+    struct SimTimer
+    {
+        void (*callback)() = nullptr;
+        uint32_t rateHz = 0;
+        uint64_t startUs = 0;
+        uint64_t ticks = 0;
+    };
+
+    struct HalState
+    {
+        uint64_t clockUs = 0;
+        bool interruptsEnabled = true;
+        int pinLevels[NUM_DIGITAL_PINS] = {};
+        int analogInputs[NUM_DIGITAL_PINS] = {};
+        int analogOutputs[NUM_DIGITAL_PINS] = {};
+        std::map<int, SimHal::AnalogScript> analogScripts;
+        std::map<int, EchoBinding> echoBindings; // keyed by trig pin
+        std::map<int, InterruptBinding> interruptBindings;
+        SimTimer timers[SimHal::TIMER_COUNT];
+        std::vector<PendingEdge> pendingEdges;
+        std::vector<SimHal::AnalogWriteRecord> analogWrites;
+        bool recordAnalogWrites = true;
+        bool serialEcho = false;
+        bool serialCapture = false;
+        std::string serialOutput;
+        std::deque<char> serialInput;
+        unsigned long randomState = 1;
+    };
+
+    HalState hal;
+
+    bool validPin(int pin)
+    {
+        return pin >= 0 && pin < NUM_DIGITAL_PINS;
+    }
+
+    void setLevel(int pin, int level)
+    {
+        int previous = hal.pinLevels[pin];
+        hal.pinLevels[pin] = level;
+
+        if (previous == level || !hal.interruptsEnabled)
+            return;
+
+        std::map<int, InterruptBinding>::iterator it = hal.interruptBindings.find(pin);
+        if (it == hal.interruptBindings.end())
+            return;
+
+        int mode = it->second.mode;
+        if (mode == CHANGE || (mode == RISING && level == HIGH) || (mode == FALLING && level == LOW))
+        {
+            it->second.callback();
+        }
+    }
+
+    uint64_t nextTimerTickUs(const SimTimer &timer)
+    {
+        return timer.startUs + (timer.ticks + 1) * 1000000ULL / timer.rateHz;
+    }
+
+    // Earliest pending tick across all attached timers, or -1 for none
+    int nextTimer(uint64_t &tickUs)
+    {
+        int next = -1;
+        for (int i = 0; i < SimHal::TIMER_COUNT; i++)
+        {
+            if (hal.timers[i].callback == nullptr)
+                continue;
+            uint64_t us = nextTimerTickUs(hal.timers[i]);
+            if (next < 0 || us < tickUs)
+            {
+                next = i;
+                tickUs = us;
+            }
+        }
+        return next;
+    }
+
+    void scheduleEdge(uint64_t timeUs, int pin, int level)
+    {
+        PendingEdge edge = {timeUs, pin, level};
+        std::vector<PendingEdge>::iterator pos = std::upper_bound(
+            hal.pendingEdges.begin(), hal.pendingEdges.end(), edge,
+            [](const PendingEdge &a, const PendingEdge &b) { return a.timeUs < b.timeUs; });
+        hal.pendingEdges.insert(pos, edge);
+    }
+}
+
+namespace SimHal
+{
+    void reset()
+    {
+        hal = HalState();
+    }
+
+    uint64_t nowMicros()
+    {
+        return hal.clockUs;
+    }
+
+    void advanceMicros(uint64_t us)
+    {
+        uint64_t target = hal.clockUs + us;
+
+        for (;;)
+        {
+            bool edgeDue = !hal.pendingEdges.empty() && hal.pendingEdges.front().timeUs <= target;
+            uint64_t tickUs = target + 1;
+            int timer = nextTimer(tickUs);
+
+            if (timer >= 0 && tickUs <= target && (!edgeDue || tickUs < hal.pendingEdges.front().timeUs))
+            {
+                hal.clockUs = max(hal.clockUs, tickUs);
+                hal.timers[timer].ticks++;
+                if (hal.interruptsEnabled)
+                {
+                    hal.timers[timer].callback();
+                }
+                continue;
+            }
+            if (!edgeDue)
+                break;
+
+            PendingEdge edge = hal.pendingEdges.front();
+            hal.pendingEdges.erase(hal.pendingEdges.begin());
+            if (edge.timeUs > hal.clockUs)
+            {
+                hal.clockUs = edge.timeUs;
+            }
+            setLevel(edge.pin, edge.level);
+        }
+
+        hal.clockUs = target;
+    }
+
+    void setAnalogInput(int pin, int value)
+    {
+        if (validPin(pin))
+        {
+            hal.analogScripts.erase(pin);
+            hal.analogInputs[pin] = value;
+        }
+    }
+
+    void setAnalogScript(int pin, AnalogScript script)
+    {
+        hal.analogScripts[pin] = script;
+    }
+
+    void attachEchoScript(int trigPin, int echoPin, EchoScript script)
+    {
+        EchoBinding binding = {echoPin, script};
+        hal.echoBindings[trigPin] = binding;
+    }
+
+    void attachTimer(uint32_t rateHz, void (*callback)(), int timer)
+    {
+        if (rateHz == 0 || timer < 0 || timer >= TIMER_COUNT)
+            return;
+
+        SimTimer &slot = hal.timers[timer];
+        slot.callback = callback;
+        slot.rateHz = rateHz;
+        slot.startUs = hal.clockUs;
+        slot.ticks = 0;
+    }
+
+    void detachTimer(int timer)
+    {
+        if (timer >= 0 && timer < TIMER_COUNT)
+        {
+            hal.timers[timer].callback = nullptr;
+        }
+    }
+
+    int getPinLevel(int pin)
+    {
+        return validPin(pin) ? hal.pinLevels[pin] : LOW;
+    }
+
+    int getLastAnalogWrite(int pin)
+    {
+        return validPin(pin) ? hal.analogOutputs[pin] : 0;
+    }
+
+    const std::vector<AnalogWriteRecord> &getAnalogWrites()
+    {
+        return hal.analogWrites;
+    }
+
+    void setRecordAnalogWrites(bool enabled)
+    {
+        hal.recordAnalogWrites = enabled;
+    }
+
+    void clearAnalogWrites()
+    {
+        hal.analogWrites.clear();
+    }
+
+    void setSerialEcho(bool enabled)
+    {
+        hal.serialEcho = enabled;
+    }
+
+    void setSerialCapture(bool enabled)
+    {
+        hal.serialCapture = enabled;
+    }
+
+    void injectSerialInput(const std::string &text)
+    {
+        hal.serialInput.insert(hal.serialInput.end(), text.begin(), text.end());
+    }
+
+    const std::string &getSerialOutput()
+    {
+        return hal.serialOutput;
+    }
+
+    void clearSerialOutput()
+    {
+        hal.serialOutput.clear();
+    }
+}
+
+unsigned long millis()
+{
+    return (unsigned long)(hal.clockUs / 1000);
+}
+
+unsigned long micros()
+{
+    return (unsigned long)hal.clockUs;
+}
+
+void delay(unsigned long ms)
+{
+    SimHal::advanceMicros((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    SimHal::advanceMicros(us);
+}
+
+void pinMode(int pin, int mode)
+{
+    if (validPin(pin) && mode == INPUT_PULLUP)
+    {
+        hal.pinLevels[pin] = HIGH;
+    }
+}
+
+void digitalWrite(int pin, int value)
+{
+    if (!validPin(pin))
+        return;
+
+    int previous = hal.pinLevels[pin];
+    setLevel(pin, value ? HIGH : LOW);
+
+    // Falling edge on a trigger pin launches the scripted echo
+    if (previous == HIGH && value == LOW)
+    {
+        std::map<int, EchoBinding>::iterator it = hal.echoBindings.find(pin);
+        if (it != hal.echoBindings.end())
+        {
+            unsigned long width = it->second.script(hal.clockUs);
+            if (width > 0)
+            {
+                uint64_t rise = hal.clockUs + SIM_ECHO_LATENCY_US;
+                scheduleEdge(rise, it->second.echoPin, HIGH);
+                scheduleEdge(rise + width, it->second.echoPin, LOW);
+            }
+        }
+    }
+}
+
+int digitalRead(int pin)
+{
+    return validPin(pin) ? hal.pinLevels[pin] : LOW;
+}
+
+int analogRead(int pin)
+{
+    if (!validPin(pin))
+        return 0;
+
+    std::map<int, SimHal::AnalogScript>::iterator it = hal.analogScripts.find(pin);
+    if (it != hal.analogScripts.end())
+    {
+        return constrain(it->second(hal.clockUs), 0, 1023);
+    }
+    return hal.analogInputs[pin];
+}
+
+void analogWrite(int pin, int value)
+{
+    if (!validPin(pin))
+        return;
+
+    hal.analogOutputs[pin] = value;
+    if (hal.recordAnalogWrites)
+    {
+        SimHal::AnalogWriteRecord record = {hal.clockUs, pin, value};
+        hal.analogWrites.push_back(record);
+    }
+}
+
+unsigned long pulseIn(int pin, int state, unsigned long timeout)
+{
+    uint64_t start = hal.clockUs;
+    uint64_t deadline = start + timeout;
+    uint64_t pulseStart = 0;
+    bool inPulse = false;
+
+    for (size_t i = 0; i < hal.pendingEdges.size(); i++)
+    {
+        const PendingEdge &edge = hal.pendingEdges[i];
+        if (edge.pin != pin)
+            continue;
+        if (!inPulse && edge.level == state)
+        {
+            if (edge.timeUs > deadline)
+                break;
+            pulseStart = edge.timeUs;
+            inPulse = true;
+        }
+        else if (inPulse && edge.level != state)
+        {
+            SimHal::advanceMicros(edge.timeUs - start);
+            return (unsigned long)(edge.timeUs - pulseStart);
+        }
+    }
+
+    SimHal::advanceMicros(timeout);
+    return 0;
+}
+
+void attachInterrupt(int interruptNumber, void (*callback)(), int mode)
+{
+    InterruptBinding binding = {callback, mode};
+    hal.interruptBindings[interruptNumber] = binding;
+}
+
+void detachInterrupt(int interruptNumber)
+{
+    hal.interruptBindings.erase(interruptNumber);
+}
+
+void noInterrupts()
+{
+    hal.interruptsEnabled = false;
+}
+
+void interrupts()
+{
+    hal.interruptsEnabled = true;
+}
+
+long random(long maxValue)
+{
+    if (maxValue <= 0)
+        return 0;
+
+    // Fixed LCG so simulations are reproducible
+    hal.randomState = hal.randomState * 1103515245UL + 12345UL;
+    return (long)((hal.randomState >> 16) % (unsigned long)maxValue);
+}
+
+long random(long minValue, long maxValue)
+{
+    if (minValue >= maxValue)
+        return minValue;
+    return minValue + random(maxValue - minValue);
+}
+
+void randomSeed(unsigned long seed)
+{
+    hal.randomState = seed;
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+    size_t n = 0;
+    while (size--)
+    {
+        n += write(*buffer++);
+    }
+    return n;
+}
+
+size_t Print::print(const char *str)
+{
+    return write(str);
+}
+
+size_t Print::print(const String &str)
+{
+    return write(str.c_str());
+}
+
+size_t Print::print(char c)
+{
+    return write((uint8_t)c);
+}
+
+// Formats on the stack, as the Arduino core does: printing never allocates
+static size_t printNumber(Print &out, unsigned long long value, bool negative, int base)
+{
+    if (base < 2 || base > 16)
+        base = 10;
+
+    char digits[72];
+    int pos = sizeof(digits) - 1;
+    digits[pos] = 0;
+    do
+    {
+        digits[--pos] = "0123456789abcdef"[value % base];
+        value /= base;
+    } while (value > 0);
+    if (negative)
+    {
+        digits[--pos] = '-';
+    }
+    return out.write(&digits[pos]);
+}
+
+size_t Print::print(int value, int base)
+{
+    return printNumber(*this, value < 0 ? -(long long)value : value, value < 0, base);
+}
+
+size_t Print::print(unsigned int value, int base)
+{
+    return printNumber(*this, value, false, base);
+}
+
+size_t Print::print(long value, int base)
+{
+    return printNumber(*this, value < 0 ? -(long long)value : value, value < 0, base);
+}
+
+size_t Print::print(unsigned long value, int base)
+{
+    return printNumber(*this, value, false, base);
+}
+
+size_t Print::print(double value, int digits)
+{
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", digits, value);
+    return write(text);
+}
+
+size_t Print::println()
+{
+    return write("\r\n");
+}
+
+HardwareSerial Serial;
+
+void HardwareSerial::begin(unsigned long baud)
+{
+    (void)baud;
+}
+
+int HardwareSerial::available()
+{
+    return (int)hal.serialInput.size();
+}
+
+int HardwareSerial::read()
+{
+    if (hal.serialInput.empty())
+        return -1;
+    char c = hal.serialInput.front();
+    hal.serialInput.pop_front();
+    return (unsigned char)c;
+}
+
+int HardwareSerial::peek()
+{
+    return hal.serialInput.empty() ? -1 : (unsigned char)hal.serialInput.front();
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    if (hal.serialEcho)
+    {
+        fwrite(buffer, 1, size, stdout);
+    }
+    if (hal.serialCapture)
+    {
+        hal.serialOutput.append((const char *)buffer, size);
+    }
+    return size;
+}
@@ -0,0 +1,150 @@
+#ifndef SIM_ARDUINO_H
+#define SIM_ARDUINO_H
+
+// Host-side stand-in for the Arduino core. Time is virtual: millis()/micros()
+// only advance through delay(), delayMicroseconds() or SimHal::advanceMicros(),
+// so a sketch can be run far faster than real time and fully deterministically.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <type_traits>
+
+#include "WString.h"
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define PI 3.1415926535897932384626433832795
+#define TWO_PI 6.283185307179586476925286766559
+
+#define DEC 10
+#define HEX 16
+
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_float(addr) (*(const float *)(addr))
+
+#define NUM_DIGITAL_PINS 64
+#define NUM_ANALOG_INPUTS 8
+
+enum AnalogPins
+{
+    A0 = 40,
+    A1,
+    A2,
+    A3,
+    A4,
+    A5,
+    A6,
+    A7
+};
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+template <typename T, typename U>
+inline typename std::common_type<T, U>::type min(T a, U b)
+{
+    return a < b ? a : b;
+}
+
+template <typename T, typename U>
+inline typename std::common_type<T, U>::type max(T a, U b)
+{
+    return a > b ? a : b;
+}
+
+template <typename T, typename L, typename H>
+inline T constrain(T value, L low, H high)
+{
+    return value < low ? (T)low : (value > high ? (T)high : value);
+}
+
+inline long map(long x, long inMin, long inMax, long outMin, long outMax)
+{
+    return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int value);
+int digitalRead(int pin);
+int analogRead(int pin);
+void analogWrite(int pin, int value);
+unsigned long pulseIn(int pin, int state, unsigned long timeout = 1000000UL);
+
+void attachInterrupt(int interruptNumber, void (*callback)(), int mode);
+void detachInterrupt(int interruptNumber);
+inline int digitalPinToInterrupt(int pin) { return pin; }
+void noInterrupts();
+void interrupts();
+
+long random(long maxValue);
+long random(long minValue, long maxValue);
+void randomSeed(unsigned long seed);
+
+class Print
+{
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *str) { return write((const uint8_t *)str, strlen(str)); }
+
+    size_t print(const char *str);
+    size_t print(const String &str);
+    size_t print(char c);
+    size_t print(int value, int base = DEC);
+    size_t print(unsigned int value, int base = DEC);
+    size_t print(long value, int base = DEC);
+    size_t print(unsigned long value, int base = DEC);
+    size_t print(double value, int digits = 2);
+
+    size_t println();
+    template <typename T>
+    size_t println(const T &value)
+    {
+        size_t n = print(value);
+        return n + println();
+    }
+    template <typename T>
+    size_t println(const T &value, int format)
+    {
+        size_t n = print(value, format);
+        return n + println();
+    }
+};
+
+class HardwareSerial : public Print
+{
+public:
+    void begin(unsigned long baud);
+    int available();
+    int read();
+    int peek();
+    void flush() {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
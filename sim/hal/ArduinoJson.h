@@ -0,0 +1,117 @@
+#ifndef SIM_ARDUINOJSON_H
+#define SIM_ARDUINOJSON_H
+
+// Just enough of ArduinoJson for the sketch's flat telemetry objects.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+class DynamicJsonDocument
+{
+public:
+    class Slot
+    {
+    private:
+        std::string &value;
+
+        static std::string quote(const char *text)
+        {
+            std::string result = "\"";
+            for (const char *c = text; *c; c++)
+            {
+                if (*c == '"' || *c == '\\')
+                    result += '\\';
+                result += *c;
+            }
+            return result + "\"";
+        }
+
+    public:
+        explicit Slot(std::string &target) : value(target) {}
+
+        Slot &operator=(const char *text)
+        {
+            value = quote(text);
+            return *this;
+        }
+        Slot &operator=(const String &text)
+        {
+            value = quote(text.c_str());
+            return *this;
+        }
+        Slot &operator=(bool flag)
+        {
+            value = flag ? "true" : "false";
+            return *this;
+        }
+        Slot &operator=(int number) { return assignInteger(number); }
+        Slot &operator=(unsigned int number) { return assignInteger(number); }
+        Slot &operator=(long number) { return assignInteger(number); }
+        Slot &operator=(unsigned long number) { return assignInteger(number); }
+        Slot &operator=(float number) { return operator=((double)number); }
+        Slot &operator=(double number)
+        {
+            char text[32];
+            snprintf(text, sizeof(text), "%.9g", number);
+            value = text;
+            return *this;
+        }
+
+    private:
+        template <typename T>
+        Slot &assignInteger(T number)
+        {
+            value = std::to_string(number);
+            return *this;
+        }
+    };
+
+    explicit DynamicJsonDocument(size_t capacity) : capacityBytes(capacity) {}
+
+    Slot operator[](const char *key)
+    {
+        for (size_t i = 0; i < members.size(); i++)
+        {
+            if (members[i].first == key)
+                return Slot(members[i].second);
+        }
+        members.push_back(std::make_pair(std::string(key), std::string("null")));
+        return Slot(members.back().second);
+    }
+
+    std::string serialize() const
+    {
+        std::string result = "{";
+        for (size_t i = 0; i < members.size(); i++)
+        {
+            if (i > 0)
+                result += ",";
+            result += "\"" + members[i].first + "\":" + members[i].second;
+        }
+        return result + "}";
+    }
+
+    size_t capacity() const { return capacityBytes; }
+
+private:
+    size_t capacityBytes;
+    std::vector<std::pair<std::string, std::string>> members;
+};
+
+inline size_t serializeJson(const DynamicJsonDocument &doc, String &output)
+{
+    std::string text = doc.serialize();
+    output = text.c_str();
+    return text.length();
+}
+
+inline size_t serializeJson(const DynamicJsonDocument &doc, Print &output)
+{
+    std::string text = doc.serialize();
+    return output.write((const uint8_t *)text.data(), text.length());
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef SIM_SPI_H
+#define SIM_SPI_H
+
+#include <Arduino.h>
+#include <vector>
+
+#ifndef MSBFIRST
+#define MSBFIRST 1
+#define LSBFIRST 0
+#endif
+#define SPI_MODE0 0x00
+
+struct SPISettings
+{
+    uint32_t clockHz;
+    uint8_t bitOrder;
+    uint8_t dataMode;
+
+    SPISettings(uint32_t clock = 4000000, uint8_t order = MSBFIRST, uint8_t mode = SPI_MODE0)
+        : clockHz(clock), bitOrder(order), dataMode(mode)
+    {
+    }
+};
+
+// Records what was clocked out so simulations can decode it: the bytes of
+// the most recent transaction, plus running totals.
+class SPIClass
+{
+public:
+    unsigned long transactions = 0;
+    unsigned long bytesTransferred = 0;
+    uint32_t clockHz = 0;
+    std::vector<uint8_t> lastTransaction;
+
+    void begin() {}
+    void end() {}
+    void beginTransaction(SPISettings settings)
+    {
+        clockHz = settings.clockHz;
+        transactions++;
+        lastTransaction.clear();
+    }
+    void endTransaction() {}
+    uint8_t transfer(uint8_t data)
+    {
+        lastTransaction.push_back(data);
+        bytesTransferred++;
+        return 0;
+    }
+    void transfer(void *buffer, size_t count)
+    {
+        uint8_t *bytes = (uint8_t *)buffer;
+        lastTransaction.insert(lastTransaction.end(), bytes, bytes + count);
+        bytesTransferred += count;
+        for (size_t i = 0; i < count; i++)
+        {
+            bytes[i] = 0; // Nothing is shifted back in
+        }
+    }
+};
+
+inline SPIClass SPI;
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef SIM_HAL_H
+#define SIM_HAL_H
+
+// Scripting and inspection API for the host-side Arduino shim. Simulations
+// use this to drive inputs (analog levels, ultrasonic echoes, serial bytes)
+// and to read back what the firmware did (analogWrite history, pin levels).
+
+#include <stddef.h>
+#include <stdint.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace SimHal
+{
+    struct AnalogWriteRecord
+    {
+        uint64_t timeUs;
+        int pin;
+        int value;
+    };
+
+    // Returns the echo pulse width in microseconds for a ping fired at the
+    // given virtual time, or 0 for "no echo".
+    typedef std::function<unsigned long(uint64_t timeUs)> EchoScript;
+    typedef std::function<int(uint64_t timeUs)> AnalogScript;
+
+    void reset();
+
+    uint64_t nowMicros();
+    void advanceMicros(uint64_t us);
+
+    void setAnalogInput(int pin, int value);
+    void setAnalogScript(int pin, AnalogScript script);
+
+    // Wires an ultrasonic transducer: a falling edge on trigPin schedules a
+    // HIGH pulse on echoPin, both for pulseIn() and for attached interrupts.
+    void attachEchoScript(int trigPin, int echoPin, EchoScript script);
+
+    // Periodic timer interrupts, one per hardware timer the firmware uses
+    // (e.g. the audio sample clock and the strobe tick). Ticks are
+    // interleaved with each other and with scripted pin edges as virtual
+    // time advances.
+    enum
+    {
+        TIMER_AUDIO = 0,
+        TIMER_STROBE = 1,
+        TIMER_COUNT
+    };
+    void attachTimer(uint32_t rateHz, void (*callback)(), int timer = TIMER_AUDIO);
+    void detachTimer(int timer = TIMER_AUDIO);
+
+    int getPinLevel(int pin);
+    int getLastAnalogWrite(int pin);
+    const std::vector<AnalogWriteRecord> &getAnalogWrites();
+    void setRecordAnalogWrites(bool enabled);
+    void clearAnalogWrites();
+
+    // Simulated MCU heap. Arduino String is the only heap user the firmware
+    // has; every buffer (re)allocation is counted in payload bytes.
+    struct HeapStats
+    {
+        size_t inUse;
+        size_t peak;
+        unsigned long allocations;
+    };
+    typedef void (*AllocationHook)(size_t bytes);
+
+    HeapStats getHeapStats();
+    void resetHeapPeak(); // Peak restarts from current use, allocation count from zero
+    void setAllocationHook(AllocationHook hook);
+
+    void setSerialEcho(bool enabled);
+    void setSerialCapture(bool enabled);
+    void injectSerialInput(const std::string &text);
+    const std::string &getSerialOutput();
+    void clearSerialOutput();
+}
+
+#endif
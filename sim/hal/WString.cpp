@@ -0,0 +1,360 @@
+#include "WString.h"
+#include "SimHal.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Simulated MCU heap: payload bytes currently held by String buffers
+static size_t heapInUse = 0;
+static size_t heapPeak = 0;
+static unsigned long heapAllocations = 0;
+static SimHal::AllocationHook allocationHook = nullptr;
+
+static char *heapRealloc(char *block, size_t oldSize, size_t newSize)
+{
+    char *result = (char *)realloc(block, newSize);
+    if (result == nullptr)
+        return nullptr;
+
+    heapInUse = heapInUse - oldSize + newSize;
+    if (heapInUse > heapPeak)
+    {
+        heapPeak = heapInUse;
+    }
+    heapAllocations++;
+    if (allocationHook)
+    {
+        allocationHook(newSize);
+    }
+    return result;
+}
+
+static void heapFree(char *block, size_t size)
+{
+    if (block == nullptr)
+        return;
+    heapInUse -= size;
+    free(block);
+}
+
+namespace SimHal
+{
+    HeapStats getHeapStats()
+    {
+        HeapStats stats = {heapInUse, heapPeak, heapAllocations};
+        return stats;
+    }
+
+    void resetHeapPeak()
+    {
+        heapPeak = heapInUse;
+        heapAllocations = 0;
+    }
+
+    void setAllocationHook(AllocationHook hook)
+    {
+        allocationHook = hook;
+    }
+}
+
+void String::init()
+{
+    buffer = nullptr;
+    capacity = 0;
+    len = 0;
+}
+
+void String::release()
+{
+    heapFree(buffer, buffer ? capacity + 1 : 0);
+    init();
+}
+
+// Grows to exactly the requested size, as the Arduino core does
+bool String::reserve(unsigned int size)
+{
+    if (buffer && capacity >= size)
+        return true;
+
+    char *grown = heapRealloc(buffer, buffer ? capacity + 1 : 0, size + 1);
+    if (grown == nullptr)
+        return false;
+    if (buffer == nullptr)
+    {
+        grown[0] = 0;
+    }
+    buffer = grown;
+    capacity = size;
+    return true;
+}
+
+String &String::copy(const char *str, unsigned int length)
+{
+    if (!reserve(length))
+    {
+        release();
+        return *this;
+    }
+    len = length;
+    memmove(buffer, str, length);
+    buffer[len] = 0;
+    return *this;
+}
+
+bool String::concat(const char *str, unsigned int length)
+{
+    if (length == 0)
+        return true;
+    if (!reserve(len + length))
+        return false;
+    memmove(buffer + len, str, length);
+    len += length;
+    buffer[len] = 0;
+    return true;
+}
+
+String::String(const char *str)
+{
+    init();
+    if (str)
+    {
+        copy(str, strlen(str));
+    }
+}
+
+String::String(const String &other)
+{
+    init();
+    copy(other.c_str(), other.len);
+}
+
+String::String(String &&other)
+{
+    buffer = other.buffer;
+    capacity = other.capacity;
+    len = other.len;
+    other.init();
+}
+
+String::String(char c)
+{
+    init();
+    copy(&c, 1);
+}
+
+static void formatInteger(String &target, unsigned long long value, bool negative, unsigned char base)
+{
+    if (base < 2 || base > 16)
+        base = 10;
+
+    char digits[72];
+    int pos = sizeof(digits) - 1;
+    digits[pos] = 0;
+    do
+    {
+        digits[--pos] = "0123456789abcdef"[value % base];
+        value /= base;
+    } while (value > 0);
+    if (negative)
+    {
+        digits[--pos] = '-';
+    }
+    target = &digits[pos];
+}
+
+String::String(int value, unsigned char base)
+{
+    init();
+    formatInteger(*this, value < 0 ? -(long long)value : value, value < 0, base);
+}
+
+String::String(unsigned int value, unsigned char base)
+{
+    init();
+    formatInteger(*this, value, false, base);
+}
+
+String::String(long value, unsigned char base)
+{
+    init();
+    formatInteger(*this, value < 0 ? -(long long)value : value, value < 0, base);
+}
+
+String::String(unsigned long value, unsigned char base)
+{
+    init();
+    formatInteger(*this, value, false, base);
+}
+
+String::String(float value, unsigned char decimals)
+    : String((double)value, decimals) {}
+
+String::String(double value, unsigned char decimals)
+{
+    init();
+    char text[64];
+    snprintf(text, sizeof(text), "%.*f", (int)decimals, value);
+    copy(text, strlen(text));
+}
+
+String::~String()
+{
+    release();
+}
+
+String &String::operator=(const String &rhs)
+{
+    if (this != &rhs)
+    {
+        copy(rhs.c_str(), rhs.len);
+    }
+    return *this;
+}
+
+String &String::operator=(String &&rhs)
+{
+    if (this != &rhs)
+    {
+        release();
+        buffer = rhs.buffer;
+        capacity = rhs.capacity;
+        len = rhs.len;
+        rhs.init();
+    }
+    return *this;
+}
+
+String &String::operator=(const char *rhs)
+{
+    return rhs ? copy(rhs, strlen(rhs)) : copy("", 0);
+}
+
+String &String::operator+=(const String &rhs)
+{
+    concat(rhs.c_str(), rhs.len);
+    return *this;
+}
+
+String &String::operator+=(const char *rhs)
+{
+    if (rhs)
+    {
+        concat(rhs, strlen(rhs));
+    }
+    return *this;
+}
+
+String &String::operator+=(char rhs)
+{
+    concat(&rhs, 1);
+    return *this;
+}
+
+bool String::operator==(const String &rhs) const
+{
+    return len == rhs.len && strcmp(c_str(), rhs.c_str()) == 0;
+}
+
+bool String::operator==(const char *rhs) const
+{
+    return strcmp(c_str(), rhs ? rhs : "") == 0;
+}
+
+int String::indexOf(char c) const
+{
+    const char *found = strchr(c_str(), c);
+    return found ? (int)(found - c_str()) : -1;
+}
+
+int String::indexOf(const char *str) const
+{
+    const char *found = strstr(c_str(), str);
+    return found ? (int)(found - c_str()) : -1;
+}
+
+String String::substring(unsigned int from) const
+{
+    return substring(from, length());
+}
+
+String String::substring(unsigned int from, unsigned int to) const
+{
+    if (from > to)
+    {
+        unsigned int swap = from;
+        from = to;
+        to = swap;
+    }
+    String result;
+    if (from >= len)
+        return result;
+    if (to > len)
+        to = len;
+    result.copy(buffer + from, to - from);
+    return result;
+}
+
+void String::trim()
+{
+    if (len == 0)
+        return;
+    unsigned int first = 0;
+    while (first < len && isspace((unsigned char)buffer[first]))
+    {
+        first++;
+    }
+    unsigned int last = len;
+    while (last > first && isspace((unsigned char)buffer[last - 1]))
+    {
+        last--;
+    }
+    len = last - first;
+    memmove(buffer, buffer + first, len);
+    buffer[len] = 0;
+}
+
+void String::toUpperCase()
+{
+    for (unsigned int i = 0; i < len; i++)
+    {
+        buffer[i] = (char)toupper((unsigned char)buffer[i]);
+    }
+}
+
+bool String::startsWith(const char *prefix) const
+{
+    return strncmp(c_str(), prefix, strlen(prefix)) == 0;
+}
+
+long String::toInt() const
+{
+    return strtol(c_str(), nullptr, 10);
+}
+
+float String::toFloat() const
+{
+    return strtof(c_str(), nullptr);
+}
+
+String operator+(const String &lhs, const String &rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+String operator+(const String &lhs, const char *rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+String operator+(const char *lhs, const String &rhs)
+{
+    String result(lhs);
+    result += rhs;
+    return result;
+}
@@ -0,0 +1,69 @@
+#ifndef SIM_WSTRING_H
+#define SIM_WSTRING_H
+
+#include <stddef.h>
+
+// Arduino String for the host. Like the real one it keeps its text in a
+// heap buffer grown with realloc on every concatenation that does not fit,
+// and every allocation is accounted to the simulated heap (SimHal heap
+// statistics), so host runs show what the firmware would do to an MCU heap.
+class String
+{
+private:
+    char *buffer;
+    unsigned int capacity;
+    unsigned int len;
+
+    void init();
+    bool reserve(unsigned int size);
+    String &copy(const char *str, unsigned int length);
+    bool concat(const char *str, unsigned int length);
+    void release();
+
+public:
+    String(const char *str = "");
+    String(const String &other);
+    String(String &&other);
+    explicit String(char c);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(float value, unsigned char decimals = 2);
+    explicit String(double value, unsigned char decimals = 2);
+    ~String();
+
+    String &operator=(const String &rhs);
+    String &operator=(String &&rhs);
+    String &operator=(const char *rhs);
+
+    const char *c_str() const { return buffer ? buffer : ""; }
+    unsigned int length() const { return len; }
+    char charAt(unsigned int index) const { return index < len ? buffer[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+
+    String &operator+=(const String &rhs);
+    String &operator+=(const char *rhs);
+    String &operator+=(char rhs);
+
+    bool operator==(const String &rhs) const;
+    bool operator==(const char *rhs) const;
+    bool operator!=(const String &rhs) const { return !(*this == rhs); }
+    bool operator!=(const char *rhs) const { return !(*this == rhs); }
+
+    int indexOf(char c) const;
+    int indexOf(const char *str) const;
+    String substring(unsigned int from) const;
+    String substring(unsigned int from, unsigned int to) const;
+    void trim();
+    void toUpperCase();
+    bool startsWith(const char *prefix) const;
+    long toInt() const;
+    float toFloat() const;
+};
+
+String operator+(const String &lhs, const String &rhs);
+String operator+(const String &lhs, const char *rhs);
+String operator+(const char *lhs, const String &rhs);
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef SIM_WIFININA_H
+#define SIM_WIFININA_H
+
+#include <Arduino.h>
+
+#define WL_IDLE_STATUS 0
+#define WL_CONNECTED 3
+#define WL_CONNECT_FAILED 4
+#define WL_DISCONNECTED 6
+
+// Link state is controlled by the simulation through setStatus().
+class SimWiFiClass
+{
+private:
+    int linkStatus = WL_DISCONNECTED;
+
+public:
+    int begin(const char *ssid, const char *pass)
+    {
+        (void)ssid;
+        (void)pass;
+        return linkStatus;
+    }
+    int status() { return linkStatus; }
+    void setStatus(int status) { linkStatus = status; }
+    String localIP() { return String("127.0.0.1"); }
+};
+
+class WiFiClient : public Print
+{
+public:
+    size_t bytesWritten = 0;
+
+    int connect(const char *host, uint16_t port)
+    {
+        (void)host;
+        (void)port;
+        return 1;
+    }
+    bool connected() { return true; }
+    void stop() {}
+    size_t write(uint8_t c) override
+    {
+        (void)c;
+        bytesWritten++;
+        return 1;
+    }
+    size_t write(const uint8_t *buffer, size_t size) override
+    {
+        (void)buffer;
+        bytesWritten += size;
+        return size;
+    }
+    using Print::write;
+};
+
+inline SimWiFiClass WiFi;
+
+#endif
@@ -0,0 +1,2228 @@
+// Host micro-benchmarks for firmware hot paths. Each benchmark is selected by
+// name on the command line; with no arguments every benchmark runs.
+
+#include <Arduino.h>
+#include "SimHal.h"
+#include "bird_tracker.h"
+#include "median_filter.h"
+#include "bird_detection.h"
+#include "audio_deterrent.h"
+#include "audio_timer.h"
+#include "visual_deterrent.h"
+#include "strobe_sequencer.h"
+#include "strobe_timer.h"
+#include "led_thermal.h"
+#include "brightness_lut.h"
+#include "deterrent_targeting.h"
+#include "threat_assessment.h"
+#include "system_state_machine.h"
+#include "config.h"
+#include "perf_monitor.h"
+#include "telemetry_protocol.h"
+#include "track_events.h"
+#include <ArduinoJson.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_CYCLE_COUNTER 1
+#endif
+
+namespace
+{
+    typedef std::chrono::steady_clock BenchClock;
+
+    double elapsedNs(BenchClock::time_point start, BenchClock::time_point end)
+    {
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    uint64_t readCycles()
+    {
+#ifdef BENCH_HAS_CYCLE_COUNTER
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    // ==================== TRACKER ====================
+
+    double runTrackerScene(int capacity, int birdCount, int updates)
+    {
+        std::vector<BirdObject> pool(capacity);
+        BirdTracker tracker(pool.data(), capacity);
+
+        const int sensorCount = 3;
+        const float azimuths[sensorCount] = {0.0, 270.0, 90.0};
+        TrackMeasurement measurements[sensorCount];
+
+        double totalNs = 0;
+        for (int step = 0; step < updates; step++)
+        {
+            unsigned long now = 1000 + step * 20UL;
+            int sensor = step % sensorCount;
+
+            // Each sensor sees birds spread in range, all closing at 5 m/s
+            for (int b = 0; b < birdCount && b < sensorCount; b++)
+            {
+                measurements[b].sensorIndex = (sensor + b) % sensorCount;
+                measurements[b].azimuth = azimuths[measurements[b].sensorIndex];
+                measurements[b].range = 400.0 - (step % 60) * 5.0 - b * 40.0;
+                measurements[b].timestamp = now;
+            }
+            int measurementCount = min(birdCount, sensorCount);
+
+            BenchClock::time_point start = BenchClock::now();
+            tracker.update(measurements, measurementCount, now);
+            BenchClock::time_point end = BenchClock::now();
+            totalNs += elapsedNs(start, end);
+        }
+        return totalNs / updates;
+    }
+
+    double runTrackerSaturated(int capacity, int updates)
+    {
+        std::vector<BirdObject> pool(capacity);
+        BirdTracker tracker(pool.data(), capacity);
+        TrackMeasurement measurement;
+
+        // One track per slot at distinct ranges, all in the same azimuth gate,
+        // so every measurement is tested against the whole pool
+        measurement.azimuth = 0.0;
+        for (int i = 0; i < capacity; i++)
+        {
+            measurement.range = 20.0 + i * 6.0;
+            measurement.sensorIndex = i % 32;
+            measurement.timestamp = 1000;
+            tracker.update(&measurement, 1, 1000);
+        }
+
+        double totalNs = 0;
+        for (int step = 0; step < updates; step++)
+        {
+            unsigned long now = 1000 + step;
+            int slot = step % capacity;
+            measurement.range = 20.0 + slot * 6.0;
+            measurement.sensorIndex = slot % 32;
+            measurement.timestamp = now;
+
+            BenchClock::time_point start = BenchClock::now();
+            tracker.update(&measurement, 1, now);
+            BenchClock::time_point end = BenchClock::now();
+            totalNs += elapsedNs(start, end);
+        }
+        return totalNs / updates;
+    }
+
+    // Milliseconds after its last hit until a confirmed track is dropped,
+    // calling removeStaleTracks() every periodMs
+    long runTrackerStaleDrop(unsigned long periodMs)
+    {
+        BirdObject pool[4];
+        BirdTracker tracker(pool, 4);
+        TrackMeasurement measurement;
+        measurement.range = 200.0;
+        measurement.azimuth = 0.0;
+        measurement.sensorIndex = 0;
+
+        unsigned long now = 1000;
+        for (int hit = 0; hit < TRACKER_CONFIRM_HITS; hit++)
+        {
+            now += 20;
+            measurement.timestamp = now;
+            tracker.update(&measurement, 1, now);
+        }
+        unsigned long lastHit = now;
+
+        while (tracker.getTrackCount() > 0 && now - lastHit < 10 * TRACKER_STALE_TIMEOUT_MS)
+        {
+            now += periodMs;
+            tracker.removeStaleTracks(now);
+        }
+        return (long)(now - lastHit);
+    }
+
+    bool benchTracker()
+    {
+        const int capacities[] = {10, 16, 32, 64};
+        const int updates = 200000;
+
+        printf("== tracker: ns per BirdTracker::update() ==\n");
+        printf("%10s %14s %14s\n", "capacity", "3 birds", "pool full");
+        for (size_t i = 0; i < sizeof(capacities) / sizeof(capacities[0]); i++)
+        {
+            double scene = runTrackerScene(capacities[i], 3, updates);
+            double saturated = runTrackerSaturated(capacities[i], updates);
+            printf("%10d %14.1f %14.1f\n", capacities[i], scene, saturated);
+        }
+
+        // Confidence decay follows elapsed time, not how often it is checked
+        const unsigned long periods[] = {5, 20, 100};
+        long reference = runTrackerStaleDrop(periods[0]);
+        bool ok = true;
+        printf("stale track dropped after:");
+        for (size_t i = 0; i < sizeof(periods) / sizeof(periods[0]); i++)
+        {
+            long dropMs = runTrackerStaleDrop(periods[i]);
+            ok = ok && labs(dropMs - reference) <= (long)periods[i];
+            printf(" %ld ms (every %lu ms)", dropMs, periods[i]);
+        }
+        printf(" %s\n", ok ? "PASS" : "FAIL");
+        return ok;
+    }
+
+    // ==================== MEDIAN FILTER ====================
+
+    // The per-sample copy-and-bubble-sort filterNoise() used before
+    template <int WindowSize>
+    struct BubbleSortMedian
+    {
+        float history[WindowSize];
+        int index = 0;
+
+        BubbleSortMedian()
+        {
+            for (int i = 0; i < WindowSize; i++)
+            {
+                history[i] = 9999.0;
+            }
+        }
+
+        float push(float value)
+        {
+            history[index] = value;
+            index = (index + 1) % WindowSize;
+
+            float sortedDistances[WindowSize];
+            for (int i = 0; i < WindowSize; i++)
+            {
+                sortedDistances[i] = history[(index + i) % WindowSize];
+            }
+            for (int i = 0; i < WindowSize - 1; i++)
+            {
+                for (int j = 0; j < WindowSize - i - 1; j++)
+                {
+                    if (sortedDistances[j] > sortedDistances[j + 1])
+                    {
+                        float temp = sortedDistances[j];
+                        sortedDistances[j] = sortedDistances[j + 1];
+                        sortedDistances[j + 1] = temp;
+                    }
+                }
+            }
+            return sortedDistances[WindowSize / 2];
+        }
+    };
+
+    template <int WindowSize>
+    void benchMedianWindow(const std::vector<float> &samples)
+    {
+        BubbleSortMedian<WindowSize> bubble;
+        StreamingMedian<WindowSize> streaming;
+        volatile float sink = 0;
+        double count = samples.size();
+
+        BenchClock::time_point start = BenchClock::now();
+        uint64_t cycles = readCycles();
+        for (size_t i = 0; i < samples.size(); i++)
+        {
+            sink = bubble.push(samples[i]);
+        }
+        double bubbleCycles = (readCycles() - cycles) / count;
+        double bubbleNs = elapsedNs(start, BenchClock::now()) / count;
+
+        start = BenchClock::now();
+        cycles = readCycles();
+        for (size_t i = 0; i < samples.size(); i++)
+        {
+            streaming.push(samples[i]);
+            sink = streaming.median();
+        }
+        double streamingCycles = (readCycles() - cycles) / count;
+        double streamingNs = elapsedNs(start, BenchClock::now()) / count;
+        (void)sink;
+
+        printf("%8d %12.1f %12.1f %12.1f %12.1f %8.1fx\n", WindowSize, bubbleCycles, bubbleNs,
+               streamingCycles, streamingNs, streamingNs > 0 ? bubbleNs / streamingNs : 0.0);
+    }
+
+    bool benchMedian()
+    {
+        // Slowly closing target with sensor noise and rain-like dropouts
+        std::vector<float> samples(500000);
+        randomSeed(42);
+        for (size_t i = 0; i < samples.size(); i++)
+        {
+            float truth = 300.0 - (i % 1000) * 0.25;
+            samples[i] = random(100) < 10 ? (float)random(2, 400) : truth + random(-3, 4);
+        }
+
+        printf("== median: cost per sample, bubble sort vs streaming ==\n");
+        printf("%8s %12s %12s %12s %12s %9s\n", "window", "bubble cyc", "bubble ns", "stream cyc", "stream ns", "speedup");
+        benchMedianWindow<5>(samples);
+        benchMedianWindow<9>(samples);
+        benchMedianWindow<15>(samples);
+        benchMedianWindow<21>(samples);
+        benchMedianWindow<31>(samples);
+        return true;
+    }
+
+    // ==================== SENSOR RING ====================
+
+    unsigned long ringEcho(uint64_t timeUs)
+    {
+        (void)timeUs;
+        return (unsigned long)(200.0 * 58.3); // Target at 2 m on every sensor
+    }
+
+    double measureRingRefreshHz(int sensorCount, float beamWidth, int *groupCount, float *pingRate = nullptr,
+                                float temperatureC = 20.0)
+    {
+        const double simSeconds = 10.0;
+        SensorMount mounts[MAX_SENSORS];
+
+        SimHal::reset();
+        for (int i = 0; i < sensorCount; i++)
+        {
+            mounts[i].trigPin = i;
+            mounts[i].echoPin = 20 + i;
+            mounts[i].azimuth = 360.0 * i / sensorCount;
+            mounts[i].beamWidth = beamWidth;
+            mounts[i].rangeOffset = 0.0;
+            SimHal::attachEchoScript(mounts[i].trigPin, mounts[i].echoPin, ringEcho);
+        }
+
+        BirdDetection detection;
+        detection.setAmbientTemperature(temperatureC);
+        detection.begin(mounts, sensorCount);
+        *groupCount = detection.getFiringGroupCount();
+
+        unsigned long startRefreshes = detection.getRingRefreshCount();
+        uint64_t end = SimHal::nowMicros() + (uint64_t)(simSeconds * 1000000);
+        while (SimHal::nowMicros() < end)
+        {
+            detection.update();
+            delayMicroseconds(250);
+        }
+        if (pingRate != nullptr)
+        {
+            *pingRate = detection.getPingRate();
+        }
+        return (detection.getRingRefreshCount() - startRefreshes) / simSeconds;
+    }
+
+    bool benchRing()
+    {
+        const int counts[] = {3, 4, 6, 8, 10, 12};
+
+        printf("== ring: full-ring refresh rate vs sensor count (target at 2 m) ==\n");
+        printf("%8s %10s %14s %14s\n", "sensors", "groups", "grouped Hz", "sequential Hz");
+        for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+        {
+            int groups = 0;
+            int sequentialGroups = 0;
+            double grouped = measureRingRefreshHz(counts[i], SENSOR_DEFAULT_BEAM_WIDTH_DEG, &groups);
+            // A 360 degree "beam" puts every sensor in conflict: one ping at a time
+            double sequential = measureRingRefreshHz(counts[i], 360.0, &sequentialGroups);
+            printf("%8d %10d %14.1f %14.1f\n", counts[i], groups, grouped, sequential);
+        }
+        return true;
+    }
+
+    bool benchSlots()
+    {
+        const int counts[] = {3, 8, 12};
+        const float temperatures[] = {-10.0, 20.0, 45.0};
+
+        printf("== slots: TDMA ranging throughput vs temperature ==\n");
+        printf("%8s %8s %10s %10s %10s %12s %12s\n", "sensors", "temp C", "c (m/s)", "slot us", "frame us",
+               "max ping/s", "achieved");
+        for (size_t t = 0; t < sizeof(temperatures) / sizeof(temperatures[0]); t++)
+        {
+            for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+            {
+                SensorMount mounts[MAX_SENSORS];
+                for (int m = 0; m < counts[i]; m++)
+                {
+                    mounts[m].azimuth = 360.0 * m / counts[i];
+                    mounts[m].beamWidth = SENSOR_DEFAULT_BEAM_WIDTH_DEG;
+                }
+                SensorArrayScheduler scheduler;
+                scheduler.build(mounts, counts[i]);
+                scheduler.configureTiming(RANGING_MAX_RANGE_CM, temperatures[t]);
+
+                int groups = 0;
+                float achieved = 0;
+                measureRingRefreshHz(counts[i], SENSOR_DEFAULT_BEAM_WIDTH_DEG, &groups, &achieved, temperatures[t]);
+
+                printf("%8d %8.0f %10.1f %10lu %10lu %12.1f %12.1f\n", counts[i], temperatures[t],
+                       scheduler.getSpeedOfSound(), scheduler.getSlotUs(), scheduler.getFrameUs(),
+                       scheduler.getTheoreticalPingRate(), achieved);
+            }
+        }
+        return true;
+    }
+
+    // ==================== UPDATE LATENCY ====================
+
+#define BENCH_LATENCY_SENSORS 3
+#define BENCH_LATENCY_SECONDS 20
+#define BENCH_LATENCY_LOOP_US 1000     // Other loop() work between update() calls
+#define BENCH_LEGACY_PULSE_TIMEOUT_US 30000
+
+    // Bird closing from 3.5 m to 0.5 m on every sensor over 10 s and back,
+    // with one ping in five lost (rain, soft plumage)
+    unsigned long latencyEcho(uint64_t timeUs)
+    {
+        static uint32_t pings = 0;
+        if (++pings % 5 == 0)
+            return 0;
+        double cycle = fmod(timeUs / 1000000.0, 20.0);
+        double distance = cycle < 10.0 ? 350.0 - cycle * 30.0 : 50.0 + (cycle - 10.0) * 30.0;
+        return (unsigned long)(distance * 58.3);
+    }
+
+    void configureLatencyScenario(SensorMount *mounts)
+    {
+        SimHal::reset();
+        for (int i = 0; i < BENCH_LATENCY_SENSORS; i++)
+        {
+            mounts[i].trigPin = i;
+            mounts[i].echoPin = 20 + i;
+            mounts[i].azimuth = 360.0 * i / BENCH_LATENCY_SENSORS;
+            mounts[i].beamWidth = SENSOR_DEFAULT_BEAM_WIDTH_DEG;
+            mounts[i].rangeOffset = 0.0;
+            SimHal::attachEchoScript(mounts[i].trigPin, mounts[i].echoPin, latencyEcho);
+        }
+    }
+
+    // The blocking sweep update() ran before the ranging engine: each sensor
+    // that is due is pinged and pulseIn() waits for its echo or the timeout
+    void legacyBlockingUpdate(const SensorMount *mounts, unsigned long *lastReading)
+    {
+        unsigned long currentTime = millis();
+        for (int i = 0; i < BENCH_LATENCY_SENSORS; i++)
+        {
+            if (currentTime - lastReading[i] <= (unsigned long)(50 + i * 20))
+                continue;
+
+            digitalWrite(mounts[i].trigPin, LOW);
+            delayMicroseconds(2);
+            digitalWrite(mounts[i].trigPin, HIGH);
+            delayMicroseconds(10);
+            digitalWrite(mounts[i].trigPin, LOW);
+            unsigned long duration = pulseIn(mounts[i].echoPin, HIGH, BENCH_LEGACY_PULSE_TIMEOUT_US);
+            if (duration > 0)
+            {
+                lastReading[i] = currentTime;
+            }
+        }
+    }
+
+    // Latency of each update() call: virtual time spent waiting on pins plus
+    // the host time the call itself took
+    std::vector<double> measureUpdateLatency(bool blocking)
+    {
+        SensorMount mounts[BENCH_LATENCY_SENSORS];
+        configureLatencyScenario(mounts);
+        BirdDetection detection;
+        unsigned long lastReading[BENCH_LATENCY_SENSORS] = {};
+        if (!blocking)
+        {
+            detection.begin(mounts, BENCH_LATENCY_SENSORS);
+        }
+
+        std::vector<double> latencyUs;
+        uint64_t end = SimHal::nowMicros() + (uint64_t)BENCH_LATENCY_SECONDS * 1000000;
+        while (SimHal::nowMicros() < end)
+        {
+            uint64_t virtualStart = SimHal::nowMicros();
+            BenchClock::time_point start = BenchClock::now();
+            if (blocking)
+            {
+                legacyBlockingUpdate(mounts, lastReading);
+            }
+            else
+            {
+                detection.update();
+            }
+            double hostUs = elapsedNs(start, BenchClock::now()) / 1000.0;
+            latencyUs.push_back((SimHal::nowMicros() - virtualStart) + hostUs);
+            delayMicroseconds(BENCH_LATENCY_LOOP_US);
+        }
+        std::sort(latencyUs.begin(), latencyUs.end());
+        return latencyUs;
+    }
+
+    bool benchLatency()
+    {
+        printf("== latency: BirdDetection::update() per call, %d sensors, same echo script ==\n",
+               BENCH_LATENCY_SENSORS);
+        printf("%-18s %10s %12s %12s %12s\n", "path", "calls", "mean us", "p99 us", "worst us");
+
+        const char *names[2] = {"blocking pulseIn", "async engine"};
+        double worst[2];
+        for (int p = 0; p < 2; p++)
+        {
+            std::vector<double> latencyUs = measureUpdateLatency(p == 0);
+            double total = 0;
+            for (size_t i = 0; i < latencyUs.size(); i++)
+            {
+                total += latencyUs[i];
+            }
+            worst[p] = latencyUs.back();
+            printf("%-18s %10zu %12.1f %12.1f %12.1f\n", names[p], latencyUs.size(), total / latencyUs.size(),
+                   latencyUs[(size_t)(latencyUs.size() * 0.99)], worst[p]);
+        }
+
+        // The async path never waits on an echo: its worst call stays inside
+        // DETECTION_UPDATE_GAP_LIMIT_US, which one lost echo blew through before
+        bool passed = worst[1] < DETECTION_UPDATE_GAP_LIMIT_US && worst[1] < worst[0] / 10;
+        printf("latency: %s\n", passed ? "PASS" : "FAIL");
+        return passed;
+    }
+
+    // ==================== AUDIO ====================
+
+    // Frequency of the strongest DFT bin in a block of 8-bit PWM samples
+    double spectralPeakHz(const uint8_t *samples, int count, double sampleRate)
+    {
+        double bestPower = -1;
+        int bestBin = 0;
+
+        for (int bin = 1; bin < count / 2; bin++)
+        {
+            // Goertzel recurrence for one bin
+            double coeff = 2.0 * cos(2.0 * M_PI * bin / count);
+            double s1 = 0, s2 = 0;
+            for (int n = 0; n < count; n++)
+            {
+                double s0 = (samples[n] - DDS_OUTPUT_MIDPOINT) + coeff * s1 - s2;
+                s2 = s1;
+                s1 = s0;
+            }
+            double power = s1 * s1 + s2 * s2 - coeff * s1 * s2;
+            if (power > bestPower)
+            {
+                bestPower = power;
+                bestBin = bin;
+            }
+        }
+        return bestBin * sampleRate / count;
+    }
+
+    bool verifyPatternSpectra(AudioDeterrent &audio)
+    {
+        const int window = 4096;
+        double rate = audio.getSampleRate();
+        double binHz = rate / window;
+        bool allPassed = true;
+
+        printf("%-18s %4s %10s %10s %10s %8s\n", "pattern", "comp", "expect Hz", "peak Hz", "tol Hz", "result");
+        for (int p = 1; p < MAX_AUDIO_PATTERNS; p++)
+        {
+            const AudioPatternConfig *config = audio.getPatternConfig((AudioPattern)p);
+            DdsSynthesizer synth;
+            synth.begin(audio.getSampleRate());
+            audio.compilePattern((AudioPattern)p, *synth.editProgram());
+            synth.commitProgram();
+
+            // One pass through the cycle; each component is checked over a
+            // window centred on its midpoint, where chirps are at f(0.5)
+            for (int i = 0; i < config->frequencyCount; i++)
+            {
+                const FrequencyComponent &component = config->frequencies[i];
+                std::vector<uint8_t> samples(max(synth.millisToSamples(component.duration), (uint32_t)1));
+                synth.render(samples.data(), samples.size());
+
+                int count = min((int)samples.size(), window);
+                int offset = (samples.size() - count) / 2;
+                double peak = spectralPeakHz(samples.data() + offset, count, rate);
+                double expected = AudioDeterrent::componentFrequencyAt(component, 0.5);
+
+                // A chirp moves during the window; allow half that movement
+                double spread = (double)count / samples.size() / 2;
+                double sweep = fabs(AudioDeterrent::componentFrequencyAt(component, 0.5 + spread) -
+                                    AudioDeterrent::componentFrequencyAt(component, 0.5 - spread));
+                double tolerance = 1.5 * binHz + sweep / 2;
+                bool passed = fabs(peak - expected) <= tolerance;
+                allPassed = allPassed && passed;
+
+                printf("%-18s %4d %10.0f %10.1f %10.1f %8s\n", config->name, i, expected, peak, tolerance,
+                       passed ? "PASS" : "FAIL");
+            }
+        }
+        return allPassed;
+    }
+
+    double ddsCyclesPerSample(DdsSynthesizer &synth, int samples, double *nsPerSample)
+    {
+        volatile uint8_t sink = 0;
+        BenchClock::time_point start = BenchClock::now();
+        uint64_t cycles = readCycles();
+        for (int i = 0; i < samples; i++)
+        {
+            sink = synth.nextSample();
+        }
+        double perSample = (readCycles() - cycles) / (double)samples;
+        *nsPerSample = elapsedNs(start, BenchClock::now()) / samples;
+        (void)sink;
+        return perSample;
+    }
+
+    void benchSynthesisCost(AudioDeterrent &audio)
+    {
+        const int samples = 4000000;
+        volatile uint8_t sink = 0;
+
+        // The float sin() path synthesizeFrequency() used per sample
+        float frequency = 20000.0;
+        float amplitude = 0.5;
+        BenchClock::time_point start = BenchClock::now();
+        uint64_t cycles = readCycles();
+        for (int i = 0; i < samples; i++)
+        {
+            unsigned long t = i * 16;
+            float phase = (2.0 * PI * frequency * (t / 1000000.0));
+            float sample = amplitude * sin(phase);
+            sink = (uint8_t)constrain((int)((sample + 1.0) * 127.5), 0, 255);
+        }
+        double sinCycles = (readCycles() - cycles) / (double)samples;
+        double sinNs = elapsedNs(start, BenchClock::now()) / samples;
+        (void)sink;
+
+        printf("%-18s %12s %12s\n", "per sample", "cycles", "ns");
+        printf("%-18s %12.1f %12.2f\n", "float sin()", sinCycles, sinNs);
+
+        // Steady single tone: no sweep, flat envelope
+        DdsSynthesizer tone;
+        tone.begin(audio.getSampleRate());
+        DdsProgram *program = tone.editProgram();
+        program->segmentCount = 0;
+        tone.appendSegment(*program, 20000.0, 20000.0, false, 0.5, 0.5, tone.millisToSamples(1000));
+        program->repeatCount = DDS_REPEAT_FOREVER;
+        program->tailSamples = 0;
+        tone.commitProgram();
+
+        double ns = 0;
+        double toneCycles = ddsCyclesPerSample(tone, samples, &ns);
+        printf("%-18s %12.1f %12.2f\n", "DDS single tone", toneCycles, ns);
+
+        double worstNs = ns;
+        for (int p = 1; p < MAX_AUDIO_PATTERNS; p++)
+        {
+            DdsSynthesizer synth;
+            synth.begin(audio.getSampleRate());
+            DdsProgram *patternProgram = synth.editProgram();
+            audio.compilePattern((AudioPattern)p, *patternProgram);
+            patternProgram->repeatCount = DDS_REPEAT_FOREVER;
+            patternProgram->tailSamples = 0;
+            synth.commitProgram();
+
+            double patternCycles = ddsCyclesPerSample(synth, samples, &ns);
+            worstNs = max(worstNs, ns);
+            printf("%-18s %12.1f %12.2f\n", audio.getPatternConfig((AudioPattern)p)->name, patternCycles, ns);
+        }
+        printf("DDS budget at %lu Hz: %.2f%% of one core (worst pattern)\n", audio.getSampleRate(),
+               worstNs * audio.getSampleRate() / 1e7);
+    }
+
+    double measureOutputRate(AudioDeterrent &audio, AudioPattern pattern)
+    {
+        const unsigned long windowMs = 100;
+
+        SimHal::clearAnalogWrites();
+        audio.setPattern(pattern);
+        audio.setVolume(0.5);
+        for (int i = 0; i < 10; i++)
+        {
+            audio.update();
+            delay(1);
+        }
+
+        SimHal::clearAnalogWrites();
+        delay(windowMs);
+        size_t writes = 0;
+        for (size_t i = 0; i < SimHal::getAnalogWrites().size(); i++)
+        {
+            writes += SimHal::getAnalogWrites()[i].pin == AUDIO_PWM_PIN;
+        }
+        audio.stop();
+        return writes * 1000.0 / windowMs;
+    }
+
+    bool benchAudio()
+    {
+        SimHal::reset();
+        SimHal::setRecordAnalogWrites(false);
+        AudioDeterrent audio;
+        audio.begin(AUDIO_PWM_PIN, AUDIO_ENABLE_PIN);
+
+        printf("== audio: spectral peak of each rendered pattern segment ==\n");
+        bool passed = verifyPatternSpectra(audio);
+
+        printf("== audio: synthesis cost ==\n");
+        benchSynthesisCost(audio);
+
+        SimHal::setRecordAnalogWrites(true);
+        printf("== audio: timer-driven output rate (virtual time) ==\n");
+        printf("%-18s %12.0f samples/s\n", "crow distress", measureOutputRate(audio, CROW_DISTRESS));
+        printf("%-18s %12.0f samples/s\n", "ultrasonic sweep", measureOutputRate(audio, ULTRASONIC_SWEEP));
+        SimHal::setRecordAnalogWrites(false);
+
+        // The host records sample values; on the board they leave as PWM duty
+        printf("%-18s %12d Hz, %.1fx the highest tone\n", "target PWM carrier", AUDIO_PWM_CARRIER_HZ,
+               (double)AUDIO_PWM_CARRIER_HZ / ULTRASONIC_MAX_FREQ_HZ);
+
+        return passed;
+    }
+
+    // ==================== FOOTPRINT ====================
+
+    // The RAM-resident pattern banks built by initializeAudioPatterns() and
+    // initializePatterns() before the tables became constexpr
+    struct LegacyAudioPatternConfig
+    {
+        AudioPattern patternId;
+        String name;
+        FrequencyComponent frequencies[MAX_FREQUENCY_SWEEP];
+        int frequencyCount;
+        int repeatCount;
+        int pauseDuration;
+        float baseVolume;
+        bool isUltrasonic;
+    };
+
+    struct LegacyStrobeConfig
+    {
+        int onDuration;
+        int offDuration;
+        int brightness;
+        int repetitions;
+        String name;
+    };
+
+    struct LegacyPatternBanks
+    {
+        LegacyAudioPatternConfig audio[MAX_AUDIO_PATTERNS];
+        LegacyStrobeConfig strobe[5];
+
+        void initialize()
+        {
+            audio[0] = {AUDIO_OFF, "Off", {}, 0, 0, 0, 0.0, false};
+            audio[1] = {CROW_DISTRESS, "Crow Distress", {{800, 0.8, 0, 500, 0, SWEEP_NONE}, {1200, 0.6, 0, 300, 0, SWEEP_NONE}, {600, 0.9, 0, 400, 0, SWEEP_NONE}}, 3, 3, 1000, 0.7, false};
+            audio[2] = {EAGLE_DISTRESS, "Eagle Distress", {{1800, 0.9, 0, 800, 0, SWEEP_NONE}, {1200, 0.7, 0, 600, 0, SWEEP_NONE}, {2200, 0.8, 0, 500, 0, SWEEP_NONE}}, 3, 2, 2000, 0.8, false};
+            audio[3] = {HAWK_SCREECH, "Hawk Screech", {{2500, 1.0, 0, 1200, 0, SWEEP_NONE}, {1800, 0.6, 0, 800, 0, SWEEP_NONE}}, 2, 4, 1500, 0.75, false};
+            audio[4] = {GENERAL_ALARM, "General Alarm", {{1000, 0.8, 0, 200, 0, SWEEP_NONE}, {1500, 0.8, 0, 200, 0, SWEEP_NONE}, {2000, 0.8, 0, 200, 0, SWEEP_NONE}}, 3, 10, 500, 0.6, false};
+            audio[5] = {ULTRASONIC_SWEEP, "Ultrasonic Sweep", {{17000, 0.5, 0, 1000, 0, SWEEP_NONE}, {20000, 0.5, 0, 1000, 0, SWEEP_NONE}, {24000, 0.5, 0, 1000, 0, SWEEP_NONE}}, 3, 5, 200, 0.4, true};
+            audio[6] = {PREDATOR_GROWL, "Predator Growl", {{150, 0.9, 0, 2000, 0, SWEEP_NONE}, {80, 0.7, 0, 1500, 0, SWEEP_NONE}, {200, 0.8, 0, 1000, 0, SWEEP_NONE}}, 3, 2, 3000, 0.8, false};
+            audio[7] = {EMERGENCY_SIREN, "Emergency Siren", {{800, 1.0, 0, 300, 0, SWEEP_NONE}, {1200, 1.0, 0, 300, 0, SWEEP_NONE}}, 2, 999, 0, 0.9, false};
+
+            strobe[0] = {0, 1000, 0, 1, "Off"};
+            strobe[1] = {500, 1500, 128, 999, "Slow Blink"};
+            strobe[2] = {200, 200, 255, 999, "Fast Blink"};
+            strobe[3] = {100, 100, 255, 2, "Double Flash"};
+            strobe[4] = {0, 0, 255, 999, "Random"};
+        }
+
+        size_t heapBytes()
+        {
+            size_t bytes = 0;
+            for (int i = 0; i < MAX_AUDIO_PATTERNS; i++)
+            {
+                bytes += audio[i].name.length() + 1;
+            }
+            for (int i = 0; i < 5; i++)
+            {
+                bytes += strobe[i].name.length() + 1;
+            }
+            return bytes;
+        }
+    };
+
+    bool benchFootprint()
+    {
+        // Startup banners printed by the old initialisers
+        const char *removedBanners[] = {"Initializing audio patterns...", "Audio patterns initialized successfully",
+                                        "Strobe patterns initialized"};
+        size_t bannerBytes = 0;
+        for (size_t i = 0; i < sizeof(removedBanners) / sizeof(removedBanners[0]); i++)
+        {
+            bannerBytes += strlen(removedBanners[i]) + 2;
+        }
+
+        const int rounds = 20000;
+        std::vector<LegacyPatternBanks> legacy(1);
+        BenchClock::time_point start = BenchClock::now();
+        for (int i = 0; i < rounds; i++)
+        {
+            legacy[0].initialize();
+        }
+        double initNs = elapsedNs(start, BenchClock::now()) / rounds;
+
+        size_t legacyRam = sizeof(LegacyPatternBanks) + legacy[0].heapBytes();
+        size_t flashBytes = MAX_AUDIO_PATTERNS * sizeof(AudioPatternConfig) + MAX_STROBE_PATTERNS * sizeof(StrobeConfig);
+
+        printf("== footprint: pattern banks (host build, %d-bit pointers) ==\n", (int)(sizeof(void *) * 8));
+        printf("%-32s %10zu bytes\n", "runtime banks, SRAM", legacyRam);
+        printf("%-32s %10zu bytes\n", "  of which String heap", legacy[0].heapBytes());
+        printf("%-32s %10d bytes\n", "constexpr banks, SRAM", 0);
+        printf("%-32s %10zu bytes\n", "constexpr banks, flash", flashBytes);
+        printf("%-32s %10zu bytes\n", "sizeof(AudioDeterrent)", sizeof(AudioDeterrent));
+        printf("%-32s %10zu bytes\n", "sizeof(VisualDeterrent)", sizeof(VisualDeterrent));
+        printf("== footprint: startup work removed ==\n");
+        printf("%-32s %10.0f ns\n", "bank construction (host)", initNs);
+        printf("%-32s %10zu bytes\n", "serial banner output", bannerBytes);
+        printf("%-32s %10.2f ms\n", "  at 115200 baud", bannerBytes * 10 * 1000.0 / 115200);
+        return true;
+    }
+
+    // ==================== PERF ====================
+
+    bool benchPerf()
+    {
+        // Heavy-tailed execution times: mostly short, occasional long stalls
+        const int samples = 200000;
+        std::vector<unsigned long> durations(samples);
+        uint32_t seed = 12345;
+        for (int i = 0; i < samples; i++)
+        {
+            seed = seed * 1664525 + 1013904223;
+            double u = ((seed >> 8) + 1) / 16777217.0;
+            durations[i] = (unsigned long)(20.0 * pow(u, -0.7));
+        }
+
+        PerfProbe probe("bench");
+        BenchClock::time_point start = BenchClock::now();
+        for (int i = 0; i < samples; i++)
+        {
+            probe.record(durations[i]);
+        }
+        double recordNs = elapsedNs(start, BenchClock::now()) / samples;
+
+        std::vector<unsigned long> sorted = durations;
+        std::sort(sorted.begin(), sorted.end());
+
+        printf("== perf: histogram accuracy (%d samples) ==\n", samples);
+        printf("%-10s %10s %10s %8s\n", "quantile", "exact us", "probe us", "error");
+        bool passed = true;
+        const float quantiles[] = {0.5, 0.9, 0.99, 0.999};
+        for (size_t q = 0; q < sizeof(quantiles) / sizeof(quantiles[0]); q++)
+        {
+            unsigned long exact = sorted[(size_t)(quantiles[q] * (samples - 1))];
+            unsigned long reported = probe.getPercentile(quantiles[q]);
+            double error = exact > 0 ? (double)reported / exact - 1.0 : 0.0;
+            // Buckets are at most a quarter of their lower edge wide
+            bool ok = reported >= exact && reported <= exact + exact / PERF_SUB_BUCKETS + 1;
+            passed = passed && ok;
+            printf("p%-9g %10lu %10lu %7.1f%% %s\n", quantiles[q] * 100, exact, reported, error * 100,
+                   ok ? "" : "FAIL");
+        }
+        passed = passed && probe.getMax() == sorted.back() && probe.getMin() == sorted.front();
+
+        const int rounds = 1000000;
+        start = BenchClock::now();
+        for (int i = 0; i < rounds; i++)
+        {
+            PERF_SCOPE(PERF_DETECTION_UPDATE);
+        }
+        double scopeNs = elapsedNs(start, BenchClock::now()) / rounds;
+        perfResetAll();
+
+        printf("== perf: instrumentation cost (host) ==\n");
+        printf("%-32s %10.1f ns\n", "PerfProbe::record", recordNs);
+        printf("%-32s %10.1f ns\n", "PERF_SCOPE incl. 2x micros()", scopeNs);
+        printf("%-32s %10zu bytes\n", "sizeof(PerfProbe)", sizeof(PerfProbe));
+        printf("%-32s %10zu bytes\n", "all probes, SRAM", sizeof(PerfProbe) * PERF_PROBE_COUNT);
+        printf("perf: %s\n", passed ? "PASS" : "FAIL");
+        return passed;
+    }
+
+    // ==================== TELEMETRY ====================
+
+    // A bird closing in and leaving while the battery sags, sampled at 10 Hz
+    TelemetrySample telemetryScene(int step)
+    {
+        TelemetrySample sample;
+        float distance = step % 400 < 200 ? 350.0 - (step % 200) * 1.65 : 20.0 + (step % 200) * 1.65;
+        sample.values[TELEMETRY_TIMESTAMP_MS] = 5000 + step * 100;
+        sample.values[TELEMETRY_STATE] = distance < 100.0 ? 2 : (distance < 300.0 ? 1 : 0);
+        sample.values[TELEMETRY_BATTERY_MV] = 12600 - step / 50;
+        sample.values[TELEMETRY_TEMPERATURE_CC] = 3500 + (step / 20) % 7;
+        sample.values[TELEMETRY_BIRD_COUNT] = distance < 300.0 ? 1 : 0;
+        sample.values[TELEMETRY_CLOSEST_DISTANCE_MM] = distance < 300.0 ? (int32_t)(distance * 10.0) : 99990;
+        sample.values[TELEMETRY_WEATHER_CONDITION] = 0;
+        sample.values[TELEMETRY_WEATHER_CRITICAL] = 0;
+        sample.values[TELEMETRY_EMERGENCY_STATE] = 0;
+        sample.values[TELEMETRY_HEALTH_ISSUES] = 0;
+        return sample;
+    }
+
+    size_t encodeJsonTelemetry(const TelemetrySample &sample, String &output)
+    {
+        static const char *const states[] = {"STANDBY", "ALERT", "ACTIVE_DETERRENT"};
+        DynamicJsonDocument telemetry(1024);
+        telemetry["timestamp"] = (unsigned long)sample.values[TELEMETRY_TIMESTAMP_MS];
+        telemetry["state"] = states[sample.values[TELEMETRY_STATE]];
+        telemetry["battery_voltage"] = sample.values[TELEMETRY_BATTERY_MV] / 1000.0f;
+        telemetry["temperature"] = sample.values[TELEMETRY_TEMPERATURE_CC] / 100.0f;
+        telemetry["bird_count"] = (int)sample.values[TELEMETRY_BIRD_COUNT];
+        telemetry["closest_bird_distance"] = sample.values[TELEMETRY_CLOSEST_DISTANCE_MM] / 10.0f;
+        telemetry["weather_status"] = "NORMAL";
+        telemetry["system_health"] = "OK";
+        output = "";
+        serializeJson(telemetry, output);
+        // println framing on the serial link
+        return output.length() + 2;
+    }
+
+    bool benchTelemetry()
+    {
+        const int frames = 20000;
+        std::vector<TelemetrySample> samples(frames);
+        for (int i = 0; i < frames; i++)
+        {
+            samples[i] = telemetryScene(i);
+        }
+
+        size_t jsonBytes = 0;
+        String json;
+        BenchClock::time_point start = BenchClock::now();
+        for (int i = 0; i < frames; i++)
+        {
+            jsonBytes += encodeJsonTelemetry(samples[i], json);
+        }
+        double jsonNs = elapsedNs(start, BenchClock::now()) / frames;
+
+        TelemetryEncoder encoder;
+        size_t binaryBytes = 0;
+        size_t keyBytes = 0;
+        size_t largest = 0;
+        start = BenchClock::now();
+        for (int i = 0; i < frames; i++)
+        {
+            size_t length = encoder.encode(samples[i]);
+            binaryBytes += length;
+            if (length > largest)
+            {
+                largest = length;
+            }
+            if (i % TELEMETRY_KEYFRAME_INTERVAL == 0)
+            {
+                keyBytes += length;
+            }
+        }
+        double binaryNs = elapsedNs(start, BenchClock::now()) / frames;
+
+        // Uplink batches: one flush per five samples (10 Hz sampling, 2 Hz flush)
+        const int batchSize = 5;
+        size_t batchBytes = 0;
+        int batchFrames = 0;
+        encoder.reset();
+        start = BenchClock::now();
+        for (int i = 0; i < frames; i += batchSize)
+        {
+            encoder.beginBatch();
+            for (int j = i; j < i + batchSize && j < frames; j++)
+            {
+                encoder.addToBatch(samples[j]);
+            }
+            batchBytes += encoder.finishBatch();
+            batchFrames++;
+        }
+        double batchNs = elapsedNs(start, BenchClock::now()) / frames;
+
+        // COBS must leave the delimiters as the only zero bytes
+        encoder.reset();
+        bool framingOk = true;
+        for (int i = 0; i < 200; i++)
+        {
+            size_t length = encoder.encode(samples[i]);
+            const uint8_t *frame = encoder.getFrame();
+            framingOk = framingOk && frame[0] == 0 && frame[length - 1] == 0 && length <= TELEMETRY_MAX_FRAME;
+            for (size_t b = 1; b + 1 < length; b++)
+            {
+                framingOk = framingOk && frame[b] != 0;
+            }
+        }
+
+        const double linkBytesPerSecond = 115200 / 10.0;
+        double jsonFrame = (double)jsonBytes / frames;
+        double binaryFrame = (double)binaryBytes / frames;
+        int keyFrames = (frames + TELEMETRY_KEYFRAME_INTERVAL - 1) / TELEMETRY_KEYFRAME_INTERVAL;
+
+        printf("== telemetry: %d frames of a 10 Hz approach scene ==\n", frames);
+        printf("%-24s %12s %12s %14s\n", "encoding", "bytes/sample", "encode ns", "max Hz @115k2");
+        printf("%-24s %12.1f %12.0f %14.0f\n", "JSON (println)", jsonFrame, jsonNs, linkBytesPerSecond / jsonFrame);
+        printf("%-24s %12.1f %12.0f %14.0f\n", "binary (COBS+CRC)", binaryFrame, binaryNs,
+               linkBytesPerSecond / binaryFrame);
+        printf("%-24s %12.1f %12.0f %14.0f\n", "binary, batches of 5", (double)batchBytes / frames, batchNs,
+               linkBytesPerSecond * frames / batchBytes);
+        printf("%-24s %12.1f\n", "  key frames", (double)keyBytes / keyFrames);
+        printf("%-24s %12.1f\n", "  batch frames", (double)batchBytes / batchFrames);
+        printf("%-24s %12zu\n", "  largest frame", largest);
+        printf("%-24s %11.1f%%\n", "link load at 10 Hz", binaryFrame * 10 * 100 / linkBytesPerSecond);
+        printf("%-24s %11.1f%%\n", "  batched", (double)batchBytes / frames * 10 * 100 / linkBytesPerSecond);
+        printf("telemetry framing: %s\n", framingOk ? "PASS" : "FAIL");
+        return framingOk;
+    }
+
+    // ==================== EVENTS ====================
+
+    struct EventScene
+    {
+        const char *name;
+        int birds;
+        float speedCmPerS; // Closing speed; 0 for birds perched in view
+    };
+
+    // Bytes per second on the link for 60 s of a scene, polled at 20 Hz
+    void runEventScene(const EventScene &scene, double &eventBytesPerS, double &pollBytesPerS, double &eventsPerS)
+    {
+        const int pollHz = 20;
+        const int seconds = 60;
+        BirdObject tracks[MAX_BIRDS];
+        for (int b = 0; b < scene.birds; b++)
+        {
+            tracks[b].trackId = b + 1;
+            tracks[b].confirmed = true;
+            tracks[b].azimuth = (b * 90) % 360;
+            tracks[b].confidenceLevel = 100;
+        }
+
+        TrackEventStream stream;
+        TelemetryEncoder encoder;
+        size_t pollBytes = 0;
+        for (int step = 0; step < pollHz * seconds; step++)
+        {
+            unsigned long now = 1000 + step * (1000 / pollHz);
+            float t = step / (float)pollHz;
+            for (int b = 0; b < scene.birds; b++)
+            {
+                // Back and forth between 50 and 350 cm
+                float span = 300.0;
+                float travel = fmod(t * scene.speedCmPerS + b * 70.0, 2 * span);
+                tracks[b].distance = 50.0 + (travel < span ? span - travel : travel - span);
+                tracks[b].velocity = (travel < span ? scene.speedCmPerS : -scene.speedCmPerS) / 100.0;
+            }
+
+            stream.update(tracks, scene.birds, now);
+            stream.emit(encoder, now);
+
+            // Fixed poll: every track, every tick
+            if (scene.birds > 0)
+            {
+                int32_t values[1 + MAX_BIRDS * TRACK_EVENT_FIELDS];
+                values[0] = now;
+                for (int b = 0; b < scene.birds; b++)
+                {
+                    int32_t *record = &values[1 + b * TRACK_EVENT_FIELDS];
+                    record[0] = tracks[b].trackId;
+                    record[1] = TRACK_EVENT_UPDATE;
+                    record[2] = (int32_t)lround(tracks[b].distance * 10.0);
+                    record[3] = (int32_t)lround(tracks[b].azimuth * 10.0);
+                    record[4] = (int32_t)lround(tracks[b].velocity * 100.0);
+                    record[5] = tracks[b].confidenceLevel;
+                }
+                pollBytes += encoder.encodeValues(TELEMETRY_FRAME_TRACKS, values, 1 + scene.birds * TRACK_EVENT_FIELDS);
+            }
+        }
+        eventBytesPerS = (double)stream.getBytesSent() / seconds;
+        pollBytesPerS = (double)pollBytes / seconds;
+        eventsPerS = (double)stream.getEventsSent() / seconds;
+    }
+
+    bool benchEvents()
+    {
+        const EventScene scenes[] = {
+            {"empty sky", 0, 0.0},
+            {"1 bird perched", 1, 0.0},
+            {"1 bird, 50 cm/s", 1, 50.0},
+            {"3 birds, 100 cm/s", 3, 100.0},
+            {"10 birds, 300 cm/s", 10, 300.0},
+        };
+        const double linkBytesPerSecond = 115200 / 10.0;
+
+        printf("== events: per-track stream vs 20 Hz poll of every track ==\n");
+        printf("%-22s %10s %12s %12s %8s\n", "scene", "events/s", "stream B/s", "poll B/s", "link %");
+        bool passed = true;
+        double previous = -1;
+        for (size_t i = 0; i < sizeof(scenes) / sizeof(scenes[0]); i++)
+        {
+            double eventBytes, pollBytes, eventsPerS;
+            runEventScene(scenes[i], eventBytes, pollBytes, eventsPerS);
+            printf("%-22s %10.1f %12.0f %12.0f %7.1f%%\n", scenes[i].name, eventsPerS, eventBytes, pollBytes,
+                   eventBytes * 100 / linkBytesPerSecond);
+
+            // Bandwidth should rise with activity and stay within the rate cap
+            passed = passed && eventBytes >= previous && eventsPerS <= TRACK_EVENT_MAX_RATE_HZ + 0.5;
+            previous = eventBytes;
+        }
+        printf("events: %s\n", passed ? "PASS" : "FAIL");
+        return passed;
+    }
+
+    // ==================== STROBE ====================
+
+    StrobeSequencer *benchSequencer = nullptr;
+    const int strobePins[] = {LED_STROBE_PIN_1, LED_STROBE_PIN_2};
+
+    void benchStrobeTick()
+    {
+        benchSequencer->tick();
+    }
+
+    // Busy stretches of a loaded main loop in microseconds: mostly a few ms,
+    // with a heavy tail out to blocking work of 100 ms and more
+    unsigned long mainLoopBusyUs(uint32_t &seed)
+    {
+        seed = seed * 1664525 + 1013904223;
+        double u = ((seed >> 8) + 1) / 16777217.0;
+        return (unsigned long)(1000.0 * min(2.0 * pow(u, -0.7), 150.0));
+    }
+
+    struct StrobeTiming
+    {
+        size_t edges;
+        double meanUs;
+        double p99Us;
+        double maxUs;
+        int shortFlashes; // Lit for less than half the programmed time
+    };
+
+    // Plays a program for durationMs of virtual time under main-loop load and
+    // compares every level change on the first LED with the time the program
+    // puts it at: tick n after the commit plays cycle offset n - 1.
+    StrobeTiming measureStrobeTiming(const StrobeProgram &program, bool timerDriven, unsigned long durationMs)
+    {
+        SimHal::reset();
+        SimHal::setRecordAnalogWrites(true);
+
+        StrobeSequencer sequencer;
+        PwmPinLedDriver driver(strobePins, 2);
+        sequencer.begin(&driver);
+        *sequencer.editProgram() = program;
+        sequencer.commitProgram(true);
+        benchSequencer = &sequencer;
+        if (timerDriven)
+        {
+            StrobeTimer::start(STROBE_TICK_HZ, &benchStrobeTick);
+        }
+
+        uint32_t seed = 777;
+        while (millis() < durationMs)
+        {
+            if (!timerDriven)
+            {
+                sequencer.poll(millis());
+            }
+            delayMicroseconds(mainLoopBusyUs(seed));
+        }
+        if (timerDriven)
+        {
+            StrobeTimer::stop();
+        }
+        benchSequencer = nullptr;
+
+        std::vector<SimHal::AnalogWriteRecord> measured;
+        for (size_t i = 0; i < SimHal::getAnalogWrites().size(); i++)
+        {
+            if (SimHal::getAnalogWrites()[i].pin == LED_STROBE_PIN_1)
+            {
+                measured.push_back(SimHal::getAnalogWrites()[i]);
+            }
+        }
+        SimHal::setRecordAnalogWrites(false);
+
+        std::vector<uint64_t> ideal;
+        int level = 0;
+        for (uint64_t cycleStart = 0; ideal.size() < measured.size(); cycleStart += program.cycleMs)
+        {
+            for (int e = 0; e < program.edgeCount && ideal.size() < measured.size(); e++)
+            {
+                if (program.edges[e].levels[0] != level)
+                {
+                    level = program.edges[e].levels[0];
+                    ideal.push_back((cycleStart + program.edges[e].atMs + 1) * 1000);
+                }
+            }
+        }
+
+        StrobeTiming timing = {measured.size(), 0, 0, 0, 0};
+        std::vector<double> errors;
+        for (size_t i = 0; i < measured.size(); i++)
+        {
+            double error = (double)measured[i].timeUs - (double)ideal[i];
+            errors.push_back(fabs(error));
+            timing.meanUs += fabs(error);
+
+            bool flashEnds = i > 0 && measured[i - 1].value > 0 && measured[i].value == 0;
+            if (flashEnds && (measured[i].timeUs - measured[i - 1].timeUs) * 2 < ideal[i] - ideal[i - 1])
+            {
+                timing.shortFlashes++;
+            }
+        }
+        if (!errors.empty())
+        {
+            std::sort(errors.begin(), errors.end());
+            timing.meanUs /= errors.size();
+            timing.p99Us = errors[(size_t)(0.99 * (errors.size() - 1))];
+            timing.maxUs = errors.back();
+        }
+        return timing;
+    }
+
+    bool benchStrobe()
+    {
+        SimHal::reset();
+        SimHal::setRecordAnalogWrites(false);
+        VisualDeterrent visual;
+        PwmPinLedDriver driver(strobePins, 2);
+        visual.begin(driver);
+
+        const StrobePattern patterns[] = {PATTERN_FAST_BLINK, PATTERN_DOUBLE_FLASH, PATTERN_EMERGENCY};
+        const char *names[] = {"fast blink", "double flash", "emergency"};
+        const unsigned long durationMs = 60000;
+
+        printf("== strobe: LED 1 edge error vs program, loaded main loop, %lu s virtual ==\n", durationMs / 1000);
+        printf("%-14s %-10s %7s %10s %10s %10s %7s\n", "pattern", "driver", "edges", "mean us", "p99 us", "max us",
+               "short");
+        bool passed = true;
+        for (size_t p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++)
+        {
+            StrobeProgram program;
+            visual.compileStrobePattern(patterns[p], program);
+            for (int timerDriven = 0; timerDriven < 2; timerDriven++)
+            {
+                StrobeTiming timing = measureStrobeTiming(program, timerDriven, durationMs);
+                printf("%-14s %-10s %7zu %10.0f %10.0f %10.0f %7d\n", names[p], timerDriven ? "timer ISR" : "main loop",
+                       timing.edges, timing.meanUs, timing.p99Us, timing.maxUs, timing.shortFlashes);
+
+                // Every programmed edge should be played, and from the timer exactly on time
+                size_t expected = 0;
+                for (int e = 0, level = 0; e < program.edgeCount; e++)
+                {
+                    expected += program.edges[e].levels[0] != level;
+                    level = program.edges[e].levels[0];
+                }
+                expected = expected * (durationMs - 1) / program.cycleMs;
+                if (timerDriven)
+                {
+                    passed = passed && timing.maxUs == 0 && timing.shortFlashes == 0 && timing.edges + 2 >= expected;
+                }
+            }
+        }
+
+        const int rounds = 1000000;
+        StrobeSequencer sequencer;
+        sequencer.begin(nullptr); // No output stage: measures the sequencing alone
+        visual.compileStrobePattern(PATTERN_FAST_BLINK, *sequencer.editProgram());
+        sequencer.commitProgram(true);
+        BenchClock::time_point start = BenchClock::now();
+        for (int i = 0; i < rounds; i++)
+        {
+            sequencer.tick();
+        }
+        double tickNs = elapsedNs(start, BenchClock::now()) / rounds;
+
+        printf("== strobe: cost ==\n");
+        printf("%-32s %10.1f ns\n", "StrobeSequencer::tick (host)", tickNs);
+        printf("%-32s %10zu bytes\n", "sizeof(StrobeSequencer)", sizeof(StrobeSequencer));
+        printf("strobe: %s\n", passed ? "PASS" : "FAIL");
+        return passed;
+    }
+
+    // ==================== LEDS ====================
+
+    // Decodes a TLC5947 shift-out back into 8-bit levels, last channel first
+    bool tlcFrameMatches(const std::vector<uint8_t> &bytes, const uint8_t *levels, int channels)
+    {
+        if (bytes.size() != TLC5947_FRAME_BYTES)
+            return false;
+
+        for (int pair = 0; pair < TLC5947_CHANNELS / 2; pair++)
+        {
+            const uint8_t *b = &bytes[pair * 3];
+            int high = TLC5947_CHANNELS - 1 - pair * 2;
+            uint16_t values[2] = {(uint16_t)((b[0] << 4) | (b[1] >> 4)), (uint16_t)(((b[1] & 0x0F) << 8) | b[2])};
+            for (int k = 0; k < 2; k++)
+            {
+                int channel = high - k;
+                uint8_t expected = channel < channels ? levels[channel] : 0;
+                if (values[k] >> 4 != expected || (values[k] & 0x0F) != expected >> 4)
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    // Average cost of committing frames that change every channel
+    double measureFrameCommit(LedDriver &driver, int rounds)
+    {
+        uint8_t frames[2][MAX_LED_CHANNELS];
+        for (int i = 0; i < MAX_LED_CHANNELS; i++)
+        {
+            frames[0][i] = 40 + i * 10;
+            frames[1][i] = 215 - i * 10;
+        }
+
+        BenchClock::time_point start = BenchClock::now();
+        for (int i = 0; i < rounds; i++)
+        {
+            driver.commitFrame(frames[i & 1]);
+        }
+        return elapsedNs(start, BenchClock::now()) / rounds;
+    }
+
+    bool benchLeds()
+    {
+        SimHal::reset();
+        SimHal::setRecordAnalogWrites(true);
+
+        const int channelCounts[] = {2, 4, 8, 12, 16};
+        const int rounds = 200000;
+        int pins[MAX_LED_CHANNELS];
+        for (int i = 0; i < MAX_LED_CHANNELS; i++)
+        {
+            pins[i] = 2 + i; // Host pins only; a MKR board has far fewer PWM outputs
+        }
+
+        printf("== leds: frame commit with every channel changing ==\n");
+        printf("%-9s %12s %12s %12s %12s %12s\n", "channels", "pins ns", "pin writes", "tlc ns", "spi bytes",
+               "spi wire us");
+        bool passed = true;
+        for (size_t c = 0; c < sizeof(channelCounts) / sizeof(channelCounts[0]); c++)
+        {
+            int channels = channelCounts[c];
+
+            PwmPinLedDriver pinDriver(pins, channels);
+            pinDriver.begin();
+            SimHal::clearAnalogWrites();
+            const int countedRounds = 100;
+            measureFrameCommit(pinDriver, countedRounds);
+            double pinWrites = (double)SimHal::getAnalogWrites().size() / countedRounds;
+            SimHal::setRecordAnalogWrites(false);
+            double pinNs = measureFrameCommit(pinDriver, rounds);
+            SimHal::setRecordAnalogWrites(true);
+
+            Tlc5947LedDriver tlcDriver(SPI, LED_EXPANDER_SPI_HZ, LED_EXPANDER_LATCH_PIN, channels);
+            tlcDriver.begin();
+            double tlcNs = measureFrameCommit(tlcDriver, rounds);
+            double wireUs = tlcDriver.getFrameBytes() * 8 * 1e6 / LED_EXPANDER_SPI_HZ;
+
+            // The last frame sent must decode back to the levels committed
+            uint8_t check[MAX_LED_CHANNELS];
+            for (int i = 0; i < MAX_LED_CHANNELS; i++)
+            {
+                check[i] = (uint8_t)(i * 37 + channels);
+            }
+            tlcDriver.commitFrame(check);
+            bool decoded = tlcFrameMatches(SPI.lastTransaction, check, channels);
+            passed = passed && decoded && pinWrites == channels;
+
+            printf("%-9d %12.1f %12.1f %12.1f %12zu %12.1f %s\n", channels, pinNs, pinWrites, tlcNs,
+                   tlcDriver.getFrameBytes(), wireUs, decoded ? "" : "DECODE FAIL");
+        }
+        SimHal::setRecordAnalogWrites(false);
+
+        printf("%-32s %10zu bytes\n", "sizeof(StrobeProgram)", sizeof(StrobeProgram));
+        printf("%-32s %10zu bytes\n", "sizeof(VisualDeterrent)", sizeof(VisualDeterrent));
+        printf("leds: %s\n", passed ? "PASS" : "FAIL");
+        return passed;
+    }
+
+    // ==================== THERMAL ====================
+
+    struct StrobeOutput
+    {
+        double strobeSeconds; // Light delivered on LED 1, in seconds at full level
+        double longestDarkS;  // Longest stretch without a flash
+        double peakC;
+    };
+
+    // Both runs share the RC plant in LedThermalModel; only the policy differs
+    StrobeOutput summarizeStrobeOutput(const std::vector<SimHal::AnalogWriteRecord> &writes, uint64_t endUs,
+                                       double peakC)
+    {
+        StrobeOutput result = {0, 0, peakC};
+        uint64_t lastUs = 0;
+        uint64_t darkSinceUs = 0;
+        int level = 0;
+        for (size_t i = 0; i <= writes.size(); i++)
+        {
+            uint64_t timeUs = i < writes.size() ? writes[i].timeUs : endUs;
+            result.strobeSeconds += level / 255.0 * (timeUs - lastUs) / 1e6;
+            if (level == 0 && (i == writes.size() || writes[i].value > 0))
+            {
+                result.longestDarkS = max(result.longestDarkS, (timeUs - darkSinceUs) / 1e6);
+            }
+            if (i == writes.size())
+                break;
+            if (level > 0 && writes[i].value == 0)
+            {
+                darkSinceUs = timeUs;
+            }
+            level = writes[i].value;
+            lastUs = timeUs;
+        }
+        return result;
+    }
+
+    // The policy this replaced: run the pattern as commanded, cut every
+    // channel above 70 C and resume below 60 C, checked once a second
+    StrobeOutput runShutdownPolicy(float ambientC, int brightness, unsigned long durationMs)
+    {
+        const StrobeConfig blink = {200, 200, brightness, 999, "Fast Blink"};
+        LedThermalModel plant;
+        plant.reset(ambientC);
+
+        std::vector<SimHal::AnalogWriteRecord> writes;
+        bool shutdown = false;
+        int level = 0;
+        unsigned long levelMs = 0;
+        double peakC = ambientC;
+        for (unsigned long t = 0; t < durationMs; t++)
+        {
+            bool on = t % (blink.onDuration + blink.offDuration) < (unsigned long)blink.onDuration;
+            int next = on && !shutdown ? blink.brightness : 0;
+            if (next != level)
+            {
+                writes.push_back({t * 1000ULL, LED_STROBE_PIN_1, next});
+                level = next;
+            }
+            levelMs += level;
+
+            if ((t + 1) % LED_THERMAL_UPDATE_MS == 0)
+            {
+                plant.update(levelMs / (255.0 * LED_THERMAL_UPDATE_MS), ambientC, LED_THERMAL_UPDATE_MS / 1000.0);
+                levelMs = 0;
+                peakC = max(peakC, (double)plant.getTemperature());
+            }
+            if ((t + 1) % 1000 == 0)
+            {
+                if (plant.getTemperature() > LED_THERMAL_LIMIT_C)
+                    shutdown = true;
+                else if (plant.getTemperature() < LED_THERMAL_LIMIT_C - 10)
+                    shutdown = false;
+            }
+        }
+        return summarizeStrobeOutput(writes, durationMs * 1000ULL, peakC);
+    }
+
+    StrobeOutput runDeratingPolicy(float ambientC, unsigned long durationMs)
+    {
+        SimHal::reset();
+        SimHal::setAnalogInput(LIGHT_SENSOR_PIN, 1023);
+        SimHal::setRecordAnalogWrites(false);
+        PwmPinLedDriver driver(strobePins, 2);
+        VisualDeterrent visual;
+        visual.setAmbientTemperature(ambientC);
+        visual.begin(driver);
+
+        SimHal::clearAnalogWrites();
+        SimHal::setRecordAnalogWrites(true);
+        unsigned long start = millis();
+        visual.activateStrobeMode();
+        double peakC = ambientC;
+        while (millis() - start < durationMs)
+        {
+            visual.update();
+            peakC = max(peakC, (double)visual.getLEDTemperature(0));
+            delay(10);
+        }
+        uint64_t startUs = start * 1000ULL;
+        uint64_t endUs = SimHal::nowMicros();
+        visual.deactivate();
+        SimHal::setRecordAnalogWrites(false);
+
+        std::vector<SimHal::AnalogWriteRecord> writes;
+        for (size_t i = 0; i < SimHal::getAnalogWrites().size(); i++)
+        {
+            SimHal::AnalogWriteRecord record = SimHal::getAnalogWrites()[i];
+            if (record.pin == LED_STROBE_PIN_1 && record.timeUs < endUs)
+            {
+                record.timeUs -= startUs;
+                writes.push_back(record);
+            }
+        }
+        return summarizeStrobeOutput(writes, endUs - startUs, peakC);
+    }
+
+    bool benchThermal()
+    {
+        const float ambients[] = {25.0, 35.0, 45.0};
+        const unsigned long durationMs = 30UL * 60 * 1000;
+
+        printf("== thermal: 30 min sustained fast blink, LED 1, same RC plant ==\n");
+        printf("%-32s %10.0f s\n", "thermal time constant",
+               LED_THERMAL_RESISTANCE_C_PER_W * LED_THERMAL_CAPACITY_J_PER_C);
+        printf("%-8s %-10s %14s %14s %10s\n", "ambient", "policy", "strobe-s", "longest dark", "peak C");
+        // The same flash level the firmware compiles for the pattern, in full
+        // sun where it is brightest
+        SimHal::reset();
+        SimHal::setAnalogInput(LIGHT_SENSOR_PIN, 1023);
+        PwmPinLedDriver driver(strobePins, 2);
+        VisualDeterrent visual;
+        visual.begin(driver);
+        StrobeProgram program;
+        visual.compileStrobePattern(PATTERN_FAST_BLINK, program);
+        int brightness = program.edges[0].levels[0];
+
+        bool passed = true;
+        for (size_t a = 0; a < sizeof(ambients) / sizeof(ambients[0]); a++)
+        {
+            StrobeOutput shutdown = runShutdownPolicy(ambients[a], brightness, durationMs);
+            StrobeOutput derating = runDeratingPolicy(ambients[a], durationMs);
+            printf("%-8.0f %-10s %14.0f %13.1fs %10.1f\n", ambients[a], "shutdown", shutdown.strobeSeconds,
+                   shutdown.longestDarkS, shutdown.peakC);
+            printf("%-8.0f %-10s %14.0f %13.1fs %10.1f\n", ambients[a], "derating", derating.strobeSeconds,
+                   derating.longestDarkS, derating.peakC);
+
+            // Never past the limit, never dark for more than an off phase, and
+            // at least as much light as cutting out
+            passed = passed && derating.peakC <= LED_THERMAL_LIMIT_C && derating.longestDarkS < 0.25 &&
+                     derating.strobeSeconds >= shutdown.strobeSeconds * 0.99;
+        }
+        printf("thermal: %s\n", passed ? "PASS" : "FAIL");
+        return passed;
+    }
+
+    // ==================== BRIGHTNESS ====================
+
+    // The per-write scaling this replaced: a float multiply by an ambient
+    // factor, linear in PWM
+    int legacyAdaptiveBrightness(int baseBrightness, float ambientLight)
+    {
+        float adaptiveFactor = 0.5 + ambientLight * 0.5;
+        int adaptedBrightness = (int)(baseBrightness * adaptiveFactor);
+        return constrain(adaptedBrightness, 0, 255);
+    }
+
+    double timeLegacyWrites(int rounds)
+    {
+        volatile uint8_t sink = 0;
+        volatile float ambient = 0.6;
+        BenchClock::time_point start = BenchClock::now();
+        for (int i = 0; i < rounds; i++)
+        {
+            sink = legacyAdaptiveBrightness(i & 0xFF, ambient);
+        }
+        (void)sink;
+        return elapsedNs(start, BenchClock::now()) / rounds;
+    }
+
+    double timeTableWrites(BrightnessTable &table, int rounds)
+    {
+        volatile uint8_t sink = 0;
+        BenchClock::time_point start = BenchClock::now();
+        for (int i = 0; i < rounds; i++)
+        {
+            sink = table.lookup(i & 0xFF);
+        }
+        (void)sink;
+        return elapsedNs(start, BenchClock::now()) / rounds;
+    }
+
+    // Dawn to noon in readings every LED_AMBIENT_UPDATE_MS: a ramp over the
+    // whole sensor range with a few counts of noise on top
+    int countRebuilds(unsigned long durationMs, int noise, bool hysteresis)
+    {
+        BrightnessTable table;
+        table.setAmbient(0);
+        unsigned long before = table.getRebuildCount();
+        int lastBucket = table.getBucket();
+        int bucketChanges = 0;
+
+        randomSeed(7);
+        for (unsigned long t = 0; t <= durationMs; t += LED_AMBIENT_UPDATE_MS)
+        {
+            int reading = constrain((int)(t * 1023ULL / durationMs) + (int)random(-noise, noise + 1), 0, 1023);
+            if (hysteresis)
+            {
+                table.setAmbient(reading);
+            }
+            else if (BrightnessTable::bucketFor(reading) != lastBucket)
+            {
+                lastBucket = BrightnessTable::bucketFor(reading);
+                bucketChanges++;
+            }
+        }
+        return hysteresis ? (int)(table.getRebuildCount() - before) : bucketChanges;
+    }
+
+    // Level the firmware flashes at for a light sensor reading, after the
+    // change has had time to reach the running program
+    int firmwareFlashLevel(int initialReading, int reading)
+    {
+        SimHal::reset();
+        SimHal::setAnalogInput(LIGHT_SENSOR_PIN, initialReading);
+        PwmPinLedDriver driver(strobePins, 2);
+        VisualDeterrent visual;
+        visual.begin(driver);
+        visual.activateStrobeMode();
+        for (int i = 0; i < 100; i++)
+        {
+            visual.update();
+            delay(10);
+        }
+
+        SimHal::setAnalogInput(LIGHT_SENSOR_PIN, reading);
+        int level = 0;
+        for (int i = 0; i < 200; i++)
+        {
+            visual.update();
+            level = max(level, SimHal::getLastAnalogWrite(LED_STROBE_PIN_1));
+            if (i == 100)
+            {
+                level = 0; // Only what plays after the switch-over
+            }
+            delay(10);
+        }
+        visual.deactivate();
+        return level;
+    }
+
+    bool benchBrightness()
+    {
+        const int rounds = 10000000;
+        const unsigned long dawnToNoonMs = 4UL * 60 * 60 * 1000;
+        const int requests[] = {0, 16, 32, 64, 96, 128, 160, 192, 224, 255};
+        const int requestCount = sizeof(requests) / sizeof(requests[0]);
+
+        BrightnessTable table;
+        double legacyNs = timeLegacyWrites(rounds);
+        double tableNs = timeTableWrites(table, rounds);
+
+        BenchClock::time_point start = BenchClock::now();
+        for (int i = 0; i < 1000; i++)
+        {
+            table.setAmbient(i & 1 ? 0 : 1023);
+        }
+        double rebuildNs = elapsedNs(start, BenchClock::now()) / 1000;
+        table.setAmbient(1023);
+
+        int noisyRebuilds = countRebuilds(dawnToNoonMs, 10, true);
+        int rawBucketChanges = countRebuilds(dawnToNoonMs, 10, false);
+
+        printf("== brightness: gamma-corrected ambient table ==\n");
+        printf("%-32s %10.2f ns\n", "float scaling per write (host)", legacyNs);
+        printf("%-32s %10.2f ns\n", "table lookup per write (host)", tableNs);
+        printf("%-32s %10.0f ns\n", "row rebuild (host)", rebuildNs);
+        printf("%-32s %10zu bytes\n", "table, SRAM", sizeof(BrightnessTable));
+        printf("%-32s %10d bytes\n", "gamma curve, flash", BRIGHTNESS_LEVELS);
+        printf("%-32s %10d\n", "dawn to noon, bucket crossings", rawBucketChanges);
+        printf("%-32s %10d\n", "dawn to noon, table rebuilds", noisyRebuilds);
+
+        // Visual validation: PWM out per ambient bucket and requested level
+        printf("\n%-12s", "ADC \\ req");
+        for (int r = 0; r < requestCount; r++)
+        {
+            printf("%5d", requests[r]);
+        }
+        printf("\n");
+
+        bool passed = true;
+        int previousRow[requestCount] = {};
+        for (int bucket = 0; bucket < LED_AMBIENT_BUCKETS; bucket++)
+        {
+            BrightnessTable row;
+            row.setAmbient(bucket * AMBIENT_BUCKET_WIDTH + AMBIENT_BUCKET_WIDTH / 2);
+            printf("%4d-%-7d", bucket * AMBIENT_BUCKET_WIDTH, (bucket + 1) * AMBIENT_BUCKET_WIDTH - 1);
+            for (int r = 0; r < requestCount; r++)
+            {
+                int level = row.lookup(requests[r]);
+                printf("%5d", level);
+
+                // Within a count of the exact curve, and never darker for a
+                // brighter request or a brighter sky
+                double perceived = requests[r] * BrightnessTable::gainFor(bucket) / 256.0 / 255.0;
+                double exact = 255.0 * pow(perceived, 2.2);
+                passed = passed && (requests[r] == 0 ? level == 0 : level >= 1 && fabs(level - exact) <= 1.5);
+                passed = passed && (r == 0 || level >= row.lookup(requests[r - 1])) && level >= previousRow[r];
+                previousRow[r] = level;
+            }
+            printf("\n");
+        }
+        passed = passed && table.lookup(255) == 255;
+
+        // The sketch never sets the light level: the firmware reads it and
+        // re-levels a running pattern at the next cycle
+        int duskLevel = firmwareFlashLevel(1023, 100);
+        int noonLevel = firmwareFlashLevel(100, 1023);
+        BrightnessTable dusk;
+        dusk.setAmbient(100);
+        printf("\n%-32s %10d (table %d)\n", "firmware flash, dusk", duskLevel, dusk.lookup(255));
+        printf("%-32s %10d (table %d)\n", "firmware flash, noon", noonLevel, table.lookup(255));
+
+        passed = passed && noisyRebuilds == LED_AMBIENT_BUCKETS - 1 &&
+                 duskLevel == dusk.lookup(255) && noonLevel == 255;
+        printf("brightness: %s\n", passed ? "PASS" : "FAIL");
+        return passed;
+    }
+
+    // ==================== TARGETING ====================
+
+#define BENCH_TARGET_SEGMENTS 8      // Expander ring, 45 degrees per segment
+#define BENCH_SENSOR_STEP_DEG 45.0   // Eight-transducer ring: tracks carry its boresights
+#define BENCH_DETER_EXPOSURE 1.0     // Full-output seconds of stimulus that turn a bird
+#define BENCH_STRIKE_CM 20.0
+#define BENCH_FLEE_MPS 1.5
+#define BENCH_AUDIO_VOLUME 0.7       // Crow distress base volume
+#define BENCH_AMP_FULL_POWER_W 12.0  // Amplifier draw at full drive
+#define BENCH_TARGET_STEP_MS 10
+
+    struct ScriptedBird
+    {
+        unsigned long arriveMs;
+        float azimuth;
+        float speedMps;
+    };
+
+    // Singles and pairs from all round the rig, some from directions the
+    // front-heavy native strobes would cover poorly
+    const ScriptedBird targetingScenario[] = {
+        {0, 0.0, 1.0}, {4000, 90.0, 1.2}, {9000, 200.0, 0.8}, {15000, 300.0, 1.5}, {15500, 120.0, 1.0},
+        {25000, 45.0, 1.4}, {32000, 250.0, 0.7}, {40000, 180.0, 1.2}, {41000, 10.0, 1.0}, {50000, 135.0, 1.5},
+        {58000, 330.0, 0.9}, {65000, 270.0, 1.1}};
+    const int targetingBirdCount = sizeof(targetingScenario) / sizeof(targetingScenario[0]);
+    const unsigned long targetingDurationMs = 80000;
+
+    struct TargetingResult
+    {
+        int deterred;
+        int strikes;
+        double ledJoules;
+        double audioJoules;
+        double closestCm; // Nearest any bird got before turning
+        double litSegmentSeconds;
+        double activeSeconds;
+    };
+
+    struct BirdState
+    {
+        float distance; // cm
+        float exposure;
+        bool arrived;
+        bool fleeing;
+        bool gone;
+    };
+
+    TargetingResult runTargetingScenario(bool targeted)
+    {
+        const int segmentPins[BENCH_TARGET_SEGMENTS] = {40, 41, 42, 43, 44, 45, 46, 47};
+        TargetingResult result = {0, 0, 0, 0, TARGET_RANGE_CM, 0, 0};
+
+        SimHal::reset();
+        SimHal::setAnalogInput(LIGHT_SENSOR_PIN, 1023);
+        SimHal::setRecordAnalogWrites(false);
+        PwmPinLedDriver driver(segmentPins, BENCH_TARGET_SEGMENTS);
+        VisualDeterrent visual;
+        visual.begin(driver);
+        DeterrentTargeting ledTargeting;
+        ledTargeting.beginRing(BENCH_TARGET_SEGMENTS);
+        DeterrentTargeting speakerTargeting;
+        const EmitterMount speaker = {0.0, 360.0};
+        speakerTargeting.begin(&speaker, 1);
+
+        BirdState birds[targetingBirdCount] = {};
+        BirdObject tracks[targetingBirdCount] = {};
+        bool deterring = false;
+
+        SimHal::clearAnalogWrites();
+        SimHal::setRecordAnalogWrites(true);
+        unsigned long start = millis();
+        uint64_t startUs = SimHal::nowMicros();
+        for (unsigned long t = 0; t < targetingDurationMs; t += BENCH_TARGET_STEP_MS)
+        {
+            float dt = BENCH_TARGET_STEP_MS / 1000.0;
+
+            // What the tracker would report: every bird in ranging range, on
+            // the bearing of the transducer that sees it
+            int trackCount = 0;
+            for (int b = 0; b < targetingBirdCount; b++)
+            {
+                BirdState &bird = birds[b];
+                if (!bird.arrived && t >= targetingScenario[b].arriveMs)
+                {
+                    bird.arrived = true;
+                    bird.distance = TARGET_RANGE_CM - 10.0;
+                }
+                if (!bird.arrived || bird.gone)
+                    continue;
+
+                BirdObject &track = tracks[trackCount++];
+                track.distance = bird.distance;
+                track.azimuth = fmod(lround(targetingScenario[b].azimuth / BENCH_SENSOR_STEP_DEG) * BENCH_SENSOR_STEP_DEG, 360.0);
+                track.velocity = bird.fleeing ? -BENCH_FLEE_MPS : targetingScenario[b].speedMps;
+                track.confirmed = true;
+            }
+
+            // Omnidirectional: everything runs while any bird is in view
+            if (trackCount > 0 && !deterring)
+            {
+                visual.activateStrobeMode();
+                deterring = true;
+            }
+            else if (trackCount == 0 && deterring)
+            {
+                visual.deactivate();
+                deterring = false;
+            }
+
+            float audioGain = deterring ? 1.0 : 0.0;
+            if (targeted)
+            {
+                ledTargeting.update(tracks, trackCount, millis());
+                speakerTargeting.update(tracks, trackCount, millis());
+                visual.setTargetMask(ledTargeting.getActiveMask());
+                audioGain = deterring ? speakerTargeting.getDrive(0) : 0.0;
+            }
+            float audioDrive = BENCH_AUDIO_VOLUME * audioGain;
+
+            visual.update();
+            delay(BENCH_TARGET_STEP_MS);
+
+            if (deterring)
+            {
+                result.activeSeconds += dt;
+            }
+            if (audioDrive > 0.01)
+            {
+                result.audioJoules += BENCH_AMP_FULL_POWER_W * audioDrive * dt;
+            }
+
+            // A bird sees the segment whose beam it is in, and the speaker
+            for (int b = 0; b < targetingBirdCount; b++)
+            {
+                BirdState &bird = birds[b];
+                if (!bird.arrived || bird.gone)
+                    continue;
+
+                if (!bird.fleeing)
+                {
+                    int facing = lround(targetingScenario[b].azimuth / (360.0 / BENCH_TARGET_SEGMENTS)) % BENCH_TARGET_SEGMENTS;
+                    float light = SimHal::getLastAnalogWrite(segmentPins[facing]) / 255.0;
+                    bird.exposure += (0.5 * light + 0.5 * audioDrive / BENCH_AUDIO_VOLUME) * dt;
+                    if (bird.exposure >= BENCH_DETER_EXPOSURE)
+                    {
+                        bird.fleeing = true;
+                        result.deterred++;
+                    }
+                }
+
+                bird.distance += (bird.fleeing ? BENCH_FLEE_MPS : -targetingScenario[b].speedMps) * 100.0 * dt;
+                if (!bird.fleeing)
+                {
+                    result.closestCm = min(result.closestCm, (double)bird.distance);
+                }
+                if (!bird.fleeing && bird.distance <= BENCH_STRIKE_CM)
+                {
+                    result.strikes++;
+                    bird.gone = true;
+                }
+                else if (bird.distance >= TARGET_RANGE_CM)
+                {
+                    bird.gone = true;
+                }
+            }
+        }
+        uint64_t endUs = SimHal::nowMicros();
+        visual.deactivate();
+        SimHal::setRecordAnalogWrites(false);
+        (void)start;
+
+        // LED energy from the levels actually written, segment by segment
+        for (int s = 0; s < BENCH_TARGET_SEGMENTS; s++)
+        {
+            uint64_t lastUs = startUs;
+            int level = 0;
+            const std::vector<SimHal::AnalogWriteRecord> &writes = SimHal::getAnalogWrites();
+            for (size_t i = 0; i <= writes.size(); i++)
+            {
+                if (i < writes.size() && (writes[i].pin != segmentPins[s] || writes[i].timeUs >= endUs))
+                    continue;
+                uint64_t timeUs = i < writes.size() ? writes[i].timeUs : endUs;
+                double seconds = (timeUs - lastUs) / 1e6;
+                result.ledJoules += LED_FULL_POWER_W * level / 255.0 * seconds;
+                if (level > 0)
+                {
+                    result.litSegmentSeconds += seconds;
+                }
+                if (i < writes.size())
+                {
+                    level = writes[i].value;
+                    lastUs = timeUs;
+                }
+            }
+        }
+        return result;
+    }
+
+    bool benchTargeting()
+    {
+        printf("== targeting: %d birds over %lu s, %d LED segments, one speaker ==\n", targetingBirdCount,
+               targetingDurationMs / 1000, BENCH_TARGET_SEGMENTS);
+        printf("%-10s %8s %8s %10s %10s %10s %12s %12s\n", "policy", "deterred", "strikes", "LED J", "audio J",
+               "closest cm", "segments lit", "J per bird");
+
+        TargetingResult results[2];
+        const char *names[2] = {"omni", "targeted"};
+        for (int p = 0; p < 2; p++)
+        {
+            TargetingResult &r = results[p];
+            r = runTargetingScenario(p == 1);
+            double total = r.ledJoules + r.audioJoules;
+            // Flashing segments are lit about half the time under fast blink
+            double segmentsLit = r.activeSeconds > 0 ? r.litSegmentSeconds / r.activeSeconds : 0.0;
+            printf("%-10s %8d %8d %10.0f %10.0f %10.0f %12.2f %12.1f\n", names[p], r.deterred, r.strikes, r.ledJoules,
+                   r.audioJoules, r.closestCm, segmentsLit, r.deterred > 0 ? total / r.deterred : 0.0);
+        }
+
+        double omniPerBird = (results[0].ledJoules + results[0].audioJoules) / max(results[0].deterred, 1);
+        double targetedPerBird = (results[1].ledJoules + results[1].audioJoules) / max(results[1].deterred, 1);
+        printf("%-32s %10.1f %%\n", "energy per deterred bird saved", 100.0 * (1.0 - targetedPerBird / omniPerBird));
+
+        // Every bird still turned away, for clearly less energy each
+        bool passed = results[1].deterred == targetingBirdCount && results[1].strikes == 0 &&
+                      results[0].deterred == targetingBirdCount && targetedPerBird < omniPerBird * 0.6;
+        printf("targeting: %s\n", passed ? "PASS" : "FAIL");
+        return passed;
+    }
+
+    // ==================== THREAT ====================
+
+#define BENCH_THREAT_STEP_MS 10
+#define BENCH_THREAT_SLOT_MS 40     // Each transducer reports this often under TDMA
+#define BENCH_THREAT_CONTROL_MS (1000 / CONTROL_UPDATE_FREQUENCY_HZ)
+#define BENCH_THREAT_NOISE_CM 3     // Uniform echo jitter, +/-
+#define BENCH_CONTACT_CM 20.0
+#define BENCH_LEAVE_MPS 1.0
+#define BENCH_THREAT_SENSORS 3
+
+    // One bird on one transducer: closes to holdCm, holds there (bobbing)
+    // for holdS, then leaves. A negative speed recedes from the start.
+    struct ThreatBird
+    {
+        int sensor;
+        float startCm;
+        float speedMps;
+        float holdCm;
+        float holdS;
+        float bobCm;
+        float bobPeriodS;
+    };
+
+    struct ThreatScenario
+    {
+        const char *name;
+        ThreatBird birds[BENCH_THREAT_SENSORS];
+        int birdCount;
+        unsigned long durationMs;
+    };
+
+    const ThreatScenario threatScenarios[] = {
+        {"fast approach", {{0, 380.0, 2.5, BENCH_CONTACT_CM, 60.0, 0.0, 1.0}}, 1, 3000},
+        {"slow approach", {{0, 380.0, 0.5, BENCH_CONTACT_CM, 60.0, 0.0, 1.0}}, 1, 9000},
+        {"hover at 1 m", {{1, 300.0, 0.5, 105.0, 15.0, 10.0, 3.0}}, 1, 28000},
+        {"loiter at 2.5 m", {{2, 380.0, 0.5, 250.0, 15.0, 20.0, 4.0}}, 1, 22000},
+        {"flushed, leaving", {{0, 50.0, -1.5, 0.0, 0.0, 0.0, 1.0}}, 1, 8000},
+        {"flock of three",
+         {{0, 380.0, 1.5, BENCH_CONTACT_CM, 60.0, 0.0, 1.0},
+          {1, 360.0, 1.4, BENCH_CONTACT_CM, 60.0, 0.0, 1.0},
+          {2, 340.0, 1.3, BENCH_CONTACT_CM, 60.0, 0.0, 1.0}},
+         3,
+         4000}};
+    const int threatScenarioCount = sizeof(threatScenarios) / sizeof(threatScenarios[0]);
+
+    float threatBirdDistanceCm(const ThreatBird &bird, unsigned long t)
+    {
+        float s = t / 1000.0;
+        if (bird.speedMps < 0)
+            return bird.startCm - bird.speedMps * 100.0 * s;
+
+        float travelS = (bird.startCm - bird.holdCm) / (bird.speedMps * 100.0);
+        if (s < travelS)
+            return bird.startCm - bird.speedMps * 100.0 * s;
+        s -= travelS;
+        if (s < bird.holdS)
+            return bird.holdCm + bird.bobCm * sin(2.0 * M_PI * s / bird.bobPeriodS);
+        return bird.holdCm + (s - bird.holdS) * BENCH_LEAVE_MPS * 100.0;
+    }
+
+    // The range-threshold logic the sketch escalated on before, over the same
+    // confirmed tracks. "shipped" is it as it ran, comparing tracker
+    // centimetres against metre constants; "range" is the same logic with
+    // the thresholds in centimetres, set to the new distance backstops.
+    struct RangePolicy
+    {
+        float alertCm;
+        float activeCm;
+        float emergencyCm;
+        float releaseCm; // No bird this close while deterring: back to STANDBY
+    };
+
+    const RangePolicy shippedPolicy = {100.0, 20.0, 5.0, 200.0};
+    const RangePolicy rangePolicy = {RANGING_MAX_RANGE_CM, THREAT_DETER_DISTANCE_M * 100.0,
+                                     THREAT_CRITICAL_DISTANCE_M * 100.0, RANGING_MAX_RANGE_CM};
+
+    SystemState stepRangePolicy(const RangePolicy &policy, SystemState state, const BirdObject *tracks, int count)
+    {
+        int birds = 0;
+        float closest = 9999.0;
+        for (int i = 0; i < count; i++)
+        {
+            if (tracks[i].confirmed && tracks[i].confidenceLevel > THREAT_MIN_CONFIDENCE)
+            {
+                birds++;
+                closest = min(closest, tracks[i].distance);
+            }
+        }
+
+        switch (state)
+        {
+        case STANDBY:
+            return birds > 0 && closest <= policy.alertCm ? ALERT : STANDBY;
+        case ALERT:
+            if (closest <= policy.activeCm)
+                return ACTIVE_DETERRENT;
+            return birds > 0 && closest <= policy.alertCm ? ALERT : STANDBY;
+        case ACTIVE_DETERRENT:
+            if (closest <= policy.emergencyCm && birds > 2)
+                return EMERGENCY;
+            return birds > 0 && closest <= policy.releaseCm ? ACTIVE_DETERRENT : STANDBY;
+        default:
+            return state;
+        }
+    }
+
+    struct ThreatResult
+    {
+        long activeMs;    // First ACTIVE_DETERRENT or EMERGENCY, -1 if never
+        long emergencyMs; // First EMERGENCY, -1 if never
+        long contactMs;   // First bird at BENCH_CONTACT_CM, -1 if none
+        int escalations;  // Entries into ACTIVE_DETERRENT or EMERGENCY
+        int stateChanges;
+    };
+
+    // Replays a scenario through the tracker with noisy, time-sliced echoes
+    // and runs one policy at the control-task rate. policy == nullptr runs
+    // ThreatAssessment and SystemStateMachine.
+    ThreatResult runThreatScenario(const ThreatScenario &scenario, const RangePolicy *policy)
+    {
+        const float azimuths[BENCH_THREAT_SENSORS] = {0.0, 270.0, 90.0};
+        ThreatResult result = {-1, -1, -1, 0, 0};
+
+        BirdObject pool[MAX_TRACKED_BIRDS];
+        BirdTracker tracker(pool, MAX_TRACKED_BIRDS);
+        ThreatAssessment assessment;
+        SystemStateMachine machine;
+        SystemState state = STANDBY;
+        randomSeed(25);
+
+        // Offset so the tracker never sees timestamp 0
+        const unsigned long base = 1000;
+        for (unsigned long t = 0; t < scenario.durationMs; t += BENCH_THREAT_STEP_MS)
+        {
+            unsigned long now = base + t;
+            if (t % BENCH_THREAT_SLOT_MS < BENCH_THREAT_STEP_MS * BENCH_THREAT_SENSORS)
+            {
+                int sensor = (t % BENCH_THREAT_SLOT_MS) / BENCH_THREAT_STEP_MS;
+                TrackMeasurement measurements[1];
+                int measurementCount = 0;
+                for (int b = 0; b < scenario.birdCount; b++)
+                {
+                    const ThreatBird &bird = scenario.birds[b];
+                    float range = threatBirdDistanceCm(bird, t) + random(-BENCH_THREAT_NOISE_CM, BENCH_THREAT_NOISE_CM + 1);
+                    if (bird.sensor != sensor || range < MIN_BIRD_SIZE_CM || range > RANGING_MAX_RANGE_CM)
+                        continue;
+
+                    measurements[0].range = range;
+                    measurements[0].azimuth = azimuths[sensor];
+                    measurements[0].sensorIndex = sensor;
+                    measurements[0].timestamp = now;
+                    measurementCount = 1;
+                }
+                tracker.update(measurements, measurementCount, now);
+            }
+
+            for (int b = 0; b < scenario.birdCount && result.contactMs < 0; b++)
+            {
+                if (threatBirdDistanceCm(scenario.birds[b], t) <= BENCH_CONTACT_CM)
+                {
+                    result.contactMs = t;
+                }
+            }
+
+            if (t % BENCH_THREAT_CONTROL_MS != 0)
+                continue;
+            // As BirdDetection does between readings
+            tracker.removeStaleTracks(now);
+
+            SystemState next;
+            if (policy == nullptr)
+            {
+                ThreatLevel level = assessment.update(tracker.getTrack(0), tracker.getTrackCount(), now);
+                if (machine.isTimedOut(now))
+                {
+                    machine.dispatch(EVENT_STATE_TIMEOUT, now);
+                }
+                machine.dispatch(SystemStateMachine::threatEvent(level), now);
+                next = machine.getState();
+            }
+            else
+            {
+                next = stepRangePolicy(*policy, state, tracker.getTrack(0), tracker.getTrackCount());
+            }
+
+            if (next == state)
+                continue;
+            result.stateChanges++;
+            if (next > state && (next == ACTIVE_DETERRENT || next == EMERGENCY))
+            {
+                result.escalations++;
+                if (result.activeMs < 0)
+                {
+                    result.activeMs = t;
+                }
+            }
+            if (next == EMERGENCY && result.emergencyMs < 0)
+            {
+                result.emergencyMs = t;
+            }
+            state = next;
+        }
+        return result;
+    }
+
+    // Milliseconds an event came before contact, or the raw time if there
+    // was no contact; "-" if the event never happened
+    void printThreatTime(long eventMs, long contactMs)
+    {
+        if (eventMs < 0)
+        {
+            printf(" %11s", "-");
+        }
+        else
+        {
+            printf(" %11ld", contactMs >= 0 ? contactMs - eventMs : eventMs);
+        }
+    }
+
+    bool benchThreat()
+    {
+        printf("== threat: scripted scenarios through the tracker, %d Hz control ==\n", CONTROL_UPDATE_FREQUENCY_HZ);
+        printf("(lead = ms before contact; with no contact, ms after the scenario started)\n");
+        printf("%-18s %-8s %10s %11s %11s %8s %8s\n", "scenario", "policy", "contact ms", "active lead",
+               "emerg. lead", "escal.", "changes");
+
+        const RangePolicy *policies[3] = {&shippedPolicy, &rangePolicy, nullptr};
+        const char *names[3] = {"shipped", "range", "ttc"};
+        ThreatResult results[threatScenarioCount][3];
+        for (int s = 0; s < threatScenarioCount; s++)
+        {
+            for (int p = 0; p < 3; p++)
+            {
+                ThreatResult &r = results[s][p];
+                r = runThreatScenario(threatScenarios[s], policies[p]);
+                printf("%-18s %-8s", p == 0 ? threatScenarios[s].name : "", names[p]);
+                if (r.contactMs < 0)
+                {
+                    printf(" %10s", "-");
+                }
+                else
+                {
+                    printf(" %10ld", r.contactMs);
+                }
+                printThreatTime(r.activeMs, r.contactMs);
+                printThreatTime(r.emergencyMs, r.contactMs);
+                printf(" %8d %8d\n", r.escalations, r.stateChanges);
+            }
+        }
+
+        // Against the range policy: approaches met at least 200 ms sooner,
+        // the flock's emergency declared sooner, no escalation for birds that
+        // are not coming in, and a hovering bird taken up to ACTIVE_DETERRENT
+        // and back down once (four changes) where shipped logic flapped
+        const ThreatResult *fast = results[0];
+        const ThreatResult *slow = results[1];
+        const ThreatResult *hover = results[2];
+        const ThreatResult *loiter = results[3];
+        const ThreatResult *leaving = results[4];
+        const ThreatResult *flock = results[5];
+        bool earlier = fast[2].activeMs >= 0 && fast[2].activeMs + 200 <= fast[1].activeMs &&
+                       slow[2].activeMs >= 0 && slow[2].activeMs + 200 <= slow[1].activeMs;
+        bool flockEarlier = flock[2].emergencyMs >= 0 &&
+                            (flock[1].emergencyMs < 0 || flock[2].emergencyMs < flock[1].emergencyMs);
+        bool calmer = loiter[2].escalations == 0 && leaving[2].escalations < leaving[1].escalations &&
+                      hover[2].stateChanges <= 4 && hover[2].stateChanges < hover[0].stateChanges;
+        bool passed = earlier && flockEarlier && calmer;
+        printf("threat: %s\n", passed ? "PASS" : "FAIL");
+        return passed;
+    }
+
+    struct Benchmark
+    {
+        const char *name;
+        bool (*run)();
+    };
+
+    const Benchmark benchmarks[] = {
+        {"tracker", benchTracker},
+        {"median", benchMedian},
+        {"ring", benchRing},
+        {"slots", benchSlots},
+        {"latency", benchLatency},
+        {"audio", benchAudio},
+        {"footprint", benchFootprint},
+        {"perf", benchPerf},
+        {"telemetry", benchTelemetry},
+        {"events", benchEvents},
+        {"strobe", benchStrobe},
+        {"leds", benchLeds},
+        {"thermal", benchThermal},
+        {"brightness", benchBrightness},
+        {"targeting", benchTargeting},
+        {"threat", benchThreat},
+    };
+}
+
+int main(int argc, char **argv)
+{
+    int count = sizeof(benchmarks) / sizeof(benchmarks[0]);
+    bool ranAny = false;
+    bool allPassed = true;
+
+    for (int i = 0; i < count; i++)
+    {
+        bool selected = argc < 2;
+        for (int a = 1; a < argc; a++)
+        {
+            if (strcmp(argv[a], benchmarks[i].name) == 0)
+                selected = true;
+        }
+        if (selected)
+        {
+            allPassed = benchmarks[i].run() && allPassed;
+            ranAny = true;
+        }
+    }
+
+    if (!ranAny)
+    {
+        fprintf(stderr, "usage: %s [benchmark...]\navailable:", argv[0]);
+        for (int i = 0; i < count; i++)
+        {
+            fprintf(stderr, " %s", benchmarks[i].name);
+        }
+        fprintf(stderr, "\n");
+        return 2;
+    }
+    return allPassed ? 0 : 1;
+}
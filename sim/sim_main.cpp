@@ -0,0 +1,221 @@
+// Deterministic host simulation of the full sketch. Runs setup() once and then
+// loop() for a span of virtual time (or a number of loop() passes), with a
+// scripted bird approaching the front sensor, and reports per-pass CPU cost
+// and the scheduler's per-task and per-subsystem timing statistics.
+// Exits non-zero if BirdDetection::update() was ever starved for longer than
+// DETECTION_UPDATE_GAP_LIMIT_US, if anything allocated from the heap after
+// setup(), or if telemetry was lost across the scripted link outage.
+
+#include <Arduino.h>
+#include "SimHal.h"
+#include "config.h"
+
+// Single translation unit with the sketch so its globals are reachable here
+#include "bird_detterent.ino.cpp"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#define SIM_DEFAULT_SECONDS 1000
+#define SIM_SOUND_US_PER_CM 58.3 // Round-trip echo time per centimetre
+#define SIM_LINK_OUTAGE_START_S 300.0
+#define SIM_LINK_OUTAGE_S 30.0 // Within TELEMETRY_OUTAGE_RETENTION_S, so nothing may be lost
+#define SIM_LINK_OUTAGE_SLACK_S (MAX_TELEMETRY_QUEUE / (double)TELEMETRY_UPDATE_FREQUENCY_HZ) // Unpacked in the ring
+#define SIM_CONSOLE_AT_S 500.0   // Every console report is requested once mid-run
+#define SIM_CONSOLE_COMMANDS "tpsd"
+
+namespace
+{
+    // Bird starts 3.5 m out, closes to 0.2 m over 20 s, then flees.
+    float scenarioBirdDistanceCm(uint64_t timeUs)
+    {
+        double t = (timeUs / 1000000.0);
+        double cycle = fmod(t, 40.0);
+        if (cycle < 20.0)
+            return (float)(350.0 - cycle * 16.5);
+        return (float)(20.0 + (cycle - 20.0) * 16.5);
+    }
+
+    unsigned long frontEcho(uint64_t timeUs)
+    {
+        float distance = scenarioBirdDistanceCm(timeUs);
+        return (unsigned long)(distance * SIM_SOUND_US_PER_CM);
+    }
+
+    unsigned long noEcho(uint64_t timeUs)
+    {
+        (void)timeUs;
+        return 0;
+    }
+
+    void configureScenario()
+    {
+        SimHal::reset();
+        SimHal::setRecordAnalogWrites(false);
+        SimHal::attachEchoScript(TRIG_PIN_1, ECHO_PIN_1, frontEcho);
+        SimHal::attachEchoScript(TRIG_PIN_2, ECHO_PIN_2, noEcho);
+        SimHal::attachEchoScript(TRIG_PIN_3, ECHO_PIN_3, noEcho);
+
+        SimHal::setAnalogInput(BATTERY_VOLTAGE_PIN, 767);    // ~12.6 V
+        SimHal::setAnalogInput(TEMPERATURE_SENSOR_PIN, 358); // ~35 C
+        SimHal::setAnalogInput(LIGHT_SENSOR_PIN, 512);
+        SimHal::setAnalogInput(WIND_SPEED_PIN, 100);
+        WiFi.setStatus(WL_CONNECTED);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    long ticks = -1;
+    double seconds = SIM_DEFAULT_SECONDS;
+    bool verbose = false;
+    const char *capturePath = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc)
+        {
+            ticks = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+        {
+            seconds = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc)
+        {
+            capturePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--verbose") == 0)
+        {
+            verbose = true;
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [--seconds S] [--ticks N] [--capture FILE] [--verbose]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    configureScenario();
+    SimHal::setSerialEcho(verbose);
+    SimHal::setSerialCapture(capturePath != nullptr);
+
+    setup();
+    SimHal::HeapStats setupHeap = SimHal::getHeapStats();
+    SimHal::resetHeapPeak();
+    bool consoleSent = false;
+
+    std::vector<double> tickCostUs;
+    uint64_t simStartUs = SimHal::nowMicros();
+    uint64_t simEndUs = simStartUs + (uint64_t)(seconds * 1000000.0);
+    birdDetector.resetUpdateGap();
+    scheduler.resetStatistics();
+    perfResetAll();
+    int stateChanges = 0;
+    SystemState lastState = currentState;
+
+    std::chrono::steady_clock::time_point wallStart = std::chrono::steady_clock::now();
+    for (long tick = 0; ticks < 0 ? SimHal::nowMicros() < simEndUs : tick < ticks; tick++)
+    {
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        loop();
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        tickCostUs.push_back(std::chrono::duration<double, std::micro>(end - begin).count());
+
+        double simNow = (SimHal::nowMicros() - simStartUs) / 1000000.0;
+        bool linkDown = simNow >= SIM_LINK_OUTAGE_START_S && simNow < SIM_LINK_OUTAGE_START_S + SIM_LINK_OUTAGE_S;
+        WiFi.setStatus(linkDown ? WL_DISCONNECTED : WL_CONNECTED);
+        if (!consoleSent && simNow >= SIM_CONSOLE_AT_S)
+        {
+            SimHal::injectSerialInput(SIM_CONSOLE_COMMANDS);
+            consoleSent = true;
+        }
+
+        if (currentState != lastState)
+        {
+            stateChanges++;
+            lastState = currentState;
+        }
+    }
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    double simSeconds = (SimHal::nowMicros() - simStartUs) / 1000000.0;
+
+    std::vector<double> sorted = tickCostUs;
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0;
+    for (size_t i = 0; i < sorted.size(); i++)
+    {
+        total += sorted[i];
+    }
+
+    unsigned long maxGapUs = birdDetector.getMaxUpdateGapUs();
+    bool gapOk = maxGapUs <= DETECTION_UPDATE_GAP_LIMIT_US;
+
+    printf("loop passes       : %zu\n", tickCostUs.size());
+    printf("simulated time    : %.1f s\n", simSeconds);
+    printf("wall time         : %.3f s (%.0fx real time)\n", wallSeconds, wallSeconds > 0 ? simSeconds / wallSeconds : 0.0);
+    if (!sorted.empty())
+    {
+        printf("tick cost mean    : %.2f us\n", total / sorted.size());
+        printf("tick cost p99     : %.2f us\n", sorted[(size_t)(sorted.size() * 0.99)]);
+        printf("tick cost max     : %.2f us\n", sorted.back());
+    }
+    printf("state transitions : %d\n", stateChanges);
+    printf("final state       : %s\n", getStateString(currentState));
+    unsigned long overruns = 0;
+    for (int i = 0; i < scheduler.getTaskCount(); i++)
+    {
+        overruns += scheduler.getTask(i)->stats.overruns;
+    }
+    printf("task overruns     : %lu\n", overruns);
+    printf("idle time         : %.1f%%\n", simSeconds > 0 ? scheduler.getIdleUs() / (simSeconds * 10000.0) : 0.0);
+    bool telemetryOk = telemetryQueue.getOverflowCount() == 0 && telemetryBacklog.getDroppedSamples() == 0;
+    // A run that ends before the link returns never exercised the backlog;
+    // one that covers the outage must have held most of it
+    bool outageCovered = simSeconds >= SIM_LINK_OUTAGE_START_S + SIM_LINK_OUTAGE_S;
+    if (outageCovered)
+    {
+        telemetryOk = telemetryOk && telemetryBacklog.getStoredSamples() > 0 &&
+                      telemetryBacklog.getPeakSpanMs() / 1000.0 >= SIM_LINK_OUTAGE_S - SIM_LINK_OUTAGE_SLACK_S;
+    }
+    printf("telemetry samples : %lu queued, %lu released, %lu overflowed\n", telemetryQueue.getPushedCount(),
+           telemetryQueue.getSentCount(), telemetryQueue.getOverflowCount());
+    printf("telemetry backlog : %lu samples stored, %lu sent, %lu dropped; held %.1f s of %.0f s outage "
+           "(peak %zu of %zu bytes) %s\n",
+           telemetryBacklog.getStoredSamples(), telemetryBacklog.getSentSamples(),
+           telemetryBacklog.getDroppedSamples(), telemetryBacklog.getPeakSpanMs() / 1000.0, SIM_LINK_OUTAGE_S,
+           telemetryBacklog.getPeakBytes(), telemetryBacklog.capacity(),
+           !telemetryOk ? "FAIL" : outageCovered ? "PASS" : "not exercised");
+    printf("track events      : %lu sent in %lu frames (%lu bytes), %lu coalesced, %lu deferred\n",
+           trackEvents.getEventsSent(), trackEvents.getFramesSent(), trackEvents.getBytesSent(),
+           trackEvents.getEventsCoalesced(), trackEvents.getEventsDeferred());
+    SimHal::HeapStats runHeap = SimHal::getHeapStats();
+    bool heapOk = heapGuardGetViolations() == 0;
+    printf("heap              : peak %zu bytes in setup; after setup %lu allocations, peak %zu bytes %s\n",
+           setupHeap.peak, runHeap.allocations, runHeap.peak, heapOk ? "PASS" : "FAIL");
+    printf("max detection gap : %.2f ms (limit %.2f ms) %s\n", maxGapUs / 1000.0,
+           DETECTION_UPDATE_GAP_LIMIT_US / 1000.0, gapOk ? "PASS" : "FAIL");
+
+    if (capturePath != nullptr)
+    {
+        // Raw serial stream, binary telemetry frames and text interleaved
+        FILE *capture = fopen(capturePath, "wb");
+        if (capture == nullptr)
+        {
+            fprintf(stderr, "cannot write %s\n", capturePath);
+            return 2;
+        }
+        const std::string &output = SimHal::getSerialOutput();
+        fwrite(output.data(), 1, output.size(), capture);
+        fclose(capture);
+    }
+
+    SimHal::setSerialEcho(true);
+    scheduler.printStatistics();
+    perfPrintReport();
+    return gapOk && heapOk && telemetryOk ? 0 : 1;
+}
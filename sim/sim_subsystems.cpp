@@ -0,0 +1,242 @@
+// Host models for the subsystems whose firmware sources are not part of this
+// tree (power management, weather protection, emergency handling). They read
+// the same analog pins as the real hardware so scenarios can script them.
+
+#include "power_management.h"
+#include "weather_protection.h"
+#include "emergency_system.h"
+#include "buffer_print.h"
+#include "config.h"
+
+// ==================== POWER MANAGEMENT ====================
+
+PowerManagement::PowerManagement()
+{
+    currentMode = POWER_NORMAL;
+    lowPowerMode = false;
+    emergencyShutdown = false;
+    voltageHistoryIndex = 0;
+    lastMetricsUpdate = 0;
+    systemStartTime = 0;
+    metrics = PowerMetrics();
+    for (int i = 0; i < POWER_SAMPLES; i++)
+    {
+        voltageHistory[i] = 0.0;
+    }
+}
+
+bool PowerManagement::begin()
+{
+    systemStartTime = millis();
+    return true;
+}
+
+void PowerManagement::update()
+{
+    metrics.batteryVoltage = getBatteryVoltage();
+    metrics.temperature = getTemperature();
+}
+
+float PowerManagement::getBatteryVoltage()
+{
+    return analogRead(BATTERY_VOLTAGE_PIN) * (BATTERY_MAX_VOLTAGE_V / 1023.0);
+}
+
+float PowerManagement::getTemperature()
+{
+    return analogRead(TEMPERATURE_SENSOR_PIN) * (100.0 / 1023.0);
+}
+
+void PowerManagement::setLowPowerMode(bool enabled)
+{
+    lowPowerMode = enabled;
+    currentMode = enabled ? POWER_LOW : POWER_NORMAL;
+}
+
+bool PowerManagement::isLowPowerMode()
+{
+    return lowPowerMode;
+}
+
+PowerMode PowerManagement::getCurrentMode()
+{
+    return currentMode;
+}
+
+bool PowerManagement::selfTest()
+{
+    return getBatteryVoltage() > BATTERY_MIN_VOLTAGE;
+}
+
+// ==================== WEATHER PROTECTION ====================
+
+WeatherProtection::WeatherProtection()
+{
+    currentWeather = WeatherData();
+    enclosureStatus = EnclosureStatus();
+    currentMode = PROTECTION_NORMAL;
+    systemEnabled = true;
+    lastWeatherUpdate = 0;
+    lastEnclosureCheck = 0;
+    weatherCritical = false;
+}
+
+bool WeatherProtection::begin()
+{
+    return true;
+}
+
+void WeatherProtection::update()
+{
+    unsigned long currentTime = millis();
+    if (currentTime - lastWeatherUpdate < WEATHER_UPDATE_INTERVAL_MS)
+        return;
+
+    currentWeather.temperature = analogRead(TEMPERATURE_SENSOR_PIN) * (100.0 / 1023.0) - 20.0;
+    currentWeather.humidity = analogRead(HUMIDITY_SENSOR_PIN) * (100.0 / 1023.0);
+    currentWeather.windSpeed = analogRead(WIND_SPEED_PIN) * (40.0 / 1023.0);
+    currentWeather.precipitation = analogRead(PRECIPITATION_PIN) / 1023.0;
+    currentWeather.lightLevel = analogRead(LIGHT_SENSOR_PIN) / 1023.0;
+    currentWeather.timestamp = currentTime;
+
+    weatherCritical = currentWeather.windSpeed > CRITICAL_WIND_SPEED ||
+                      currentWeather.temperature > CRITICAL_TEMP_HIGH ||
+                      currentWeather.temperature < CRITICAL_TEMP_LOW;
+    currentWeather.criticalWeather = weatherCritical;
+    currentWeather.condition = weatherCritical ? WEATHER_EXTREME : WEATHER_CLEAR;
+
+    lastWeatherUpdate = currentTime;
+}
+
+WeatherData WeatherProtection::getWeatherData()
+{
+    return currentWeather;
+}
+
+bool WeatherProtection::isWeatherCritical()
+{
+    return weatherCritical;
+}
+
+WeatherCondition WeatherProtection::getCurrentCondition()
+{
+    return currentWeather.condition;
+}
+
+const char *WeatherProtection::getWeatherStatus()
+{
+    return weatherCritical ? "CRITICAL" : "NORMAL";
+}
+
+bool WeatherProtection::selfTest()
+{
+    return true;
+}
+
+// ==================== EMERGENCY SYSTEM ====================
+
+EmergencySystem::EmergencySystem()
+{
+    servoPin = -1;
+    currentState = EMERGENCY_IDLE;
+    activeReason = "";
+    activationTime = 0;
+    activationCount = 0;
+    healthIssueCount = 0;
+}
+
+bool EmergencySystem::begin(int pin)
+{
+    servoPin = pin;
+    pinMode(servoPin, OUTPUT);
+    return true;
+}
+
+void EmergencySystem::update()
+{
+    if (currentState == EMERGENCY_ACTIVE && millis() - activationTime > EMERGENCY_TIMEOUT_MS)
+    {
+        currentState = EMERGENCY_RECOVERING;
+    }
+}
+
+void EmergencySystem::activateEmergencyMode(const char *reason)
+{
+    if (currentState == EMERGENCY_ACTIVE)
+        return;
+
+    activeReason = reason;
+    activationTime = millis();
+    activationCount++;
+    currentState = activationCount > MAX_EMERGENCY_ACTIVATIONS ? EMERGENCY_LOCKOUT : EMERGENCY_ACTIVE;
+}
+
+bool EmergencySystem::isEmergencyResolved()
+{
+    if (currentState == EMERGENCY_RECOVERING)
+    {
+        currentState = EMERGENCY_IDLE;
+        return true;
+    }
+    return false;
+}
+
+void EmergencySystem::reportHealthIssue(const char *issue)
+{
+    for (int i = 0; i < healthIssueCount; i++)
+    {
+        if (strcmp(healthIssues[i].code, issue) == 0)
+        {
+            healthIssues[i].lastReported = millis();
+            healthIssues[i].occurrences++;
+            return;
+        }
+    }
+
+    if (healthIssueCount < MAX_HEALTH_ISSUES)
+    {
+        HealthIssue &entry = healthIssues[healthIssueCount++];
+        entry.code = issue;
+        entry.firstReported = millis();
+        entry.lastReported = entry.firstReported;
+        entry.occurrences = 1;
+    }
+}
+
+void EmergencySystem::clearHealthIssues()
+{
+    healthIssueCount = 0;
+}
+
+const char *EmergencySystem::getHealthStatus(char *buffer, size_t size)
+{
+    BufferPrint out(buffer, size);
+    if (healthIssueCount == 0)
+    {
+        out.print("OK");
+        return buffer;
+    }
+    out.print("ISSUES:");
+    out.print(healthIssueCount);
+    return buffer;
+}
+
+int EmergencySystem::getHealthIssueCount()
+{
+    return healthIssueCount;
+}
+
+EmergencyState EmergencySystem::getCurrentState()
+{
+    return currentState;
+}
+
+int EmergencySystem::getActivationCount()
+{
+    return activationCount;
+}
+
+bool EmergencySystem::selfTest()
+{
+    return servoPin >= 0;
+}
@@ -0,0 +1,250 @@
+#include "strobe_sequencer.h"
+
+static_assert(MAX_LED_CHANNELS <= 16, "Channel mask is 16 bits");
+static_assert(STROBE_MAX_EDGES >= MAX_LED_CHANNELS, "A sweep needs one edge per channel");
+
+StrobeSequencer::StrobeSequencer()
+{
+    activeProgram = 0;
+    swapPending = false;
+    swapAtCycleEnd = false;
+    playing = false;
+    cyclesDone = 0;
+    channelMask = 0xFFFF;
+    driver = nullptr;
+    channelCount = 0;
+    position = 0;
+    nextEdge = 0;
+    lastPollMs = 0;
+
+    for (int p = 0; p < 2; p++)
+    {
+        programs[p].edgeCount = 0;
+        programs[p].cycleMs = 0;
+    }
+    memset(commanded, 0, sizeof(commanded));
+    memset(frame, 0, sizeof(frame));
+    memset(scales, 255, sizeof(scales));
+    memset(commandedLevelMs, 0, sizeof(commandedLevelMs));
+    memset(outputLevelMs, 0, sizeof(outputLevelMs));
+    lastAccountMs = 0;
+}
+
+void StrobeSequencer::begin(LedDriver *output)
+{
+    driver = output;
+    channelCount = output != nullptr ? output->getChannelCount() : 0;
+}
+
+StrobeProgram *StrobeSequencer::editProgram()
+{
+    // As with DdsSynthesizer, a commit the interrupt has not picked up yet is
+    // withdrawn so the back program is never read while being rewritten
+    noInterrupts();
+    swapPending = false;
+    interrupts();
+
+    return &programs[activeProgram ^ 1];
+}
+
+void StrobeSequencer::commitProgram(bool restart)
+{
+    noInterrupts();
+    swapAtCycleEnd = !restart && playing;
+    swapPending = true;
+    lastPollMs = millis();
+    interrupts();
+}
+
+void StrobeSequencer::silence()
+{
+    static const uint8_t dark[MAX_LED_CHANNELS] = {};
+
+    noInterrupts();
+    swapPending = false;
+    playing = false;
+    writeLevels(dark);
+    interrupts();
+}
+
+// Direct output for the main loop (ramps, self tests) while no program
+// plays; scale and mask still apply
+void StrobeSequencer::showFrame(const uint8_t *levels)
+{
+    if (isPlaying())
+        return;
+
+    noInterrupts();
+    writeLevels(levels);
+    interrupts();
+}
+
+// Closes the interval since the last change; levels only move at edges, so
+// this costs nothing per tick
+void StrobeSequencer::accountLevels()
+{
+    unsigned long now = millis();
+    uint32_t elapsed = now - lastAccountMs;
+    lastAccountMs = now;
+
+    for (int i = 0; i < channelCount; i++)
+    {
+        commandedLevelMs[i] += commanded[i] * elapsed;
+        outputLevelMs[i] += frame[i] * elapsed;
+    }
+}
+
+void StrobeSequencer::writeLevels(const uint8_t *target)
+{
+    accountLevels();
+
+    bool changed = false;
+    for (int i = 0; i < channelCount; i++)
+    {
+        commanded[i] = target[i];
+        uint8_t level = (channelMask >> i) & 1 ? (target[i] * (scales[i] + 1)) >> 8 : 0;
+        changed = changed || level != frame[i];
+        frame[i] = level;
+    }
+
+    if (changed && driver != nullptr)
+    {
+        driver->commitFrame(frame);
+    }
+}
+
+// Interrupt context
+void StrobeSequencer::tick()
+{
+    if (swapPending && (!swapAtCycleEnd || position == 0))
+    {
+        activeProgram ^= 1;
+        swapPending = false;
+        playing = programs[activeProgram].edgeCount > 0;
+        position = 0;
+        nextEdge = 0;
+    }
+
+    if (!playing)
+        return;
+
+    const StrobeProgram &program = programs[activeProgram];
+    if (nextEdge < program.edgeCount && program.edges[nextEdge].atMs == position)
+    {
+        writeLevels(program.edges[nextEdge].levels);
+        nextEdge++;
+    }
+
+    if (++position >= program.cycleMs)
+    {
+        position = 0;
+        nextEdge = 0;
+        cyclesDone++;
+    }
+}
+
+// Fallback where no timer backend exists: catches up on the ticks since the
+// last call, so edges keep their order but land as late as the loop runs
+void StrobeSequencer::poll(unsigned long nowMs)
+{
+    if (!isPlaying())
+    {
+        lastPollMs = nowMs;
+        return;
+    }
+
+    while (lastPollMs != nowMs)
+    {
+        lastPollMs++;
+        tick();
+    }
+}
+
+bool StrobeSequencer::isPlaying()
+{
+    return playing || swapPending;
+}
+
+bool StrobeSequencer::isSwapPending()
+{
+    return swapPending;
+}
+
+// Masking and scaling take effect at once; the pattern itself plays on
+// unchanged
+void StrobeSequencer::setChannelMask(uint16_t mask)
+{
+    noInterrupts();
+    channelMask = mask;
+    writeLevels(commanded);
+    interrupts();
+}
+
+uint16_t StrobeSequencer::getChannelMask()
+{
+    return channelMask;
+}
+
+void StrobeSequencer::setChannelScales(const uint8_t *channelScales)
+{
+    noInterrupts();
+    memcpy(scales, channelScales, channelCount);
+    writeLevels(commanded);
+    interrupts();
+}
+
+// Level-milliseconds per channel since the last call, as commanded by the
+// pattern and as output after scale and mask. 255 * elapsed ms is 100 %.
+void StrobeSequencer::drainLevelMs(uint32_t *commandedOut, uint32_t *outputOut)
+{
+    noInterrupts();
+    accountLevels();
+    for (int i = 0; i < channelCount; i++)
+    {
+        commandedOut[i] = commandedLevelMs[i];
+        outputOut[i] = outputLevelMs[i];
+        commandedLevelMs[i] = 0;
+        outputLevelMs[i] = 0;
+    }
+    interrupts();
+}
+
+int StrobeSequencer::getChannelCount()
+{
+    return channelCount;
+}
+
+uint8_t StrobeSequencer::getLevel(int channel)
+{
+    return channel >= 0 && channel < channelCount ? frame[channel] : 0;
+}
+
+uint32_t StrobeSequencer::getCyclesDone()
+{
+    return cyclesDone;
+}
+
+// Appends a step of the given length, merging it into the previous one when
+// the frame is unchanged. stepLevels holds MAX_LED_CHANNELS levels, unused
+// channels zero. Zero-length steps are dropped.
+bool StrobeSequencer::appendStep(StrobeProgram &program, uint16_t durationMs, const uint8_t *stepLevels)
+{
+    if (durationMs == 0)
+        return true;
+
+    if (program.edgeCount > 0 &&
+        memcmp(program.edges[program.edgeCount - 1].levels, stepLevels, MAX_LED_CHANNELS) == 0)
+    {
+        program.cycleMs += durationMs;
+        return true;
+    }
+
+    if (program.edgeCount >= STROBE_MAX_EDGES)
+        return false;
+
+    StrobeEdge &edge = program.edges[program.edgeCount++];
+    edge.atMs = program.cycleMs;
+    memcpy(edge.levels, stepLevels, MAX_LED_CHANNELS);
+    program.cycleMs += durationMs;
+    return true;
+}
@@ -0,0 +1,85 @@
+#ifndef STROBE_SEQUENCER_H
+#define STROBE_SEQUENCER_H
+
+#include <Arduino.h>
+#include "led_driver.h"
+
+#define STROBE_MAX_EDGES 16
+#define STROBE_TICK_HZ 1000 // Edge resolution: one tick per millisecond
+
+// The frame that holds from atMs until the next edge
+struct StrobeEdge
+{
+    uint16_t atMs; // Offset into the cycle
+    uint8_t levels[MAX_LED_CHANNELS];
+};
+
+// A compiled strobe pattern: edges in time order, the first at 0, repeated
+// every cycleMs for as long as the program is active.
+struct StrobeProgram
+{
+    StrobeEdge edges[STROBE_MAX_EDGES];
+    uint8_t edgeCount;
+    uint16_t cycleMs;
+};
+
+// Plays compiled strobe programs from a millisecond timer interrupt, so
+// flash timing depends on the tick only and not on how long the main loop
+// takes. An edge costs a compare and, when the frame changes, one commit to
+// the LED driver; every other tick is a counter increment. Programs are
+// double-buffered like DdsSynthesizer's: the main loop fills the back
+// program and commits it, either restarting on the next tick or taking over
+// when the running cycle ends, so a re-rolled pattern continues without a
+// timing seam.
+//
+// Each channel has an output scale (thermal derating) and a mask bit (hard
+// cut) applied on the way out, so neither needs the pattern recompiled. The
+// level-milliseconds the pattern asked for and those actually output are
+// accumulated per channel for the thermal model.
+class StrobeSequencer
+{
+private:
+    StrobeProgram programs[2];
+    volatile uint8_t activeProgram;
+    volatile bool swapPending;
+    volatile bool swapAtCycleEnd;
+    volatile bool playing;
+    uint8_t commanded[MAX_LED_CHANNELS]; // As the pattern has it
+    uint8_t frame[MAX_LED_CHANNELS];     // As last committed, after scale and mask
+    uint8_t scales[MAX_LED_CHANNELS];    // 255 is full output
+    uint32_t commandedLevelMs[MAX_LED_CHANNELS];
+    uint32_t outputLevelMs[MAX_LED_CHANNELS];
+    unsigned long lastAccountMs;
+    volatile uint32_t cyclesDone;
+    volatile uint16_t channelMask;
+    LedDriver *driver;
+    int channelCount;
+    uint16_t position;
+    uint8_t nextEdge;
+    unsigned long lastPollMs;
+
+    void writeLevels(const uint8_t *target);
+    void accountLevels();
+
+public:
+    StrobeSequencer();
+    void begin(LedDriver *output);
+    StrobeProgram *editProgram();
+    void commitProgram(bool restart);
+    void silence();
+    void showFrame(const uint8_t *levels);
+    void tick();
+    void poll(unsigned long nowMs);
+    bool isPlaying();
+    bool isSwapPending();
+    void setChannelMask(uint16_t mask);
+    uint16_t getChannelMask();
+    void setChannelScales(const uint8_t *channelScales);
+    void drainLevelMs(uint32_t *commandedOut, uint32_t *outputOut);
+    int getChannelCount();
+    uint8_t getLevel(int channel);
+    uint32_t getCyclesDone();
+    static bool appendStep(StrobeProgram &program, uint16_t durationMs, const uint8_t *stepLevels);
+};
+
+#endif
@@ -0,0 +1,87 @@
+#include "strobe_timer.h"
+
+#ifdef SIM_HAL
+#include "SimHal.h"
+#endif
+
+void (*volatile StrobeTimer::callback)() = nullptr;
+bool StrobeTimer::running = false;
+
+bool StrobeTimer::start(uint32_t rateHz, void (*isr)())
+{
+    if (rateHz == 0 || isr == nullptr)
+        return false;
+
+    callback = isr;
+
+#if defined(ARDUINO_ARCH_SAMD)
+    GCLK->CLKCTRL.reg = (uint16_t)(GCLK_CLKCTRL_CLKEN | GCLK_CLKCTRL_GEN_GCLK0 | GCLK_CLKCTRL_ID(GCM_TC4_TC5));
+    while (GCLK->STATUS.bit.SYNCBUSY)
+        ;
+
+    TC4->COUNT16.CTRLA.reg = TC_CTRLA_SWRST;
+    while (TC4->COUNT16.STATUS.reg & TC_STATUS_SYNCBUSY)
+        ;
+    while (TC4->COUNT16.CTRLA.bit.SWRST)
+        ;
+
+    // 48 MHz / 1 kHz does not fit 16 bits, so count at GCLK0 / 64
+    TC4->COUNT16.CTRLA.reg = TC_CTRLA_MODE_COUNT16 | TC_CTRLA_WAVEGEN_MFRQ | TC_CTRLA_PRESCALER_DIV64;
+    TC4->COUNT16.CC[0].reg = (uint16_t)(SystemCoreClock / 64 / rateHz - 1);
+    while (TC4->COUNT16.STATUS.reg & TC_STATUS_SYNCBUSY)
+        ;
+
+    NVIC_DisableIRQ(TC4_IRQn);
+    NVIC_ClearPendingIRQ(TC4_IRQn);
+    NVIC_SetPriority(TC4_IRQn, 1);
+    NVIC_EnableIRQ(TC4_IRQn);
+
+    TC4->COUNT16.INTENSET.bit.MC0 = 1;
+    TC4->COUNT16.CTRLA.reg |= TC_CTRLA_ENABLE;
+    while (TC4->COUNT16.STATUS.reg & TC_STATUS_SYNCBUSY)
+        ;
+    running = true;
+#elif defined(SIM_HAL)
+    SimHal::attachTimer(rateHz, &StrobeTimer::handleInterrupt, SimHal::TIMER_STROBE);
+    running = true;
+#else
+    running = false;
+#endif
+
+    return running;
+}
+
+void StrobeTimer::stop()
+{
+#if defined(ARDUINO_ARCH_SAMD)
+    TC4->COUNT16.CTRLA.reg &= ~TC_CTRLA_ENABLE;
+    while (TC4->COUNT16.STATUS.reg & TC_STATUS_SYNCBUSY)
+        ;
+    NVIC_DisableIRQ(TC4_IRQn);
+#elif defined(SIM_HAL)
+    SimHal::detachTimer(SimHal::TIMER_STROBE);
+#endif
+    running = false;
+}
+
+bool StrobeTimer::isRunning()
+{
+    return running;
+}
+
+void StrobeTimer::handleInterrupt()
+{
+    void (*isr)() = callback;
+    if (isr != nullptr)
+    {
+        isr();
+    }
+}
+
+#if defined(ARDUINO_ARCH_SAMD)
+void TC4_Handler()
+{
+    StrobeTimer::handleInterrupt();
+    TC4->COUNT16.INTFLAG.bit.MC0 = 1;
+}
+#endif
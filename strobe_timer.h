@@ -0,0 +1,24 @@
+#ifndef STROBE_TIMER_H
+#define STROBE_TIMER_H
+
+#include <Arduino.h>
+
+// Millisecond tick for the strobe sequencer. On SAMD boards this is TC4 in
+// match-frequency mode, next to the audio sample clock on TC5 and one
+// interrupt priority below it; the host simulation uses a second SimHal
+// virtual timer. start() returns false where no timer backend exists, in
+// which case the caller has to advance the sequencer from the main loop.
+class StrobeTimer
+{
+private:
+    static void (*volatile callback)();
+    static bool running;
+
+public:
+    static bool start(uint32_t rateHz, void (*isr)());
+    static void stop();
+    static bool isRunning();
+    static void handleInterrupt();
+};
+
+#endif
@@ -0,0 +1,144 @@
+#include "system_state_machine.h"
+
+struct StateNodeInfo
+{
+    uint8_t parent;
+    unsigned long timeoutMs; // 0 for none; raises EVENT_STATE_TIMEOUT
+};
+
+// Indexed by SystemState, then SystemSuperState
+static constexpr StateNodeInfo stateTree[] = {
+    {STATE_OPERATIONAL, 0},                    // STANDBY
+    {STATE_DETERRING, 0},                      // ALERT
+    {STATE_DETERRING, MAX_ACTIVATION_TIME_MS}, // ACTIVE_DETERRENT
+    {STATE_NO_PARENT, 0},                      // EMERGENCY
+    {STATE_NO_PARENT, 0},                      // MAINTENANCE
+    {STATE_NO_PARENT, 0},                      // STATE_OPERATIONAL
+    {STATE_OPERATIONAL, 0}};                   // STATE_DETERRING
+
+static constexpr StateTransition transitionTable[] = {
+    {STANDBY, EVENT_THREAT_PRESENT, ALERT, "Bird in view"},
+    {STANDBY, EVENT_THREAT_IMMINENT, ACTIVE_DETERRENT, "Contact predicted"},
+    {ALERT, EVENT_THREAT_IMMINENT, ACTIVE_DETERRENT, "Contact predicted"},
+    {ACTIVE_DETERRENT, EVENT_THREAT_PRESENT, ALERT, "No longer closing"},
+    {ACTIVE_DETERRENT, EVENT_STATE_TIMEOUT, EMERGENCY, "DETERRENT_TIMEOUT"},
+    {STATE_DETERRING, EVENT_THREAT_NONE, STANDBY, "All clear"},
+    {STATE_OPERATIONAL, EVENT_THREAT_CRITICAL, EMERGENCY, "BIRD_STRIKE_IMMINENT"},
+    {EMERGENCY, EVENT_EMERGENCY_RESOLVED, STANDBY, "Emergency resolved"},
+    {MAINTENANCE, EVENT_SELF_TEST_PASSED, STANDBY, "Self-test passed"}};
+
+static constexpr int transitionRows = sizeof(transitionTable) / sizeof(transitionTable[0]);
+
+static constexpr bool treeValid(int node, int depth)
+{
+    return depth <= STATE_NODE_COUNT &&
+           (stateTree[node].parent == STATE_NO_PARENT ||
+            (stateTree[node].parent >= SYSTEM_STATE_COUNT && stateTree[node].parent < STATE_NODE_COUNT &&
+             treeValid(stateTree[node].parent, depth + 1)));
+}
+
+static constexpr bool stateTreeValid(int node)
+{
+    return node >= STATE_NODE_COUNT || (treeValid(node, 0) && stateTreeValid(node + 1));
+}
+
+static constexpr bool transitionsValid(int row)
+{
+    return row >= transitionRows ||
+           (transitionTable[row].node < STATE_NODE_COUNT && transitionTable[row].target < SYSTEM_STATE_COUNT &&
+            transitionsValid(row + 1));
+}
+
+static_assert(sizeof(stateTree) / sizeof(stateTree[0]) == STATE_NODE_COUNT, "State tree must have one entry per node");
+static_assert(stateTreeValid(0), "State tree parents must be superstates and acyclic");
+static_assert(transitionsValid(0), "Transitions must start from a node and end in a real state");
+
+SystemStateMachine::SystemStateMachine()
+{
+    begin(STANDBY, 0);
+}
+
+void SystemStateMachine::begin(SystemState initial, unsigned long now)
+{
+    state = initial;
+    previous = initial;
+    enteredAt = now;
+    reason = "";
+    transitionCount = 0;
+}
+
+bool SystemStateMachine::dispatch(StateEvent event, unsigned long now)
+{
+    for (uint8_t node = state; node != STATE_NO_PARENT; node = stateTree[node].parent)
+    {
+        for (int i = 0; i < transitionRows; i++)
+        {
+            const StateTransition &row = transitionTable[i];
+            if (row.node != node || row.event != event)
+                continue;
+
+            previous = state;
+            state = (SystemState)row.target;
+            enteredAt = now;
+            reason = row.reason;
+            transitionCount++;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SystemStateMachine::isTimedOut(unsigned long now)
+{
+    unsigned long timeoutMs = stateTree[state].timeoutMs;
+    return timeoutMs > 0 && now - enteredAt > timeoutMs;
+}
+
+SystemState SystemStateMachine::getState()
+{
+    return state;
+}
+
+SystemState SystemStateMachine::getPreviousState()
+{
+    return previous;
+}
+
+const char *SystemStateMachine::getReason()
+{
+    return reason;
+}
+
+unsigned long SystemStateMachine::getTimeInState(unsigned long now)
+{
+    return now - enteredAt;
+}
+
+unsigned long SystemStateMachine::getTransitionCount()
+{
+    return transitionCount;
+}
+
+StateEvent SystemStateMachine::threatEvent(ThreatLevel level)
+{
+    return (StateEvent)(EVENT_THREAT_NONE + level);
+}
+
+const char *SystemStateMachine::getStateName(SystemState state)
+{
+    switch (state)
+    {
+    case STANDBY:
+        return "STANDBY";
+    case ALERT:
+        return "ALERT";
+    case ACTIVE_DETERRENT:
+        return "ACTIVE_DETERRENT";
+    case EMERGENCY:
+        return "EMERGENCY";
+    case MAINTENANCE:
+        return "MAINTENANCE";
+    default:
+        return "UNKNOWN";
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef SYSTEM_STATE_MACHINE_H
+#define SYSTEM_STATE_MACHINE_H
+
+#include <Arduino.h>
+#include "threat_assessment.h"
+
+#define MAX_ACTIVATION_TIME_MS 30000 // Deterring longer than this without success is an emergency
+#define STATE_NO_PARENT 0xFF
+
+// Values are sent in telemetry: append only
+enum SystemState
+{
+    STANDBY,
+    ALERT,
+    ACTIVE_DETERRENT,
+    EMERGENCY,
+    MAINTENANCE,
+    SYSTEM_STATE_COUNT
+};
+
+// Superstates hold the transitions their children share. The system is
+// never in one itself.
+enum SystemSuperState
+{
+    STATE_OPERATIONAL = SYSTEM_STATE_COUNT, // STANDBY and DETERRING
+    STATE_DETERRING,                        // ALERT and ACTIVE_DETERRENT
+    STATE_NODE_COUNT
+};
+
+enum StateEvent
+{
+    EVENT_THREAT_NONE,
+    EVENT_THREAT_PRESENT,
+    EVENT_THREAT_IMMINENT,
+    EVENT_THREAT_CRITICAL,
+    EVENT_STATE_TIMEOUT,
+    EVENT_EMERGENCY_RESOLVED,
+    EVENT_SELF_TEST_PASSED
+};
+
+struct StateTransition
+{
+    uint8_t node; // State or superstate the row belongs to
+    uint8_t event;
+    uint8_t target;
+    const char *reason;
+};
+
+// Table-driven hierarchical state machine for the deterrent. An event is
+// looked up in the current state's rows first, then in each enclosing
+// superstate's, and the first match wins; an event no level handles is
+// ignored. The table and the state tree are constexpr and checked at compile
+// time. The machine only decides: the caller runs each state's entry actions
+// when dispatch() reports a change.
+class SystemStateMachine
+{
+private:
+    SystemState state;
+    SystemState previous;
+    unsigned long enteredAt;
+    const char *reason;
+    unsigned long transitionCount;
+
+public:
+    SystemStateMachine();
+    void begin(SystemState initial, unsigned long now);
+    bool dispatch(StateEvent event, unsigned long now);
+    bool isTimedOut(unsigned long now);
+    SystemState getState();
+    SystemState getPreviousState();
+    const char *getReason();
+    unsigned long getTimeInState(unsigned long now);
+    unsigned long getTransitionCount();
+    static StateEvent threatEvent(ThreatLevel level);
+    static const char *getStateName(SystemState state);
+};
+
+#endif
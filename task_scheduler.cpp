@@ -0,0 +1,245 @@
+#include "task_scheduler.h"
+
+TaskScheduler::TaskScheduler()
+{
+    taskCount = 0;
+    started = false;
+    statsStartUs = 0;
+    idleUs = 0;
+}
+
+void TaskScheduler::resetTaskStats(TaskStats &stats)
+{
+    stats.runs = 0;
+    stats.overruns = 0;
+    stats.skippedReleases = 0;
+    stats.minExecUs = 0xFFFFFFFFUL;
+    stats.maxExecUs = 0;
+    stats.totalExecUs = 0;
+    stats.maxLatencyUs = 0;
+}
+
+bool TaskScheduler::addTask(const char *name, TaskFunction function, unsigned long periodUs,
+                            unsigned long deadlineUs)
+{
+    if (taskCount >= MAX_SCHEDULED_TASKS || function == nullptr || periodUs == 0)
+        return false;
+
+    if (deadlineUs == 0 || deadlineUs > periodUs)
+    {
+        deadlineUs = periodUs;
+    }
+
+    // Rate-monotonic priority: shorter period first, ties keep insertion order
+    int slot = taskCount;
+    while (slot > 0 && tasks[slot - 1].periodUs > periodUs)
+    {
+        tasks[slot] = tasks[slot - 1];
+        slot--;
+    }
+
+    ScheduledTask &task = tasks[slot];
+    task.name = name;
+    task.function = function;
+    task.periodUs = periodUs;
+    task.deadlineUs = deadlineUs;
+    task.releaseUs = micros();
+    resetTaskStats(task.stats);
+    taskCount++;
+    return true;
+}
+
+void TaskScheduler::start()
+{
+    unsigned long now = micros();
+    for (int i = 0; i < taskCount; i++)
+    {
+        tasks[i].releaseUs = now;
+    }
+    statsStartUs = now;
+    idleUs = 0;
+    started = true;
+}
+
+void TaskScheduler::runTask(ScheduledTask &task, unsigned long now)
+{
+    unsigned long latency = now - task.releaseUs;
+
+    task.function();
+
+    unsigned long end = micros();
+    unsigned long exec = end - now;
+    TaskStats &stats = task.stats;
+    stats.runs++;
+    stats.totalExecUs += exec;
+    if (exec < stats.minExecUs)
+    {
+        stats.minExecUs = exec;
+    }
+    if (exec > stats.maxExecUs)
+    {
+        stats.maxExecUs = exec;
+    }
+    if (latency > stats.maxLatencyUs)
+    {
+        stats.maxLatencyUs = latency;
+    }
+    if ((long)(end - task.releaseUs) > (long)task.deadlineUs)
+    {
+        stats.overruns++;
+    }
+
+    // Keep phase; after a stall longer than a period, drop the missed
+    // releases instead of running the task back to back to catch up
+    task.releaseUs += task.periodUs;
+    long behind = (long)(end - task.releaseUs);
+    if (behind >= (long)task.periodUs)
+    {
+        unsigned long missed = (unsigned long)behind / task.periodUs;
+        stats.skippedReleases += missed;
+        task.releaseUs += missed * task.periodUs;
+    }
+}
+
+bool TaskScheduler::runOnce()
+{
+    if (!started)
+    {
+        start();
+    }
+
+    unsigned long now = micros();
+    for (int i = 0; i < taskCount; i++)
+    {
+        if ((long)(now - tasks[i].releaseUs) >= 0)
+        {
+            runTask(tasks[i], now);
+            return true;
+        }
+    }
+    return false;
+}
+
+unsigned long TaskScheduler::timeToNextRelease()
+{
+    if (taskCount == 0)
+        return 0;
+
+    unsigned long now = micros();
+    long earliest = (long)(tasks[0].releaseUs - now);
+    for (int i = 1; i < taskCount; i++)
+    {
+        long wait = (long)(tasks[i].releaseUs - now);
+        if (wait < earliest)
+        {
+            earliest = wait;
+        }
+    }
+    return earliest > 0 ? (unsigned long)earliest : 0;
+}
+
+void TaskScheduler::idle()
+{
+    unsigned long wait = timeToNextRelease();
+    if (wait == 0)
+        return;
+
+    unsigned long begin = micros();
+    if (wait >= 1000)
+    {
+        delay(wait / 1000);
+    }
+    if (wait % 1000 > 0)
+    {
+        delayMicroseconds(wait % 1000);
+    }
+    idleUs += micros() - begin;
+}
+
+void TaskScheduler::service()
+{
+    if (!runOnce())
+    {
+        idle();
+    }
+}
+
+int TaskScheduler::getTaskCount()
+{
+    return taskCount;
+}
+
+const ScheduledTask *TaskScheduler::getTask(int index)
+{
+    if (index < 0 || index >= taskCount)
+        return nullptr;
+
+    return &tasks[index];
+}
+
+float TaskScheduler::getUtilization()
+{
+    unsigned long elapsed = micros() - statsStartUs;
+    if (elapsed == 0)
+        return 0.0;
+
+    unsigned long long busy = 0;
+    for (int i = 0; i < taskCount; i++)
+    {
+        busy += tasks[i].stats.totalExecUs;
+    }
+    return (float)busy / elapsed;
+}
+
+unsigned long long TaskScheduler::getIdleUs()
+{
+    return idleUs;
+}
+
+void TaskScheduler::resetStatistics()
+{
+    for (int i = 0; i < taskCount; i++)
+    {
+        resetTaskStats(tasks[i].stats);
+    }
+    statsStartUs = micros();
+    idleUs = 0;
+}
+
+void TaskScheduler::printStatistics()
+{
+    float elapsed = (micros() - statsStartUs) / 1000000.0;
+
+    Serial.println("\n=== TASK STATISTICS ===");
+    Serial.print("Window: ");
+    Serial.print(elapsed, 1);
+    Serial.print("s, CPU: ");
+    Serial.print(getUtilization() * 100.0, 2);
+    Serial.println("%");
+    for (int i = 0; i < taskCount; i++)
+    {
+        const ScheduledTask &task = tasks[i];
+        const TaskStats &stats = task.stats;
+        unsigned long mean = stats.runs > 0 ? (unsigned long)(stats.totalExecUs / stats.runs) : 0;
+        unsigned long minimum = stats.runs > 0 ? stats.minExecUs : 0;
+
+        Serial.print(task.name);
+        Serial.print(": period ");
+        Serial.print(task.periodUs);
+        Serial.print("us, runs ");
+        Serial.print(stats.runs);
+        Serial.print(", exec min/avg/max ");
+        Serial.print(minimum);
+        Serial.print("/");
+        Serial.print(mean);
+        Serial.print("/");
+        Serial.print(stats.maxExecUs);
+        Serial.print("us, latency max ");
+        Serial.print(stats.maxLatencyUs);
+        Serial.print("us, overruns ");
+        Serial.print(stats.overruns);
+        Serial.print(", skipped ");
+        Serial.println(stats.skippedReleases);
+    }
+    Serial.println("=======================\n");
+}
@@ -0,0 +1,67 @@
+#ifndef TASK_SCHEDULER_H
+#define TASK_SCHEDULER_H
+
+#include <Arduino.h>
+
+#define MAX_SCHEDULED_TASKS 8
+#define HZ_TO_PERIOD_US(hz) ((unsigned long)(1000000.0 / (hz)))
+
+typedef void (*TaskFunction)();
+
+// Execution statistics for one task, all times in microseconds
+struct TaskStats
+{
+    unsigned long runs;
+    unsigned long overruns;         // Finished after release + deadline
+    unsigned long skippedReleases;  // Whole periods dropped after a stall
+    unsigned long minExecUs;
+    unsigned long maxExecUs;
+    unsigned long long totalExecUs;
+    unsigned long maxLatencyUs;     // Release to start
+};
+
+struct ScheduledTask
+{
+    const char *name;
+    TaskFunction function;
+    unsigned long periodUs;
+    unsigned long deadlineUs;  // Relative to release, at most the period
+    unsigned long releaseUs;   // Current (or next) release time
+    TaskStats stats;
+};
+
+// Non-preemptive rate-monotonic scheduler for the main loop. Tasks are kept
+// in period order, which is their priority: each runOnce() runs the single
+// highest-priority task that has been released, so a slow task can delay a
+// fast one by at most its own execution time. With nothing released the
+// scheduler idles until the earliest next release.
+class TaskScheduler
+{
+private:
+    ScheduledTask tasks[MAX_SCHEDULED_TASKS];
+    int taskCount;
+    bool started;
+    unsigned long statsStartUs;
+    unsigned long long idleUs;
+
+    void resetTaskStats(TaskStats &stats);
+    void runTask(ScheduledTask &task, unsigned long now);
+
+public:
+    TaskScheduler();
+    bool addTask(const char *name, TaskFunction function, unsigned long periodUs, unsigned long deadlineUs = 0);
+    void start();
+    bool runOnce();
+    void idle();
+    void service();
+    unsigned long timeToNextRelease();
+
+    int getTaskCount();
+    const ScheduledTask *getTask(int index);
+    float getUtilization();
+    unsigned long long getIdleUs();
+    void resetStatistics();
+    void printStatistics();
+};
+
+#endif
@@ -0,0 +1,183 @@
+#include "telemetry_protocol.h"
+
+// CRC-16/CCITT-FALSE: polynomial 0x1021, initial value 0xFFFF
+uint16_t telemetryCrc16(const uint8_t *data, size_t length)
+{
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Consistent Overhead Byte Stuffing: removes every zero from the payload at
+// a cost of one byte per 254. The output carries no delimiter.
+size_t telemetryCobsEncode(const uint8_t *input, size_t length, uint8_t *output)
+{
+    size_t codeIndex = 0;
+    size_t outIndex = 1;
+    uint8_t code = 1;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        if (input[i] != 0)
+        {
+            output[outIndex++] = input[i];
+            code++;
+        }
+        if (input[i] == 0 || code == 0xFF)
+        {
+            output[codeIndex] = code;
+            codeIndex = outIndex++;
+            code = 1;
+        }
+    }
+    output[codeIndex] = code;
+    return outIndex;
+}
+
+// Zigzag maps small negative deltas to small unsigned values, then LEB128
+// stores 7 bits per byte
+uint8_t *telemetryPutVarint(uint8_t *out, int32_t value)
+{
+    uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+    while (zigzag >= 0x80)
+    {
+        *out++ = (uint8_t)(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    *out++ = (uint8_t)zigzag;
+    return out;
+}
+
+TelemetryEncoder::TelemetryEncoder()
+{
+    reset();
+}
+
+void TelemetryEncoder::reset()
+{
+    havePrevious = false;
+    sequence = 0;
+    framesSinceKey = 0;
+    batchEnd = raw + TELEMETRY_HEADER_SIZE;
+    batchCount = 0;
+}
+
+void TelemetryEncoder::startFrame(TelemetryFrameType type)
+{
+    raw[0] = TELEMETRY_PROTOCOL_VERSION;
+    raw[1] = type;
+    raw[2] = sequence;
+}
+
+size_t TelemetryEncoder::finishFrame(uint8_t *end)
+{
+    uint16_t crc = telemetryCrc16(raw, end - raw);
+    *end++ = (uint8_t)(crc >> 8);
+    *end++ = (uint8_t)crc;
+
+    frame[0] = 0;
+    size_t length = 1 + telemetryCobsEncode(raw, end - raw, frame + 1);
+    frame[length++] = 0;
+    sequence++;
+    return length;
+}
+
+size_t TelemetryEncoder::encode(const TelemetrySample &sample)
+{
+    bool keyFrame = !havePrevious || framesSinceKey >= TELEMETRY_KEYFRAME_INTERVAL;
+
+    startFrame(keyFrame ? TELEMETRY_FRAME_KEY : TELEMETRY_FRAME_DELTA);
+    uint8_t *out = raw + TELEMETRY_HEADER_SIZE;
+    for (int i = 0; i < TELEMETRY_FIELD_COUNT; i++)
+    {
+        int32_t value = sample.values[i];
+        if (!keyFrame)
+        {
+            value = (int32_t)((uint32_t)value - (uint32_t)previous.values[i]);
+        }
+        out = telemetryPutVarint(out, value);
+    }
+
+    previous = sample;
+    havePrevious = true;
+    framesSinceKey = keyFrame ? 1 : framesSinceKey + 1;
+    return finishFrame(out);
+}
+
+size_t TelemetryEncoder::encodeValues(TelemetryFrameType type, const int32_t *values, int count)
+{
+    if (count > TELEMETRY_MAX_VALUES)
+    {
+        count = TELEMETRY_MAX_VALUES;
+    }
+
+    startFrame(type);
+    uint8_t *out = raw + TELEMETRY_HEADER_SIZE;
+    for (int i = 0; i < count; i++)
+    {
+        out = telemetryPutVarint(out, values[i]);
+    }
+    return finishFrame(out);
+}
+
+void TelemetryEncoder::beginBatch()
+{
+    startFrame(TELEMETRY_FRAME_BATCH);
+    batchEnd = raw + TELEMETRY_HEADER_SIZE;
+    batchCount = 0;
+}
+
+// Returns false, leaving the batch untouched, once the sample would push
+// the frame past TELEMETRY_MAX_FRAME
+bool TelemetryEncoder::addToBatch(const TelemetrySample &sample)
+{
+    uint8_t encoded[TELEMETRY_FIELD_COUNT * TELEMETRY_MAX_VARINT_BYTES];
+    uint8_t *out = encoded;
+    for (int i = 0; i < TELEMETRY_FIELD_COUNT; i++)
+    {
+        int32_t value = sample.values[i];
+        if (batchCount > 0)
+        {
+            value = (int32_t)((uint32_t)value - (uint32_t)batchPrevious.values[i]);
+        }
+        out = telemetryPutVarint(out, value);
+    }
+
+    size_t length = out - encoded;
+    if ((size_t)(batchEnd - raw) + length + TELEMETRY_CRC_SIZE > TELEMETRY_MAX_RAW_FRAME)
+        return false;
+
+    memcpy(batchEnd, encoded, length);
+    batchEnd += length;
+    batchPrevious = sample;
+    batchCount++;
+    return true;
+}
+
+int TelemetryEncoder::getBatchCount()
+{
+    return batchCount;
+}
+
+size_t TelemetryEncoder::finishBatch()
+{
+    if (batchCount == 0)
+        return 0;
+
+    size_t length = finishFrame(batchEnd);
+    batchEnd = raw + TELEMETRY_HEADER_SIZE;
+    batchCount = 0;
+    return length;
+}
+
+const uint8_t *TelemetryEncoder::getFrame()
+{
+    return frame;
+}
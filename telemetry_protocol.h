@@ -0,0 +1,91 @@
+#ifndef TELEMETRY_PROTOCOL_H
+#define TELEMETRY_PROTOCOL_H
+
+#include <Arduino.h>
+
+// Binary telemetry frame, before framing:
+//
+//   version (1) | type (1) | sequence (1) | fields (zigzag varints) | CRC16 (2, big endian)
+//
+// The whole frame is COBS-encoded and sent between 0x00 delimiters, so the
+// ground station can resynchronise on any zero byte and reject text or
+// line noise by CRC. Key frames carry absolute field values; delta frames
+// carry the difference from the previous frame. Batch frames carry several
+// samples, the first absolute and the rest as deltas, so each batch decodes
+// on its own. Perf and track frames carry absolute values: profiling
+// summaries, and a timestamp followed by one record per changed track.
+#define TELEMETRY_PROTOCOL_VERSION 1
+#define TELEMETRY_HEADER_SIZE 3
+#define TELEMETRY_CRC_SIZE 2
+#define TELEMETRY_MAX_VARINT_BYTES 5
+#define TELEMETRY_MAX_FRAME 256                           // Framed bytes per transmission
+#define TELEMETRY_MAX_RAW_FRAME (TELEMETRY_MAX_FRAME - 4) // Leaves room for COBS (+1) and delimiters
+#define TELEMETRY_MAX_VALUES ((TELEMETRY_MAX_RAW_FRAME - TELEMETRY_HEADER_SIZE - TELEMETRY_CRC_SIZE) / TELEMETRY_MAX_VARINT_BYTES)
+#define TELEMETRY_KEYFRAME_INTERVAL 20                    // Frames between absolute refreshes
+
+enum TelemetryFrameType
+{
+    TELEMETRY_FRAME_KEY = 0,
+    TELEMETRY_FRAME_DELTA = 1,
+    TELEMETRY_FRAME_PERF = 2,
+    TELEMETRY_FRAME_BATCH = 3,
+    TELEMETRY_FRAME_TRACKS = 4
+};
+
+// Field order is part of the protocol; append only, and bump the version
+// for anything else. Units are chosen so every field is an integer.
+enum TelemetryField
+{
+    TELEMETRY_TIMESTAMP_MS,
+    TELEMETRY_STATE,
+    TELEMETRY_BATTERY_MV,
+    TELEMETRY_TEMPERATURE_CC,       // Centi-degrees C
+    TELEMETRY_BIRD_COUNT,
+    TELEMETRY_CLOSEST_DISTANCE_MM,
+    TELEMETRY_WEATHER_CONDITION,
+    TELEMETRY_WEATHER_CRITICAL,
+    TELEMETRY_EMERGENCY_STATE,
+    TELEMETRY_HEALTH_ISSUES,
+    TELEMETRY_FIELD_COUNT
+};
+
+struct TelemetrySample
+{
+    int32_t values[TELEMETRY_FIELD_COUNT];
+};
+
+uint16_t telemetryCrc16(const uint8_t *data, size_t length);
+size_t telemetryCobsEncode(const uint8_t *input, size_t length, uint8_t *output);
+uint8_t *telemetryPutVarint(uint8_t *out, int32_t value);
+
+// Builds frames into a buffer it owns; nothing is allocated per frame. One
+// frame is built at a time, so finish a batch before encoding anything else.
+class TelemetryEncoder
+{
+private:
+    TelemetrySample previous;
+    bool havePrevious;
+    uint8_t sequence;
+    uint8_t framesSinceKey;
+    uint8_t raw[TELEMETRY_MAX_RAW_FRAME];
+    uint8_t frame[TELEMETRY_MAX_FRAME];
+    TelemetrySample batchPrevious;
+    uint8_t *batchEnd;
+    int batchCount;
+
+    void startFrame(TelemetryFrameType type);
+    size_t finishFrame(uint8_t *end);
+
+public:
+    TelemetryEncoder();
+    void reset();
+    size_t encode(const TelemetrySample &sample);
+    size_t encodeValues(TelemetryFrameType type, const int32_t *values, int count);
+    void beginBatch();
+    bool addToBatch(const TelemetrySample &sample);
+    int getBatchCount();
+    size_t finishBatch();
+    const uint8_t *getFrame();
+};
+
+#endif
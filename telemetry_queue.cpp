@@ -0,0 +1,227 @@
+#include "telemetry_queue.h"
+
+// Keeps the compiler from moving sample stores past the index publish. A
+// single-core M0+ needs no hardware fence for this.
+#define TELEMETRY_QUEUE_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+static_assert((MAX_TELEMETRY_QUEUE & (MAX_TELEMETRY_QUEUE - 1)) == 0, "MAX_TELEMETRY_QUEUE must be a power of two");
+
+TelemetryQueue::TelemetryQueue()
+{
+    head = 0;
+    tail = 0;
+    pushedCount = 0;
+    overflowCount = 0;
+    sentCount = 0;
+}
+
+bool TelemetryQueue::push(const TelemetrySample &sample)
+{
+    uint16_t currentHead = head;
+    if ((uint16_t)(currentHead - tail) >= MAX_TELEMETRY_QUEUE)
+    {
+        overflowCount++;
+        return false;
+    }
+
+    samples[currentHead & (MAX_TELEMETRY_QUEUE - 1)] = sample;
+    TELEMETRY_QUEUE_BARRIER();
+    head = currentHead + 1;
+    pushedCount++;
+    return true;
+}
+
+int TelemetryQueue::available()
+{
+    return (uint16_t)(head - tail);
+}
+
+const TelemetrySample &TelemetryQueue::peek(int offset)
+{
+    return samples[(uint16_t)(tail + offset) & (MAX_TELEMETRY_QUEUE - 1)];
+}
+
+void TelemetryQueue::release(int count)
+{
+    TELEMETRY_QUEUE_BARRIER();
+    tail = tail + count;
+    sentCount += count;
+}
+
+int TelemetryQueue::capacity()
+{
+    return MAX_TELEMETRY_QUEUE;
+}
+
+unsigned long TelemetryQueue::getPushedCount()
+{
+    return pushedCount;
+}
+
+unsigned long TelemetryQueue::getOverflowCount()
+{
+    return overflowCount;
+}
+
+unsigned long TelemetryQueue::getSentCount()
+{
+    return sentCount;
+}
+
+// Each frame is stored behind a small header in the byte ring
+struct TelemetryBacklogHeader
+{
+    uint16_t length;
+    uint16_t samples;
+    int32_t firstMs;
+};
+
+static_assert(TELEMETRY_BACKLOG_BYTES >= 4 * (TELEMETRY_MAX_FRAME + sizeof(TelemetryBacklogHeader)),
+              "TELEMETRY_BACKLOG_BYTES must hold several full frames");
+
+TelemetryBacklog::TelemetryBacklog()
+{
+    head = 0;
+    tail = 0;
+    used = 0;
+    frameCount = 0;
+    newestMs = 0;
+    peakBytes = 0;
+    peakSpanMs = 0;
+    storedSamples = 0;
+    sentSamples = 0;
+    droppedSamples = 0;
+}
+
+void TelemetryBacklog::write(const void *data, size_t length)
+{
+    const uint8_t *in = (const uint8_t *)data;
+    for (size_t i = 0; i < length; i++)
+    {
+        bytes[head] = in[i];
+        head = head + 1 == TELEMETRY_BACKLOG_BYTES ? 0 : head + 1;
+    }
+    used += length;
+}
+
+void TelemetryBacklog::read(size_t offset, void *data, size_t length)
+{
+    uint8_t *out = (uint8_t *)data;
+    size_t index = (tail + offset) % TELEMETRY_BACKLOG_BYTES;
+    for (size_t i = 0; i < length; i++)
+    {
+        out[i] = bytes[index];
+        index = index + 1 == TELEMETRY_BACKLOG_BYTES ? 0 : index + 1;
+    }
+}
+
+void TelemetryBacklog::dropOldest()
+{
+    TelemetryBacklogHeader header;
+    read(0, &header, sizeof(header));
+    size_t record = sizeof(header) + header.length;
+    tail = (tail + record) % TELEMETRY_BACKLOG_BYTES;
+    used -= record;
+    frameCount--;
+}
+
+// Evicts the oldest frames if the outage has outrun the retention budget
+bool TelemetryBacklog::store(const uint8_t *frame, size_t length, int samples, int32_t firstMs, int32_t lastMs)
+{
+    TelemetryBacklogHeader header = {(uint16_t)length, (uint16_t)samples, firstMs};
+    size_t record = sizeof(header) + length;
+    if (length == 0 || record > TELEMETRY_BACKLOG_BYTES)
+        return false;
+
+    while (TELEMETRY_BACKLOG_BYTES - used < record)
+    {
+        TelemetryBacklogHeader oldest;
+        read(0, &oldest, sizeof(oldest));
+        droppedSamples += oldest.samples;
+        dropOldest();
+    }
+
+    write(&header, sizeof(header));
+    write(frame, length);
+    frameCount++;
+    newestMs = lastMs;
+    storedSamples += samples;
+    peakBytes = max(peakBytes, used);
+    peakSpanMs = max(peakSpanMs, getSpanMs());
+    return true;
+}
+
+bool TelemetryBacklog::isEmpty()
+{
+    return frameCount == 0;
+}
+
+// Copies the oldest frame, ready to write to the link, into a buffer of
+// TELEMETRY_MAX_FRAME bytes; it stays stored until release()
+size_t TelemetryBacklog::copyOldest(uint8_t *frame)
+{
+    if (frameCount == 0)
+        return 0;
+
+    TelemetryBacklogHeader header;
+    read(0, &header, sizeof(header));
+    read(sizeof(header), frame, header.length);
+    return header.length;
+}
+
+void TelemetryBacklog::release()
+{
+    if (frameCount == 0)
+        return;
+
+    TelemetryBacklogHeader header;
+    read(0, &header, sizeof(header));
+    sentSamples += header.samples;
+    dropOldest();
+}
+
+int TelemetryBacklog::getFrameCount()
+{
+    return frameCount;
+}
+
+// Sample time covered from the oldest stored sample to the newest
+unsigned long TelemetryBacklog::getSpanMs()
+{
+    if (frameCount == 0)
+        return 0;
+
+    TelemetryBacklogHeader oldest;
+    read(0, &oldest, sizeof(oldest));
+    return (unsigned long)(newestMs - oldest.firstMs);
+}
+
+unsigned long TelemetryBacklog::getPeakSpanMs()
+{
+    return peakSpanMs;
+}
+
+size_t TelemetryBacklog::getPeakBytes()
+{
+    return peakBytes;
+}
+
+size_t TelemetryBacklog::capacity()
+{
+    return TELEMETRY_BACKLOG_BYTES;
+}
+
+unsigned long TelemetryBacklog::getStoredSamples()
+{
+    return storedSamples;
+}
+
+unsigned long TelemetryBacklog::getSentSamples()
+{
+    return sentSamples;
+}
+
+unsigned long TelemetryBacklog::getDroppedSamples()
+{
+    return droppedSamples;
+}
@@ -0,0 +1,80 @@
+#ifndef TELEMETRY_QUEUE_H
+#define TELEMETRY_QUEUE_H
+
+#include <Arduino.h>
+#include "telemetry_protocol.h"
+#include "config.h"
+
+// Lock-free single-producer / single-consumer ring of telemetry samples.
+// The sampler pushes at the telemetry rate; the uplink peeks a batch,
+// transmits or stores it and only then releases it, so nothing leaves the
+// ring until it is on the wire or in the TelemetryBacklog.
+class TelemetryQueue
+{
+private:
+    TelemetrySample samples[MAX_TELEMETRY_QUEUE];
+    volatile uint16_t head; // Written by the producer only
+    volatile uint16_t tail; // Written by the consumer only
+    unsigned long pushedCount;
+    unsigned long overflowCount;
+    unsigned long sentCount;
+
+public:
+    TelemetryQueue();
+
+    // Producer side
+    bool push(const TelemetrySample &sample);
+
+    // Consumer side
+    int available();
+    const TelemetrySample &peek(int offset);
+    void release(int count);
+
+    int capacity();
+    unsigned long getPushedCount();
+    unsigned long getOverflowCount();
+    unsigned long getSentCount();
+};
+
+// Store-and-forward history for link outages, kept as the packed batch
+// frames the uplink would have sent (about a third of the RAM of raw
+// samples). Frames go in oldest first and come out in the same order; the
+// byte ring is sized for TELEMETRY_OUTAGE_RETENTION_S, and only an outage
+// longer than that evicts the oldest frames. Used from the uplink task only.
+class TelemetryBacklog
+{
+private:
+    uint8_t bytes[TELEMETRY_BACKLOG_BYTES];
+    size_t head;
+    size_t tail;
+    size_t used;
+    int frameCount;
+    int32_t newestMs;
+    size_t peakBytes;
+    unsigned long peakSpanMs;
+    unsigned long storedSamples;
+    unsigned long sentSamples;
+    unsigned long droppedSamples;
+
+    void write(const void *data, size_t length);
+    void read(size_t offset, void *data, size_t length);
+    void dropOldest();
+
+public:
+    TelemetryBacklog();
+    bool store(const uint8_t *frame, size_t length, int samples, int32_t firstMs, int32_t lastMs);
+    bool isEmpty();
+    size_t copyOldest(uint8_t *frame);
+    void release();
+
+    int getFrameCount();
+    unsigned long getSpanMs();
+    unsigned long getPeakSpanMs();
+    size_t getPeakBytes();
+    size_t capacity();
+    unsigned long getStoredSamples();
+    unsigned long getSentSamples();
+    unsigned long getDroppedSamples();
+};
+
+#endif
@@ -0,0 +1,147 @@
+#include "threat_assessment.h"
+
+static_assert(THREAT_DETER_EXIT_TTC_S >= THREAT_DETER_TTC_S && THREAT_CRITICAL_EXIT_TTC_S >= THREAT_CRITICAL_TTC_S &&
+                  THREAT_DETER_EXIT_DISTANCE_M >= THREAT_DETER_DISTANCE_M &&
+                  THREAT_CRITICAL_EXIT_DISTANCE_M >= THREAT_CRITICAL_DISTANCE_M,
+              "Threat exit thresholds must be at least as wide as the enter thresholds");
+
+ThreatAssessment::ThreatAssessment()
+{
+    reset();
+}
+
+void ThreatAssessment::reset()
+{
+    level = THREAT_NONE;
+    confirmCount = 0;
+    lastHeld = 0;
+    minTimeToContact = INFINITY;
+    closestDistance = INFINITY;
+    birdsInView = 0;
+}
+
+// Seconds until the bird reaches the rig at the closing speed the tracker is
+// confident of; infinite if it is not closing
+float ThreatAssessment::timeToContact(const BirdObject &track)
+{
+    float closing = track.velocity - THREAT_VELOCITY_SIGMAS * velocitySigma(track);
+    if (closing < THREAT_MIN_CLOSING_MPS)
+        return INFINITY;
+    return track.distance / 100.0 / closing;
+}
+
+// True once the tracker is confident the bird is flying away; a close bird
+// that is leaving does not need the distance backstop
+bool ThreatAssessment::isReceding(const BirdObject &track)
+{
+    return track.velocity + THREAT_VELOCITY_SIGMAS * velocitySigma(track) < -THREAT_MIN_CLOSING_MPS;
+}
+
+float ThreatAssessment::velocitySigma(const BirdObject &track)
+{
+    return sqrt(max(track.covariance[1][1], 0.0f)) / 100.0;
+}
+
+ThreatLevel ThreatAssessment::update(const BirdObject *tracks, int count, unsigned long now)
+{
+    int imminentEnter = 0;
+    int imminentHold = 0;
+    int criticalEnter = 0;
+    int criticalHold = 0;
+    birdsInView = 0;
+    minTimeToContact = INFINITY;
+    closestDistance = INFINITY;
+
+    for (int i = 0; i < count; i++)
+    {
+        const BirdObject &track = tracks[i];
+        if (!track.confirmed || track.confidenceLevel <= THREAT_MIN_CONFIDENCE)
+            continue;
+
+        float distance = track.distance / 100.0;
+        if (distance > THREAT_DETECTION_RADIUS_M)
+            continue;
+
+        float ttc = timeToContact(track);
+        birdsInView++;
+        closestDistance = min(closestDistance, distance);
+        minTimeToContact = min(minTimeToContact, ttc);
+
+        // Leaving birds are measured on time to contact alone, which is infinite
+        float near = isReceding(track) ? INFINITY : distance;
+        imminentEnter += ttc <= THREAT_DETER_TTC_S || near <= THREAT_DETER_DISTANCE_M;
+        imminentHold += ttc <= THREAT_DETER_EXIT_TTC_S || near <= THREAT_DETER_EXIT_DISTANCE_M;
+        criticalEnter += ttc <= THREAT_CRITICAL_TTC_S || near <= THREAT_CRITICAL_DISTANCE_M;
+        criticalHold += ttc <= THREAT_CRITICAL_EXIT_TTC_S || near <= THREAT_CRITICAL_EXIT_DISTANCE_M;
+    }
+
+    ThreatLevel present = birdsInView > 0 ? THREAT_PRESENT : THREAT_NONE;
+    ThreatLevel enter = criticalEnter >= THREAT_CRITICAL_BIRDS ? THREAT_CRITICAL
+                        : imminentEnter > 0                    ? THREAT_IMMINENT
+                                                               : present;
+    ThreatLevel hold = criticalHold >= THREAT_CRITICAL_BIRDS ? THREAT_CRITICAL
+                       : imminentHold > 0                    ? THREAT_IMMINENT
+                                                             : present;
+
+    if (enter > level)
+    {
+        if (++confirmCount >= THREAT_CONFIRM_COUNT)
+        {
+            level = enter;
+            confirmCount = 0;
+            lastHeld = now;
+        }
+    }
+    else
+    {
+        confirmCount = 0;
+    }
+
+    if (hold >= level)
+    {
+        lastHeld = now;
+    }
+    else if (now - lastHeld >= THREAT_RELEASE_MS)
+    {
+        level = hold;
+        lastHeld = now;
+    }
+    return level;
+}
+
+ThreatLevel ThreatAssessment::getLevel()
+{
+    return level;
+}
+
+float ThreatAssessment::getMinTimeToContact()
+{
+    return minTimeToContact;
+}
+
+float ThreatAssessment::getClosestDistance()
+{
+    return closestDistance;
+}
+
+int ThreatAssessment::getBirdsInView()
+{
+    return birdsInView;
+}
+
+const char *ThreatAssessment::getLevelName(ThreatLevel level)
+{
+    switch (level)
+    {
+    case THREAT_NONE:
+        return "NONE";
+    case THREAT_PRESENT:
+        return "PRESENT";
+    case THREAT_IMMINENT:
+        return "IMMINENT";
+    case THREAT_CRITICAL:
+        return "CRITICAL";
+    default:
+        return "UNKNOWN";
+    }
+}
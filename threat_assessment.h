@@ -0,0 +1,69 @@
+#ifndef THREAT_ASSESSMENT_H
+#define THREAT_ASSESSMENT_H
+
+#include <Arduino.h>
+#include "bird_tracker.h"
+#include "sensor_array.h"
+
+// Everything here is in metres, metres per second and seconds; tracker
+// ranges (cm) are converted on the way in. Each level has an enter and a
+// wider exit threshold.
+#define THREAT_DETECTION_RADIUS_M (RANGING_MAX_RANGE_CM / 100.0) // Anything the ring can range is in view
+#define THREAT_DETER_TTC_S 4.0
+#define THREAT_DETER_EXIT_TTC_S 6.0
+#define THREAT_DETER_DISTANCE_M 1.0       // Backstop for birds holding station close in
+#define THREAT_DETER_EXIT_DISTANCE_M 1.5
+#define THREAT_CRITICAL_TTC_S 1.0
+#define THREAT_CRITICAL_EXIT_TTC_S 2.0
+#define THREAT_CRITICAL_DISTANCE_M 0.3
+#define THREAT_CRITICAL_EXIT_DISTANCE_M 0.5
+#define THREAT_CRITICAL_BIRDS 3           // Birds past the critical threshold at once for an emergency
+#define THREAT_MIN_CLOSING_MPS 0.05       // Slower than this is holding station: no contact predicted
+#define THREAT_VELOCITY_SIGMAS 1.0        // Closing speed used is this many sigma below the estimate
+#define THREAT_MIN_CONFIDENCE 30          // As BirdDetection counts active birds
+#define THREAT_CONFIRM_COUNT 3            // Consecutive assessments before escalating
+#define THREAT_RELEASE_MS 2000            // Exit condition must hold this long before stepping down
+
+enum ThreatLevel
+{
+    THREAT_NONE = 0,
+    THREAT_PRESENT = 1,  // Birds in view, none on course to arrive soon
+    THREAT_IMMINENT = 2, // Contact predicted within THREAT_DETER_TTC_S, or close in
+    THREAT_CRITICAL = 3  // Several birds about to arrive at once
+};
+
+// Turns confirmed tracks into a threat level from predicted time to contact
+// (range over closing speed) rather than range alone, so a fast bird is met
+// while it is still far out and a slow one is not escalated early. The
+// closing speed is taken THREAT_VELOCITY_SIGMAS below the tracker's estimate,
+// so a fresh track with an unsettled velocity predicts nothing yet. The
+// distance backstops skip birds the tracker is sure are leaving.
+// Escalation needs THREAT_CONFIRM_COUNT assessments in a row; stepping down
+// needs the wider exit thresholds to hold for THREAT_RELEASE_MS, so a bird
+// hovering on a threshold does not flap the state.
+class ThreatAssessment
+{
+private:
+    ThreatLevel level;
+    uint8_t confirmCount;
+    unsigned long lastHeld;
+    float minTimeToContact;
+    float closestDistance;
+    int birdsInView;
+
+    static float velocitySigma(const BirdObject &track);
+
+public:
+    ThreatAssessment();
+    void reset();
+    ThreatLevel update(const BirdObject *tracks, int count, unsigned long now);
+    ThreatLevel getLevel();
+    float getMinTimeToContact();
+    float getClosestDistance();
+    int getBirdsInView();
+    static float timeToContact(const BirdObject &track);
+    static bool isReceding(const BirdObject &track);
+    static const char *getLevelName(ThreatLevel level);
+};
+
+#endif
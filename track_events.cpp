@@ -0,0 +1,272 @@
+#include "track_events.h"
+
+TrackEventStream::TrackEventStream()
+{
+    reset();
+}
+
+void TrackEventStream::reset()
+{
+    for (int i = 0; i < TRACK_EVENT_MAX_REPORTS; i++)
+    {
+        reports[i].active = false;
+        reports[i].pending = false;
+    }
+    tokens = TRACK_EVENT_BURST;
+    lastRefill = 0;
+    started = false;
+    eventsSent = 0;
+    eventsCoalesced = 0;
+    eventsDeferred = 0;
+    framesSent = 0;
+    bytesSent = 0;
+}
+
+TrackReport *TrackEventStream::findReport(uint16_t trackId)
+{
+    for (int i = 0; i < TRACK_EVENT_MAX_REPORTS; i++)
+    {
+        if (reports[i].active && reports[i].trackId == trackId)
+            return &reports[i];
+    }
+    return nullptr;
+}
+
+TrackReport *TrackEventStream::allocateReport(uint16_t trackId)
+{
+    for (int i = 0; i < TRACK_EVENT_MAX_REPORTS; i++)
+    {
+        if (!reports[i].active)
+        {
+            TrackReport &report = reports[i];
+            report.trackId = trackId;
+            report.active = true;
+            report.pending = false;
+            report.lastSent = 0;
+            return &report;
+        }
+    }
+    return nullptr;
+}
+
+void TrackEventStream::markPending(TrackReport &report, uint8_t kind)
+{
+    if (report.pending)
+    {
+        // An unsent report is overwritten with newer state, not queued
+        eventsCoalesced++;
+        if (kind == TRACK_EVENT_UPDATE)
+        {
+            kind = report.kind;
+        }
+    }
+    report.kind = kind;
+    report.pending = true;
+}
+
+void TrackEventStream::update(const BirdObject *tracks, int count, unsigned long now)
+{
+    for (int i = 0; i < TRACK_EVENT_MAX_REPORTS; i++)
+    {
+        reports[i].present = false;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        const BirdObject &track = tracks[i];
+        if (!track.confirmed)
+            continue;
+
+        TrackReport *report = findReport(track.trackId);
+        bool isNew = report == nullptr;
+        if (isNew)
+        {
+            report = allocateReport(track.trackId);
+            if (report == nullptr)
+                continue;
+        }
+
+        report->present = true;
+        report->rangeMm = (int32_t)lround(track.distance * 10.0);
+        report->azimuthDeciDeg = (int32_t)lround(track.azimuth * 10.0);
+        report->velocityCms = (int32_t)lround(track.velocity * 100.0);
+        report->confidence = track.confidenceLevel;
+
+        if (isNew)
+        {
+            markPending(*report, TRACK_EVENT_NEW);
+        }
+        else if (fabs(track.distance - report->sentRange) >= TRACK_EVENT_RANGE_STEP_CM ||
+                 fabs(track.velocity - report->sentVelocity) >= TRACK_EVENT_VELOCITY_STEP_MPS ||
+                 fabs(track.azimuth - report->sentAzimuth) >= TRACK_EVENT_AZIMUTH_STEP_DEG ||
+                 abs(track.confidenceLevel - report->sentConfidence) >= TRACK_EVENT_CONFIDENCE_STEP)
+        {
+            markPending(*report, TRACK_EVENT_UPDATE);
+        }
+        else if (!report->pending && now - report->lastSent >= TRACK_EVENT_REFRESH_MS)
+        {
+            markPending(*report, TRACK_EVENT_UPDATE);
+        }
+
+        // Comparison baseline for the next scan is what was last sent, so
+        // slow drift still adds up to a report
+        if (isNew)
+        {
+            report->sentRange = track.distance;
+            report->sentVelocity = track.velocity;
+            report->sentAzimuth = track.azimuth;
+            report->sentConfidence = track.confidenceLevel;
+        }
+    }
+
+    for (int i = 0; i < TRACK_EVENT_MAX_REPORTS; i++)
+    {
+        TrackReport &report = reports[i];
+        if (!report.active || report.present || (report.pending && report.kind == TRACK_EVENT_LOST))
+            continue;
+
+        if (report.pending && report.kind == TRACK_EVENT_NEW)
+        {
+            // Came and went between emits: the ground station never needs to know
+            report.active = false;
+            report.pending = false;
+            eventsCoalesced++;
+            continue;
+        }
+        markPending(report, TRACK_EVENT_LOST);
+    }
+}
+
+void TrackEventStream::refillTokens(unsigned long now)
+{
+    if (!started)
+    {
+        started = true;
+        lastRefill = now;
+        return;
+    }
+
+    tokens += (now - lastRefill) * (TRACK_EVENT_MAX_RATE_HZ / 1000.0);
+    if (tokens > TRACK_EVENT_BURST)
+    {
+        tokens = TRACK_EVENT_BURST;
+    }
+    lastRefill = now;
+}
+
+// Appearances and losses first, then the nearest moving birds
+int TrackEventStream::pickNextReport(unsigned long now)
+{
+    int best = -1;
+    for (int i = 0; i < TRACK_EVENT_MAX_REPORTS; i++)
+    {
+        const TrackReport &report = reports[i];
+        if (!report.active || !report.pending)
+            continue;
+        if (report.kind == TRACK_EVENT_UPDATE && now - report.lastSent < TRACK_EVENT_MIN_INTERVAL_MS)
+            continue;
+
+        if (best < 0)
+        {
+            best = i;
+            continue;
+        }
+        bool urgent = report.kind != TRACK_EVENT_UPDATE;
+        bool bestUrgent = reports[best].kind != TRACK_EVENT_UPDATE;
+        if (urgent != bestUrgent ? urgent : report.rangeMm < reports[best].rangeMm)
+        {
+            best = i;
+        }
+    }
+    return best;
+}
+
+size_t TrackEventStream::emit(TelemetryEncoder &encoder, unsigned long now)
+{
+    refillTokens(now);
+
+    int32_t values[1 + TRACK_EVENTS_PER_FRAME * TRACK_EVENT_FIELDS];
+    int count = 0;
+    values[0] = (int32_t)now;
+
+    while (count < TRACK_EVENTS_PER_FRAME)
+    {
+        int index = pickNextReport(now);
+        if (index < 0)
+            break;
+        if (tokens < 1.0)
+        {
+            eventsDeferred++;
+            break;
+        }
+
+        TrackReport &report = reports[index];
+        int32_t *record = &values[1 + count * TRACK_EVENT_FIELDS];
+        record[0] = report.trackId;
+        record[1] = report.kind;
+        record[2] = report.rangeMm;
+        record[3] = report.azimuthDeciDeg;
+        record[4] = report.velocityCms;
+        record[5] = report.confidence;
+        count++;
+        tokens -= 1.0;
+
+        report.pending = false;
+        report.lastSent = now;
+        report.sentRange = report.rangeMm / 10.0;
+        report.sentVelocity = report.velocityCms / 100.0;
+        report.sentAzimuth = report.azimuthDeciDeg / 10.0;
+        report.sentConfidence = report.confidence;
+        if (report.kind == TRACK_EVENT_LOST)
+        {
+            report.active = false;
+        }
+    }
+
+    if (count == 0)
+        return 0;
+
+    size_t length = encoder.encodeValues(TELEMETRY_FRAME_TRACKS, values, 1 + count * TRACK_EVENT_FIELDS);
+    eventsSent += count;
+    framesSent++;
+    bytesSent += length;
+    return length;
+}
+
+int TrackEventStream::getActiveTrackCount()
+{
+    int active = 0;
+    for (int i = 0; i < TRACK_EVENT_MAX_REPORTS; i++)
+    {
+        if (reports[i].active && reports[i].present)
+        {
+            active++;
+        }
+    }
+    return active;
+}
+
+unsigned long TrackEventStream::getEventsSent()
+{
+    return eventsSent;
+}
+
+unsigned long TrackEventStream::getEventsCoalesced()
+{
+    return eventsCoalesced;
+}
+
+unsigned long TrackEventStream::getEventsDeferred()
+{
+    return eventsDeferred;
+}
+
+unsigned long TrackEventStream::getFramesSent()
+{
+    return framesSent;
+}
+
+unsigned long TrackEventStream::getBytesSent()
+{
+    return bytesSent;
+}
@@ -0,0 +1,87 @@
+#ifndef TRACK_EVENTS_H
+#define TRACK_EVENTS_H
+
+#include <Arduino.h>
+#include "bird_tracker.h"
+#include "telemetry_protocol.h"
+
+#ifndef MAX_BIRDS
+#define MAX_BIRDS 10
+#endif
+#define TRACK_EVENT_RANGE_STEP_CM 10.0    // Material change thresholds since the last report
+#define TRACK_EVENT_VELOCITY_STEP_MPS 0.5
+#define TRACK_EVENT_AZIMUTH_STEP_DEG 5.0
+#define TRACK_EVENT_CONFIDENCE_STEP 20
+#define TRACK_EVENT_MIN_INTERVAL_MS 100   // Per track: faster changes are coalesced
+#define TRACK_EVENT_REFRESH_MS 2000       // Unchanged tracks are re-sent this often
+#define TRACK_EVENT_MAX_RATE_HZ 40        // Whole stream, token bucket refill
+#define TRACK_EVENT_BURST 10
+#define TRACK_EVENTS_PER_FRAME 6
+#define TRACK_EVENT_FIELDS 6              // id, kind, range, azimuth, velocity, confidence
+#define TRACK_EVENT_MAX_REPORTS (MAX_BIRDS * 2) // Live tracks plus lost ones not yet reported
+
+enum TrackEventKind
+{
+    TRACK_EVENT_UPDATE = 0,
+    TRACK_EVENT_NEW = 1,
+    TRACK_EVENT_LOST = 2
+};
+
+// What the ground station last heard about one track
+struct TrackReport
+{
+    uint16_t trackId;
+    bool active;   // Slot in use
+    bool present;  // Still confirmed in the latest scan
+    bool pending;  // Has news the ground station has not seen yet
+    uint8_t kind;
+    int32_t rangeMm;
+    int32_t azimuthDeciDeg;
+    int32_t velocityCms;
+    int32_t confidence;
+    float sentRange;
+    float sentVelocity;
+    float sentAzimuth;
+    int sentConfidence;
+    unsigned long lastSent;
+};
+
+// Turns the tracker's confirmed tracks into a change-driven event stream:
+// a track is reported when it appears, when it moves materially, when it is
+// lost, and otherwise only as an occasional refresh. Changes arriving faster
+// than the per-track interval overwrite the pending report instead of
+// queueing, and a token bucket caps the stream as a whole, so bandwidth
+// follows activity but is bounded.
+class TrackEventStream
+{
+private:
+    TrackReport reports[TRACK_EVENT_MAX_REPORTS];
+    float tokens;
+    unsigned long lastRefill;
+    bool started;
+    unsigned long eventsSent;
+    unsigned long eventsCoalesced;
+    unsigned long eventsDeferred;
+    unsigned long framesSent;
+    unsigned long bytesSent;
+
+    TrackReport *findReport(uint16_t trackId);
+    TrackReport *allocateReport(uint16_t trackId);
+    void markPending(TrackReport &report, uint8_t kind);
+    void refillTokens(unsigned long now);
+    int pickNextReport(unsigned long now);
+
+public:
+    TrackEventStream();
+    void reset();
+    void update(const BirdObject *tracks, int count, unsigned long now);
+    size_t emit(TelemetryEncoder &encoder, unsigned long now);
+    int getActiveTrackCount();
+    unsigned long getEventsSent();
+    unsigned long getEventsCoalesced();
+    unsigned long getEventsDeferred();
+    unsigned long getFramesSent();
+    unsigned long getBytesSent();
+};
+
+#endif
@@ -0,0 +1,172 @@
+#include "ultrasonic_ranging.h"
+
+UltrasonicRanging *UltrasonicRanging::activeInstance = nullptr;
+
+UltrasonicRanging::UltrasonicRanging()
+{
+    channelCount = 0;
+    echoTimeoutUs = RANGING_ECHO_TIMEOUT_US;
+    queueHead = 0;
+    queueTail = 0;
+    droppedMeasurements = 0;
+
+    for (int i = 0; i < RANGING_MAX_SENSORS; i++)
+    {
+        channels[i].trigPin = -1;
+        channels[i].echoPin = -1;
+        channels[i].state = RANGING_IDLE;
+        channels[i].triggerTime = 0;
+        channels[i].echoStart = 0;
+    }
+}
+
+bool UltrasonicRanging::begin(const int *trigPins, const int *echoPins, int count)
+{
+    static void (*const echoInterrupts[RANGING_MAX_SENSORS])() = {
+        &UltrasonicRanging::echoInterrupt<0>,
+        &UltrasonicRanging::echoInterrupt<1>,
+        &UltrasonicRanging::echoInterrupt<2>,
+        &UltrasonicRanging::echoInterrupt<3>,
+        &UltrasonicRanging::echoInterrupt<4>,
+        &UltrasonicRanging::echoInterrupt<5>,
+        &UltrasonicRanging::echoInterrupt<6>,
+        &UltrasonicRanging::echoInterrupt<7>,
+        &UltrasonicRanging::echoInterrupt<8>,
+        &UltrasonicRanging::echoInterrupt<9>,
+        &UltrasonicRanging::echoInterrupt<10>,
+        &UltrasonicRanging::echoInterrupt<11>};
+
+    if (count <= 0 || count > RANGING_MAX_SENSORS)
+        return false;
+
+    activeInstance = this;
+    channelCount = count;
+
+    for (int i = 0; i < channelCount; i++)
+    {
+        channels[i].trigPin = trigPins[i];
+        channels[i].echoPin = echoPins[i];
+        channels[i].state = RANGING_IDLE;
+
+        pinMode(trigPins[i], OUTPUT);
+        pinMode(echoPins[i], INPUT);
+        digitalWrite(trigPins[i], LOW);
+
+        attachInterrupt(digitalPinToInterrupt(echoPins[i]), echoInterrupts[i], CHANGE);
+    }
+
+    return true;
+}
+
+void UltrasonicRanging::setEchoTimeout(unsigned long timeoutUs)
+{
+    echoTimeoutUs = timeoutUs;
+}
+
+bool UltrasonicRanging::trigger(int sensorIndex)
+{
+    if (sensorIndex < 0 || sensorIndex >= channelCount)
+        return false;
+
+    RangingChannel *channel = &channels[sensorIndex];
+    if (channel->state != RANGING_IDLE)
+        return false;
+
+    digitalWrite(channel->trigPin, LOW);
+    delayMicroseconds(2);
+    digitalWrite(channel->trigPin, HIGH);
+    delayMicroseconds(RANGING_TRIGGER_PULSE_US);
+    digitalWrite(channel->trigPin, LOW);
+
+    noInterrupts();
+    channel->triggerTime = micros();
+    channel->state = RANGING_ARMED;
+    interrupts();
+
+    return true;
+}
+
+bool UltrasonicRanging::isBusy(int sensorIndex)
+{
+    if (sensorIndex < 0 || sensorIndex >= channelCount)
+        return false;
+
+    return channels[sensorIndex].state != RANGING_IDLE;
+}
+
+bool UltrasonicRanging::isAnyBusy()
+{
+    for (int i = 0; i < channelCount; i++)
+    {
+        if (channels[i].state != RANGING_IDLE)
+            return true;
+    }
+    return false;
+}
+
+void UltrasonicRanging::handleEchoEdge(int sensorIndex)
+{
+    RangingChannel *channel = &channels[sensorIndex];
+    unsigned long now = micros();
+
+    if (digitalRead(channel->echoPin) == HIGH)
+    {
+        if (channel->state == RANGING_ARMED)
+        {
+            channel->echoStart = now;
+            channel->state = RANGING_ECHO;
+        }
+    }
+    else if (channel->state == RANGING_ECHO)
+    {
+        pushMeasurement(sensorIndex, now - channel->echoStart, now);
+        channel->state = RANGING_IDLE;
+    }
+}
+
+void UltrasonicRanging::serviceTimeouts()
+{
+    unsigned long now = micros();
+
+    for (int i = 0; i < channelCount; i++)
+    {
+        noInterrupts();
+        if (channels[i].state != RANGING_IDLE && now - channels[i].triggerTime > echoTimeoutUs)
+        {
+            // Nothing inside the listen window: report a zero-width echo like pulseIn()
+            channels[i].state = RANGING_IDLE;
+            pushMeasurement(i, 0, now);
+        }
+        interrupts();
+    }
+}
+
+void UltrasonicRanging::pushMeasurement(uint8_t sensorIndex, unsigned long widthUs, unsigned long timestamp)
+{
+    uint8_t next = (queueHead + 1) & (RANGING_QUEUE_SIZE - 1);
+    if (next == queueTail)
+    {
+        droppedMeasurements++;
+        return;
+    }
+
+    queue[queueHead].sensorIndex = sensorIndex;
+    queue[queueHead].echoWidthUs = widthUs;
+    queue[queueHead].timestampUs = timestamp;
+    queueHead = next;
+}
+
+bool UltrasonicRanging::popMeasurement(RangingMeasurement &measurement)
+{
+    if (queueTail == queueHead)
+        return false;
+
+    measurement = queue[queueTail];
+    queueTail = (queueTail + 1) & (RANGING_QUEUE_SIZE - 1);
+    return true;
+}
+
+unsigned long UltrasonicRanging::getDroppedCount()
+{
+    return droppedMeasurements;
+}
@@ -0,0 +1,75 @@
+#ifndef ULTRASONIC_RANGING_H
+#define ULTRASONIC_RANGING_H
+
+#include <Arduino.h>
+
+#define RANGING_MAX_SENSORS 12
+#define RANGING_QUEUE_SIZE 32 // Must be a power of two
+#define RANGING_ECHO_TIMEOUT_US 30000
+#define RANGING_TRIGGER_PULSE_US 10
+
+enum RangingState
+{
+    RANGING_IDLE = 0,
+    RANGING_ARMED = 1, // Trigger sent, waiting for echo rising edge
+    RANGING_ECHO = 2   // Echo high, waiting for falling edge
+};
+
+struct RangingMeasurement
+{
+    uint8_t sensorIndex;
+    unsigned long echoWidthUs; // 0 when the echo timed out
+    unsigned long timestampUs;
+};
+
+struct RangingChannel
+{
+    int trigPin;
+    int echoPin;
+    volatile uint8_t state;
+    volatile unsigned long triggerTime;
+    volatile unsigned long echoStart;
+};
+
+// Interrupt-driven ultrasonic ranging. trigger() fires a ping and returns
+// immediately; echo edges are timestamped from pin-change interrupts and the
+// completed pulse widths are queued for the main loop to drain.
+class UltrasonicRanging
+{
+private:
+    RangingChannel channels[RANGING_MAX_SENSORS];
+    int channelCount;
+    unsigned long echoTimeoutUs;
+
+    RangingMeasurement queue[RANGING_QUEUE_SIZE];
+    volatile uint8_t queueHead; // Written by producer (ISR / timeout)
+    volatile uint8_t queueTail; // Written by consumer (main loop)
+    volatile unsigned long droppedMeasurements;
+
+    static UltrasonicRanging *activeInstance;
+
+    void pushMeasurement(uint8_t sensorIndex, unsigned long widthUs, unsigned long timestamp);
+
+    template <int N>
+    static void echoInterrupt()
+    {
+        if (activeInstance != nullptr)
+        {
+            activeInstance->handleEchoEdge(N);
+        }
+    }
+
+public:
+    UltrasonicRanging();
+    bool begin(const int *trigPins, const int *echoPins, int count);
+    void setEchoTimeout(unsigned long timeoutUs);
+    bool trigger(int sensorIndex);
+    bool isBusy(int sensorIndex);
+    bool isAnyBusy();
+    void serviceTimeouts();
+    bool popMeasurement(RangingMeasurement &measurement);
+    unsigned long getDroppedCount();
+    void handleEchoEdge(int sensorIndex);
+};
+
+#endif
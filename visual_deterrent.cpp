@@ -1,5 +1,45 @@
 
 #include "visual_deterrent.h"
+#include "strobe_timer.h"
+
+// Strobe bank, indexed by StrobePattern. Being constexpr it is placed in
+// flash and needs no initialisation at startup.
+static constexpr StrobeConfig strobePatternBank[] = {
+    {0, 1000, 0, 1, "Off"},
+    {500, 1500, 128, 999, "Slow Blink"}, // Alert mode
+    {200, 200, 255, 999, "Fast Blink"},  // Active deterrent
+    {100, 100, 255, 2, "Double Flash"},
+    {0, 0, 255, 999, "Random"},
+    {50, 50, 255, 999, "Emergency"},
+    {60, 0, 255, 999, "Sweep"}}; // One segment lit at a time, onDuration each
+
+static constexpr bool strobeValid(const StrobeConfig &config)
+{
+    return config.onDuration >= 0 && config.offDuration >= 0 && config.brightness >= 0 &&
+           config.brightness <= PWM_RESOLUTION && config.repetitions > 0;
+}
+
+static constexpr bool strobeBankValid(int index)
+{
+    return index >= MAX_STROBE_PATTERNS || (strobeValid(strobePatternBank[index]) && strobeBankValid(index + 1));
+}
+
+static_assert(sizeof(strobePatternBank) / sizeof(strobePatternBank[0]) == MAX_STROBE_PATTERNS,
+              "Strobe bank must have one entry per StrobePattern");
+static_assert(PATTERN_SWEEP < MAX_STROBE_PATTERNS, "Strobe bank does not cover every StrobePattern");
+static_assert(strobeBankValid(0), "Strobe bank has an out-of-range entry");
+static_assert(strobePatternBank[PATTERN_DOUBLE_FLASH].repetitions * 2 + 1 <= STROBE_MAX_EDGES &&
+                  MAX_LED_CHANNELS + (strobePatternBank[PATTERN_SWEEP].offDuration > 0) <= STROBE_MAX_EDGES &&
+                  STROBE_RANDOM_STEPS <= STROBE_MAX_EDGES,
+              "Strobe patterns must compile to at most STROBE_MAX_EDGES edges");
+static_assert(strobePatternBank[PATTERN_SLOW_BLINK].onDuration + strobePatternBank[PATTERN_SLOW_BLINK].offDuration > 0 &&
+                  strobePatternBank[PATTERN_FAST_BLINK].onDuration + strobePatternBank[PATTERN_FAST_BLINK].offDuration > 0 &&
+                  strobePatternBank[PATTERN_DOUBLE_FLASH].onDuration + strobePatternBank[PATTERN_DOUBLE_FLASH].offDuration > 0 &&
+                  strobePatternBank[PATTERN_EMERGENCY].onDuration + strobePatternBank[PATTERN_EMERGENCY].offDuration > 0 &&
+                  strobePatternBank[PATTERN_SWEEP].onDuration > 0,
+              "Periodic strobe patterns need a non-zero cycle");
+
+VisualDeterrent *VisualDeterrent::activeInstance = nullptr;
 
 VisualDeterrent::VisualDeterrent()
 {
@@ -8,36 +48,53 @@ VisualDeterrent::VisualDeterrent()
     patternStartTime = 0;
     patternCycle = 0;
     systemEnabled = true;
-    ambientLight = 0.0;
+    ambientLight = 1.0;
+    lastAmbientUpdate = 0;
     thermalProtection = false;
-    lastThermalCheck = 0;
-
-    for (int i = 0; i < 2; i++)
+    thermalMask = 0xFFFF;
+    targetMask = 0xFFFF;
+    ambientTemperature = 25.0;
+    lastThermalUpdate = 0;
+    brightnessOverride = -1;
+    strobeClockRunning = false;
+    channelCount = 0;
+
+    for (int i = 0; i < MAX_LED_CHANNELS; i++)
     {
-        ledChannels[i].pin = -1;
         ledChannels[i].currentBrightness = 0;
         ledChannels[i].targetBrightness = 0;
         ledChannels[i].lastUpdate = 0;
         ledChannels[i].isActive = false;
-        ledChannels[i].onTime = 0;
-        ledChannels[i].temperature = 25.0;
+        ledChannels[i].thermal.reset(ambientTemperature);
+        ledChannels[i].commandedDuty = 0.0;
+        ledChannels[i].derate = 1.0;
+        ledChannels[i].thermalLimited = false;
     }
 }
 
-bool VisualDeterrent::begin(int led1Pin, int led2Pin)
+bool VisualDeterrent::begin(LedDriver &driver)
 {
     Serial.println("Initializing Visual Deterrent System...");
 
-    ledChannels[0].pin = led1Pin;
-    ledChannels[1].pin = led2Pin;
+    if (!driver.begin())
+    {
+        Serial.println("ERROR: LED driver has no channels");
+        return false;
+    }
+    sequencer.begin(&driver);
+    channelCount = sequencer.getChannelCount();
+    activeInstance = this;
 
-    pinMode(led1Pin, OUTPUT);
-    pinMode(led2Pin, OUTPUT);
+    // Segments start out at whatever ambient has been set so far
+    for (int i = 0; i < channelCount; i++)
+    {
+        ledChannels[i].thermal.reset(ambientTemperature);
+    }
 
-    analogWrite(led1Pin, 0);
-    analogWrite(led2Pin, 0);
+    Serial.print("LED channels: ");
+    Serial.println(channelCount);
 
-    initializePatterns();
+    updateAmbientLight(millis());
 
     performLEDTest();
 
@@ -45,57 +102,71 @@ bool VisualDeterrent::begin(int led1Pin, int led2Pin)
     return true;
 }
 
-void VisualDeterrent::initializePatterns()
+void VisualDeterrent::update()
 {
-    // Pattern 0: Off
-    patterns[0] = {0, 1000, 0, 1, "Off"};
-
-    // Pattern 1: Slow Blink (Alert mode)
-    patterns[1] = {500, 1500, 128, 999, "Slow Blink"};
-
-    // Pattern 2: Fast Blink (Active deterrent)
-    patterns[2] = {200, 200, 255, 999, "Fast Blink"};
-
-    patterns[3] = {100, 100, 255, 2, "Double Flash"};
-
-    patterns[4] = {0, 0, 255, 999, "Random"};
+    unsigned long currentTime = millis();
 
-    Serial.println("Strobe patterns initialized");
-}
+    // Runs while disabled as well, so the model keeps cooling
+    if (currentTime - lastThermalUpdate >= LED_THERMAL_UPDATE_MS)
+    {
+        updateThermalModel(currentTime);
+    }
 
-void VisualDeterrent::update()
-{
     if (!systemEnabled)
         return;
 
-    unsigned long currentTime = millis();
-
-    if (currentTime - lastThermalCheck > 1000)
+    if (currentTime - lastAmbientUpdate >= LED_AMBIENT_UPDATE_MS)
     {
-        checkThermalProtection();
-        lastThermalCheck = currentTime;
+        updateAmbientLight(currentTime);
     }
 
-    for (int i = 0; i < 2; i++)
+    for (int i = 0; i < channelCount; i++)
     {
         updateLEDBrightness(i);
     }
+    commitLEDBrightness();
 
     if (currentMode != MODE_DISABLED && !thermalProtection)
     {
-        executeStrobePattern();
+        if (!strobeClockRunning)
+        {
+            sequencer.poll(currentTime);
+        }
+
+        // The next random cycle is rolled while the current one plays and
+        // takes over exactly at its end
+        if (currentPattern == PATTERN_RANDOM && !sequencer.isSwapPending())
+        {
+            compileStrobePattern(PATTERN_RANDOM, *sequencer.editProgram());
+            sequencer.commitProgram(false);
+        }
+    }
+}
+
+void VisualDeterrent::strobeInterrupt()
+{
+    VisualDeterrent *visual = activeInstance;
+    if (visual != nullptr)
+    {
+        visual->sequencer.tick();
     }
 }
 
 void VisualDeterrent::updateLEDBrightness(int channel)
 {
-    if (channel < 0 || channel >= 2)
+    if (channel < 0 || channel >= channelCount)
         return;
 
     LEDChannel *led = &ledChannels[channel];
     unsigned long currentTime = millis();
 
-    if (led->currentBrightness != led->targetBrightness)
+    if (sequencer.isPlaying())
+    {
+        // The sequencer owns the outputs while a pattern plays
+        led->currentBrightness = sequencer.getLevel(channel);
+        led->targetBrightness = led->currentBrightness;
+    }
+    else if (led->currentBrightness != led->targetBrightness)
     {
         if (currentTime - led->lastUpdate > 10)
         {
@@ -110,168 +181,243 @@ void VisualDeterrent::updateLEDBrightness(int channel)
                 led->currentBrightness += step;
             }
 
-            int adaptiveBrightness = calculateAdaptiveBrightness(led->currentBrightness);
-            analogWrite(led->pin, adaptiveBrightness);
-
             led->lastUpdate = currentTime;
         }
     }
 
-    if (led->currentBrightness > 50)
-    {
-        if (!led->isActive)
-        {
-            led->isActive = true;
-            led->onTime = currentTime;
-        }
+    led->isActive = led->currentBrightness > 50;
+}
 
-        unsigned long onDuration = currentTime - led->onTime;
-        float heatFactor = (led->currentBrightness / 255.0) * (onDuration / 1000.0);
-        led->temperature = 25.0 + (heatFactor * 0.5);
-    }
-    else
-    {
-        led->isActive = false;
+// Ramped levels go out as one frame, after every channel has stepped
+void VisualDeterrent::commitLEDBrightness()
+{
+    if (sequencer.isPlaying())
+        return;
 
-        led->temperature = max(25.0, led->temperature - 0.1);
+    uint8_t frame[MAX_LED_CHANNELS] = {};
+    for (int i = 0; i < channelCount; i++)
+    {
+        frame[i] = calculateAdaptiveBrightness(ledChannels[i].currentBrightness);
     }
+    sequencer.showFrame(frame);
 }
 
-void VisualDeterrent::executeStrobePattern()
+void VisualDeterrent::compileStrobePattern(StrobePattern pattern, StrobeProgram &program)
 {
-    unsigned long currentTime = millis();
-    unsigned long elapsed = currentTime - patternStartTime;
+    const StrobeConfig &config = strobePatternBank[pattern];
+    uint8_t level = calculateAdaptiveBrightness(brightnessOverride >= 0 ? brightnessOverride : config.brightness);
 
-    StrobeConfig *pattern = &patterns[currentPattern];
+    // Every step is a whole frame; channels past channelCount stay zero
+    uint8_t dark[MAX_LED_CHANNELS] = {};
+    uint8_t lit[MAX_LED_CHANNELS] = {};
+    memset(lit, level, channelCount);
 
-    switch (currentPattern)
+    program.edgeCount = 0;
+    program.cycleMs = 0;
+
+    switch (pattern)
     {
     case PATTERN_OFF:
-        setLEDBrightness(0, 0);
-        setLEDBrightness(1, 0);
+        StrobeSequencer::appendStep(program, config.offDuration, dark);
         break;
 
     case PATTERN_SLOW_BLINK:
     case PATTERN_FAST_BLINK:
-    {
-        int cycleDuration = pattern->onDuration + pattern->offDuration;
-        int cyclePosition = elapsed % cycleDuration;
-
-        if (cyclePosition < pattern->onDuration)
-        {
+        StrobeSequencer::appendStep(program, config.onDuration, lit);
+        StrobeSequencer::appendStep(program, config.offDuration, dark);
+        break;
 
-            setLEDBrightness(0, pattern->brightness);
-            setLEDBrightness(1, pattern->brightness);
-        }
-        else
+    case PATTERN_DOUBLE_FLASH:
+        for (int i = 0; i < config.repetitions; i++)
         {
-
-            setLEDBrightness(0, 0);
-            setLEDBrightness(1, 0);
+            StrobeSequencer::appendStep(program, config.onDuration, lit);
+            StrobeSequencer::appendStep(program, config.offDuration, dark);
         }
-    }
-    break;
-
-    case PATTERN_DOUBLE_FLASH:
-    {
-        int totalCycleDuration = (pattern->onDuration + pattern->offDuration) * pattern->repetitions + 1000;
-        int cyclePosition = elapsed % totalCycleDuration;
+        StrobeSequencer::appendStep(program, STROBE_DOUBLE_FLASH_GAP_MS, dark);
+        break;
 
-        if (cyclePosition < (pattern->onDuration + pattern->offDuration) * pattern->repetitions)
+    case PATTERN_RANDOM:
+        for (int i = 0; i < STROBE_RANDOM_STEPS; i++)
         {
-            int flashCycle = cyclePosition % (pattern->onDuration + pattern->offDuration);
-            if (flashCycle < pattern->onDuration)
-            {
-                setLEDBrightness(0, pattern->brightness);
-                setLEDBrightness(1, pattern->brightness);
-            }
-            else
+            uint8_t step[MAX_LED_CHANNELS] = {};
+            for (int channel = 0; channel < channelCount; channel++)
             {
-                setLEDBrightness(0, 0);
-                setLEDBrightness(1, 0);
+                step[channel] = random(0, 2) * level;
             }
+            StrobeSequencer::appendStep(program, STROBE_RANDOM_STEP_MS, step);
         }
-        else
-        {
+        break;
 
-            setLEDBrightness(0, 0);
-            setLEDBrightness(1, 0);
+    case PATTERN_EMERGENCY:
+    {
+        // Even and odd segments alternate, so half the rig is always lit
+        uint8_t even[MAX_LED_CHANNELS] = {};
+        uint8_t odd[MAX_LED_CHANNELS] = {};
+        for (int channel = 0; channel < channelCount; channel++)
+        {
+            (channel % 2 == 0 ? even : odd)[channel] = level;
         }
+        StrobeSequencer::appendStep(program, config.onDuration, even);
+        StrobeSequencer::appendStep(program, config.offDuration, odd);
     }
     break;
 
-    case PATTERN_RANDOM:
-    {
-
-        if (elapsed % 300 == 0)
+    case PATTERN_SWEEP:
+        for (int channel = 0; channel < channelCount; channel++)
         {
-            int randomBrightness = random(0, 2) * pattern->brightness;
-            int randomChannel = random(0, 2);
-
-            setLEDBrightness(randomChannel, randomBrightness);
-            setLEDBrightness(1 - randomChannel, random(0, 2) * pattern->brightness);
+            uint8_t step[MAX_LED_CHANNELS] = {};
+            step[channel] = level;
+            StrobeSequencer::appendStep(program, config.onDuration, step);
         }
+        StrobeSequencer::appendStep(program, config.offDuration, dark);
+        break;
     }
-    break;
+}
 
-    case PATTERN_EMERGENCY:
+void VisualDeterrent::loadStrobePattern()
+{
+    compileStrobePattern(currentPattern, *sequencer.editProgram());
+    sequencer.commitProgram(true);
+
+    if (!strobeClockRunning)
     {
-        +int fastCycle = elapsed % 100;
-        if (fastCycle < 50)
-        {
-            setLEDBrightness(0, 255);
-            setLEDBrightness(1, 0);
-        }
-        else
-        {
-            setLEDBrightness(0, 0);
-            setLEDBrightness(1, 255);
-        }
+        strobeClockRunning = StrobeTimer::start(STROBE_TICK_HZ, &VisualDeterrent::strobeInterrupt);
     }
-    break;
+}
+
+void VisualDeterrent::stopStrobe()
+{
+    if (strobeClockRunning)
+    {
+        StrobeTimer::stop();
+        strobeClockRunning = false;
+    }
+    sequencer.silence();
+
+    for (int i = 0; i < channelCount; i++)
+    {
+        ledChannels[i].currentBrightness = 0;
+        ledChannels[i].targetBrightness = 0;
     }
 }
 
-void VisualDeterrent::checkThermalProtection()
+// Advances each channel's model by the duty it actually ran at, then sets
+// its output scale from the duty the pattern asks for
+void VisualDeterrent::updateThermalModel(unsigned long now)
 {
-    float maxTemp = 0;
+    unsigned long elapsedMs = now - lastThermalUpdate;
+    lastThermalUpdate = now;
+    if (elapsedMs == 0)
+        return;
 
-    for (int i = 0; i < 2; i++)
+    uint32_t commanded[MAX_LED_CHANNELS];
+    uint32_t output[MAX_LED_CHANNELS];
+    sequencer.drainLevelMs(commanded, output);
+
+    float dt = elapsedMs / 1000.0;
+    float smoothing = dt / (dt + LED_DUTY_SMOOTHING_S);
+    uint8_t scales[MAX_LED_CHANNELS];
+    for (int i = 0; i < channelCount; i++)
     {
-        if (ledChannels[i].temperature > maxTemp)
-        {
-            maxTemp = ledChannels[i].temperature;
-        }
+        LEDChannel &led = ledChannels[i];
+        led.thermal.update(output[i] / (255.0 * elapsedMs), ambientTemperature, dt);
+        led.commandedDuty += (commanded[i] / (255.0 * elapsedMs) - led.commandedDuty) * smoothing;
+        led.derate = led.thermal.derateScale(led.commandedDuty);
+        scales[i] = (uint8_t)(led.derate * 255.0 + 0.5);
     }
+    sequencer.setChannelScales(scales);
+
+    checkThermalProtection();
+}
 
-    if (maxTemp > THERMAL_SHUTDOWN_TEMP)
+// Last line of defence if the model and the hardware disagree: a channel
+// past LED_THERMAL_TRIP_C is masked off until it is back under the derating
+// target, and the strobe stops only when every channel is out
+void VisualDeterrent::checkThermalProtection()
+{
+    uint16_t mask = 0;
+    int limited = 0;
+
+    for (int i = 0; i < channelCount; i++)
     {
-        if (!thermalProtection)
+        LEDChannel &led = ledChannels[i];
+        float temperature = led.thermal.getTemperature();
+        if (!led.thermalLimited && temperature > LED_THERMAL_TRIP_C)
         {
-            Serial.println("WARNING: Thermal protection activated - LED temperature: " + String(maxTemp) + "°C");
-            thermalProtection = true;
+            Serial.print("WARNING: Thermal protection activated - LED ");
+            Serial.print(i + 1);
+            Serial.print(" temperature: ");
+            Serial.print(temperature);
+            Serial.println("°C");
+            led.thermalLimited = true;
+        }
+        else if (led.thermalLimited && temperature < LED_THERMAL_LIMIT_C - LED_DERATE_MARGIN_C)
+        {
+            Serial.print("INFO: Thermal protection deactivated - LED ");
+            Serial.print(i + 1);
+            Serial.print(" temperature: ");
+            Serial.print(temperature);
+            Serial.println("°C");
+            led.thermalLimited = false;
+        }
 
-            setLEDBrightness(0, 0);
-            setLEDBrightness(1, 0);
+        if (led.thermalLimited)
+        {
+            limited++;
+        }
+        else
+        {
+            mask |= 1 << i;
         }
     }
-    else if (maxTemp < THERMAL_SHUTDOWN_TEMP - 10)
+
+    thermalMask = mask;
+    applyChannelMask();
+
+    bool allLimited = channelCount > 0 && limited == channelCount;
+    if (allLimited && !thermalProtection)
+    {
+        thermalProtection = true;
+        stopStrobe();
+    }
+    else if (!allLimited && thermalProtection)
     {
-        if (thermalProtection)
+        thermalProtection = false;
+        if (currentMode != MODE_DISABLED)
         {
-            Serial.println("INFO: Thermal protection deactivated - LED temperature: " + String(maxTemp) + "°C");
-            thermalProtection = false;
+            loadStrobePattern();
         }
     }
 }
 
-int VisualDeterrent::calculateAdaptiveBrightness(int baseBrightness)
+// A channel lights only if it faces a threat and is within its thermal limit
+void VisualDeterrent::applyChannelMask()
 {
+    uint16_t mask = thermalMask & targetMask;
+    if (mask != sequencer.getChannelMask())
+    {
+        sequencer.setChannelMask(mask);
+    }
+}
 
-    float adaptiveFactor = 0.5 + ambientLight * 0.5;
+// Levels are baked into the running program, so a change of ambient bucket
+// recompiles it; the new levels take over when the current cycle ends
+void VisualDeterrent::updateAmbientLight(unsigned long now)
+{
+    lastAmbientUpdate = now;
+    int reading = analogRead(LIGHT_SENSOR_PIN);
+    ambientLight = reading / 1023.0;
 
-    int adaptedBrightness = (int)(baseBrightness * adaptiveFactor);
-    return constrain(adaptedBrightness, 0, 255);
+    if (brightnessTable.setAmbient(reading) && sequencer.isPlaying())
+    {
+        compileStrobePattern(currentPattern, *sequencer.editProgram());
+        sequencer.commitProgram(false);
+    }
+}
+
+int VisualDeterrent::calculateAdaptiveBrightness(int baseBrightness)
+{
+    return brightnessTable.lookup(constrain(baseBrightness, 0, PWM_RESOLUTION));
 }
 
 void VisualDeterrent::activateAlertMode()
@@ -282,8 +428,10 @@ void VisualDeterrent::activateAlertMode()
     Serial.println("Visual Deterrent: Activating ALERT mode");
     currentMode = MODE_ALERT;
     currentPattern = PATTERN_SLOW_BLINK;
+    brightnessOverride = -1;
     patternStartTime = millis();
     patternCycle = 0;
+    loadStrobePattern();
 }
 
 void VisualDeterrent::activateStrobeMode()
@@ -294,8 +442,10 @@ void VisualDeterrent::activateStrobeMode()
     Serial.println("Visual Deterrent: Activating STROBE mode");
     currentMode = MODE_STROBE;
     currentPattern = PATTERN_FAST_BLINK;
+    brightnessOverride = -1;
     patternStartTime = millis();
     patternCycle = 0;
+    loadStrobePattern();
 }
 
 void VisualDeterrent::activateEmergencyMode()
@@ -303,10 +453,20 @@ void VisualDeterrent::activateEmergencyMode()
     Serial.println("Visual Deterrent: Activating EMERGENCY mode");
     currentMode = MODE_EMERGENCY;
     currentPattern = PATTERN_EMERGENCY;
+    brightnessOverride = -1;
     patternStartTime = millis();
     patternCycle = 0;
 
+    // Emergency overrides thermal limits and targeting on every channel
     thermalProtection = false;
+    for (int i = 0; i < channelCount; i++)
+    {
+        ledChannels[i].thermalLimited = false;
+    }
+    thermalMask = 0xFFFF;
+    targetMask = 0xFFFF;
+    applyChannelMask();
+    loadStrobePattern();
 }
 
 void VisualDeterrent::deactivate()
@@ -314,14 +474,14 @@ void VisualDeterrent::deactivate()
     Serial.println("Visual Deterrent: Deactivating");
     currentMode = MODE_DISABLED;
     currentPattern = PATTERN_OFF;
+    brightnessOverride = -1;
 
-    setLEDBrightness(0, 0);
-    setLEDBrightness(1, 0);
+    stopStrobe();
 }
 
 void VisualDeterrent::setLEDBrightness(int channel, int brightness)
 {
-    if (channel >= 0 && channel < 2)
+    if (channel >= 0 && channel < channelCount)
     {
         ledChannels[channel].targetBrightness = constrain(brightness, 0, 255);
     }
@@ -333,7 +493,14 @@ void VisualDeterrent::setStrobePattern(StrobePattern pattern)
     {
         currentPattern = pattern;
         patternStartTime = millis();
-        Serial.println("Strobe pattern changed to: " + patterns[pattern].name);
+        brightnessOverride = -1;
+        Serial.print("Strobe pattern changed to: ");
+        Serial.println(strobePatternBank[pattern].name);
+
+        if (currentMode != MODE_DISABLED && !thermalProtection)
+        {
+            loadStrobePattern();
+        }
     }
 }
 
@@ -341,12 +508,30 @@ void VisualDeterrent::setBrightness(int brightness)
 {
     int constrainedBrightness = constrain(brightness, 0, 255);
 
-    if (currentPattern >= 0 && currentPattern < MAX_STROBE_PATTERNS)
+    // Applies to the running pattern until the pattern changes
+    brightnessOverride = constrainedBrightness;
+
+    if (currentMode != MODE_DISABLED && !thermalProtection)
     {
-        patterns[currentPattern].brightness = constrainedBrightness;
+        loadStrobePattern();
     }
 }
 
+// Segments outside the mask stay dark in every pattern; 0xFFFF lights all
+void VisualDeterrent::setTargetMask(uint16_t mask)
+{
+    if (currentMode == MODE_EMERGENCY)
+        return;
+
+    targetMask = mask;
+    applyChannelMask();
+}
+
+uint16_t VisualDeterrent::getTargetMask()
+{
+    return targetMask;
+}
+
 void VisualDeterrent::setEnabled(bool enabled)
 {
     systemEnabled = enabled;
@@ -367,9 +552,11 @@ bool VisualDeterrent::selfTest()
 
     bool testPassed = true;
 
-    for (int channel = 0; channel < 2; channel++)
+    for (int channel = 0; channel < channelCount; channel++)
     {
-        Serial.print("Testing LED channel " + String(channel + 1) + "... ");
+        Serial.print("Testing LED channel ");
+        Serial.print(channel + 1);
+        Serial.print("... ");
 
         setLEDBrightness(channel, 64);
         delay(500);
@@ -427,13 +614,16 @@ void VisualDeterrent::performLEDTest()
 {
     Serial.println("Performing LED initialization test...");
 
-    for (int i = 0; i < 2; i++)
+    // Chase one segment at a time across the rig
+    for (int i = 0; i < channelCount; i++)
     {
-        analogWrite(ledChannels[i].pin, 128);
-        delay(200);
-        analogWrite(ledChannels[i].pin, 0);
-        delay(200);
+        uint8_t frame[MAX_LED_CHANNELS] = {};
+        frame[i] = 128;
+        sequencer.showFrame(frame);
+        delay(LED_TEST_STEP_MS);
     }
+    uint8_t dark[MAX_LED_CHANNELS] = {};
+    sequencer.showFrame(dark);
 
     Serial.println("LED test completed");
 }
@@ -443,7 +633,7 @@ VisualMode VisualDeterrent::getCurrentMode()
     return currentMode;
 }
 
-String VisualDeterrent::getModeString()
+const char *VisualDeterrent::getModeString()
 {
     switch (currentMode)
     {
@@ -460,15 +650,50 @@ String VisualDeterrent::getModeString()
     }
 }
 
+int VisualDeterrent::getChannelCount()
+{
+    return channelCount;
+}
+
 float VisualDeterrent::getLEDTemperature(int channel)
 {
-    if (channel >= 0 && channel < 2)
+    if (channel >= 0 && channel < channelCount)
     {
-        return ledChannels[channel].temperature;
+        return ledChannels[channel].thermal.getTemperature();
     }
     return 0.0;
 }
 
+// Seconds until the channel reaches the thermal limit at the duty its
+// pattern asks for, ignoring derating; -1 if it never will
+float VisualDeterrent::getTimeToLimit(int channel)
+{
+    if (channel < 0 || channel >= channelCount)
+        return -1.0;
+    LEDChannel &led = ledChannels[channel];
+    return led.thermal.timeToLimit(led.commandedDuty, LED_THERMAL_LIMIT_C);
+}
+
+float VisualDeterrent::getDerating(int channel)
+{
+    return channel >= 0 && channel < channelCount ? ledChannels[channel].derate : 1.0;
+}
+
+int VisualDeterrent::getAmbientBucket()
+{
+    return brightnessTable.getBucket();
+}
+
+void VisualDeterrent::setAmbientTemperature(float celsius)
+{
+    ambientTemperature = celsius;
+}
+
+bool VisualDeterrent::isChannelThermalLimited(int channel)
+{
+    return channel >= 0 && channel < channelCount && ledChannels[channel].thermalLimited;
+}
+
 bool VisualDeterrent::isThermalProtectionActive()
 {
     return thermalProtection;
@@ -481,24 +706,44 @@ void VisualDeterrent::forceShutdown()
     systemEnabled = false;
 }
 
-String VisualDeterrent::getStatusReport()
+void VisualDeterrent::printStatusReport(Print &out)
 {
-    String report = "=== VISUAL DETERRENT STATUS ===\n";
-    report += "Mode: " + getModeString() + "\n";
-    report += "Pattern: " + patterns[currentPattern].name + "\n";
-    report += "System Enabled: " + String(systemEnabled ? "YES" : "NO") + "\n";
-    report += "Thermal Protection: " + String(thermalProtection ? "ACTIVE" : "INACTIVE") + "\n";
-    report += "Ambient Light: " + String(ambientLight * 100) + "%\n";
-
-    report += "\nLED Channel Status:\n";
-    for (int i = 0; i < 2; i++)
+    out.println("=== VISUAL DETERRENT STATUS ===");
+    out.print("Mode: ");
+    out.println(getModeString());
+    out.print("Pattern: ");
+    out.println(strobePatternBank[currentPattern].name);
+    out.print("System Enabled: ");
+    out.println(systemEnabled ? "YES" : "NO");
+    out.print("Thermal Protection: ");
+    out.println(thermalProtection ? "ACTIVE" : "INACTIVE");
+    out.print("Ambient Light: ");
+    out.print(ambientLight * 100);
+    out.print("% (bucket ");
+    out.print(brightnessTable.getBucket());
+    out.println(")");
+
+    out.println("\nLED Channel Status:");
+    for (int i = 0; i < channelCount; i++)
     {
-        report += "Channel " + String(i + 1) + ": ";
-        report += String(ledChannels[i].currentBrightness) + "/" + String(ledChannels[i].targetBrightness) + " ";
-        report += "(" + String(ledChannels[i].temperature) + "°C) ";
-        report += String(ledChannels[i].isActive ? "ACTIVE" : "INACTIVE") + "\n";
+        out.print("Channel ");
+        out.print(i + 1);
+        out.print(": ");
+        out.print(ledChannels[i].currentBrightness);
+        out.print("/");
+        out.print(ledChannels[i].targetBrightness);
+        out.print(" (");
+        out.print(ledChannels[i].thermal.getTemperature());
+        out.print("°C, output ");
+        out.print((int)(ledChannels[i].derate * 100));
+        out.print("%) ");
+        if (ledChannels[i].thermalLimited)
+            out.println("THERMAL LIMIT");
+        else if (!(targetMask & (1 << i)))
+            out.println("NOT TARGETED");
+        else
+            out.println(ledChannels[i].isActive ? "ACTIVE" : "INACTIVE");
     }
 
-    report += "===============================\n";
-    return report;
+    out.println("===============================");
 }
\ No newline at end of file
@@ -3,12 +3,19 @@
 #define VISUAL_DETERRENT_H
 
 #include <Arduino.h>
+#include "strobe_sequencer.h"
+#include "led_thermal.h"
+#include "brightness_lut.h"
 
-#define MAX_STROBE_PATTERNS 5
+#define MAX_STROBE_PATTERNS 7
 #define PWM_RESOLUTION 255
-#define THERMAL_SHUTDOWN_TEMP 70.0
 #define MAX_CONTINUOUS_ON_TIME 5000
 #define LED_WARMUP_TIME 100
+#define LED_TEST_STEP_MS 200            // Per segment in the power-on chase
+#define STROBE_DOUBLE_FLASH_GAP_MS 1000 // Dark time after each double flash
+#define STROBE_RANDOM_STEP_MS 300
+#define STROBE_RANDOM_STEPS 8           // Steps rolled per cycle; re-rolled every cycle
+#define LED_DUTY_SMOOTHING_S 2.0        // Averages a pattern's duty over several cycles
 
 enum StrobePattern
 {
@@ -17,7 +24,8 @@ enum StrobePattern
     PATTERN_FAST_BLINK = 2,
     PATTERN_DOUBLE_FLASH = 3,
     PATTERN_RANDOM = 4,
-    PATTERN_EMERGENCY = 5
+    PATTERN_EMERGENCY = 5,
+    PATTERN_SWEEP = 6
 };
 
 enum VisualMode
@@ -30,13 +38,14 @@ enum VisualMode
 
 struct LEDChannel
 {
-    int pin;
     int currentBrightness;
     int targetBrightness;
     unsigned long lastUpdate;
     bool isActive;
-    unsigned long onTime;
-    float temperature;
+    LedThermalModel thermal;
+    float commandedDuty; // Smoothed, as the pattern asks for it
+    float derate;        // Output scale from the thermal model, 1 is full
+    bool thermalLimited; // Masked off until it cools
 };
 
 struct StrobeConfig
@@ -45,51 +54,75 @@ struct StrobeConfig
     int offDuration;
     int brightness;
     int repetitions;
-    String name;
+    const char *name;
 };
 
 class VisualDeterrent
 {
 private:
-    LEDChannel ledChannels[2];
+    LEDChannel ledChannels[MAX_LED_CHANNELS];
+    int channelCount;
     VisualMode currentMode;
     StrobePattern currentPattern;
-    StrobeConfig patterns[MAX_STROBE_PATTERNS];
+    int brightnessOverride; // -1 to use the pattern's own brightness
     unsigned long patternStartTime;
     int patternCycle;
     bool systemEnabled;
-    float ambientLight;
-    bool thermalProtection;
-    unsigned long lastThermalCheck;
+    float ambientLight; // Last light sensor reading, 0 to 1
+    unsigned long lastAmbientUpdate;
+    BrightnessTable brightnessTable;
+    bool thermalProtection; // Every channel is limited
+    uint16_t thermalMask;   // Channels not thermally limited
+    uint16_t targetMask;    // Channels facing a threat, from the targeting stage
+    float ambientTemperature;
+    unsigned long lastThermalUpdate;
+
+    StrobeSequencer sequencer;
+    bool strobeClockRunning;
+
+    static VisualDeterrent *activeInstance;
+    static void strobeInterrupt();
 
     void updateLEDBrightness(int channel);
+    void commitLEDBrightness();
     void setLEDBrightness(int channel, int brightness);
-    void executeStrobePattern();
+    void loadStrobePattern();
+    void stopStrobe();
+    void updateThermalModel(unsigned long now);
     void checkThermalProtection();
-    float readAmbientLight();
-    void initializePatterns();
+    void applyChannelMask();
+    void updateAmbientLight(unsigned long now);
     int calculateAdaptiveBrightness(int baseBrightness);
     void performLEDTest();
 
 public:
     VisualDeterrent();
-    bool begin(int led1Pin, int led2Pin);
+    bool begin(LedDriver &driver);
     void update();
     void activateAlertMode();
     void activateStrobeMode();
     void activateEmergencyMode();
     void deactivate();
     void setStrobePattern(StrobePattern pattern);
+    void compileStrobePattern(StrobePattern pattern, StrobeProgram &program);
     void setBrightness(int brightness);
+    void setTargetMask(uint16_t mask);
+    uint16_t getTargetMask();
     void setEnabled(bool enabled);
     bool isEnabled();
     bool selfTest();
     VisualMode getCurrentMode();
-    String getModeString();
+    const char *getModeString();
+    int getChannelCount();
     float getLEDTemperature(int channel);
+    float getTimeToLimit(int channel);
+    float getDerating(int channel);
+    int getAmbientBucket();
+    void setAmbientTemperature(float celsius);
+    bool isChannelThermalLimited(int channel);
     bool isThermalProtectionActive();
     void forceShutdown();
-    String getStatusReport();
+    void printStatusReport(Print &out);
 };
 
 #endif
\ No newline at end of file
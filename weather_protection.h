@@ -33,7 +33,7 @@ enum ProtectionMode
 
 struct WeatherSensor
 {
-  String name;
+  const char *name;
   int pin;
   float currentReading;
   float history[WEATHER_HISTORY_SIZE];
@@ -108,7 +108,7 @@ private:
   WeatherCondition classifyWeatherCondition();
   void adaptSystemToWeather();
   bool isWeatherSafe();
-  void logWeatherEvent(String event);
+  void logWeatherEvent(const char *event);
 
 public:
   WeatherProtection();
@@ -118,7 +118,7 @@ public:
   EnclosureStatus getEnclosureStatus();
   bool isWeatherCritical();
   WeatherCondition getCurrentCondition();
-  String getWeatherStatus();
+  const char *getWeatherStatus();
   ProtectionMode getProtectionMode();
   void setProtectionMode(ProtectionMode mode);
   bool selfTest();
@@ -127,7 +127,7 @@ public:
   bool isSensorActive(int sensorIndex);
   void enableWeatherProtection(bool enable);
   bool isWeatherProtectionEnabled();
-  String getWeatherReport();
+  void printWeatherReport(Print &out);
   void emergencyWeatherShutdown();
   bool isEnclosureCompromised();
   float getInternalTemperature();